@@ -27,15 +27,27 @@
 
 #include <vle/manager/Manager.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/Journal.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/i18n.hpp>
 #include <vle/version.hpp>
 #include <vle/vle.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <iostream>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <limits>
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
 #include <cstring>
 
 #define OMPI_SKIP_MPICXX
@@ -45,14 +57,22 @@ void mvle_show_help()
 {
     std::fprintf(stderr, _(
             "Use:\n"
-            "  mvle [-h,--help] [-v,--version] [-s|--show] [-P,--package"
-            " package_name] vpz_files...\n"
+            "  mvle [-h,--help] [-v,--version] [-s|--show] [-o,--processor"
+            " threads] [-c,--chunk size] [-r,--result directory]"
+            " [--resume] [-P,--package package_name] vpz_files...\n"
             "\n"
             "Help options:\n"
             "  -h, --help        Show help option\n"
             "\n"
             "Application options:\n"
             "  -s --show         Show the plan\n"
+            "  -o --processor    Number of simulation threads per process"
+            " (default: the cores of the node shared by its processes)\n"
+            "  -c --chunk        Number of combinations sent to a node per"
+            " request\n"
+            "  -r --result       Gather the results into the directory\n"
+            "  --resume          Skip the combinations completed by a"
+            " previous run\n"
             "  -P --package      Start VLE in package mode\n"
             "  -v --version      Show the version\n"));
 }
@@ -119,15 +139,24 @@ void mvle_mpi_error(int error)
     mvle_print_error("%s", buffer);
 }
 
+/*
+ * Only the main thread of a node calls MPI, the simulation threads
+ * exchange the combinations with the main thread.
+ */
 bool mvle_mpi_init(int *argc, char ***argv, uint32_t *rank, uint32_t *world)
 {
     int t_rank;
     int t_world;
+    int provided;
     int r;
     bool result = false;
 
-    if ((r = MPI_Init(argc, argv)) == MPI_SUCCESS) {
-        if ((r = MPI_Comm_rank(MPI_COMM_WORLD, &t_rank)) == MPI_SUCCESS) {
+    if ((r = MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &provided)) ==
+        MPI_SUCCESS) {
+        if (provided < MPI_THREAD_FUNNELED) {
+            mvle_print_error(_("MPI does not support threads"));
+        } else if ((r = MPI_Comm_rank(MPI_COMM_WORLD, &t_rank)) ==
+                   MPI_SUCCESS) {
             /* check the cast of the MPI's rank */
             if (t_rank < 0 or static_cast < unsigned int >(t_rank) >
                 std::numeric_limits < uint32_t >::max()) {
@@ -157,15 +186,81 @@ bool mvle_mpi_init(int *argc, char ***argv, uint32_t *rank, uint32_t *world)
     return result;
 }
 
+/*
+ * Get the number of processes of this node (MPI 3 shared memory
+ * domain). Collective, called by all the processes.
+ */
+uint32_t mvle_mpi_local_size()
+{
+    int size = 1;
+
+#if MPI_VERSION >= 3
+    MPI_Comm node;
+
+    if (MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                            MPI_INFO_NULL, &node) == MPI_SUCCESS) {
+        MPI_Comm_size(node, &size);
+        MPI_Comm_free(&node);
+    }
+#endif
+
+    return size > 0 ? static_cast < uint32_t >(size) : 1;
+}
+
+/*
+ * Share the cores of the node between its processes: with one process
+ * per node, the simulation threads of this process use all the cores
+ * and share the experimental frame and the plug-ins.
+ */
+uint32_t mvle_default_processor(uint32_t local)
+{
+    uint32_t cores = boost::thread::hardware_concurrency();
+
+    return std::max(cores / local, 1u);
+}
+
+bool mvle_parse_uint(const char *arg, uint32_t *value)
+{
+    char *end;
+    long result = std::strtol(arg, &end, 10);
+
+    if (*end != '\0' or result <= 0 or
+        result > std::numeric_limits < int32_t >::max()) {
+        mvle_print_error(_("bad positive integer: %s"), arg);
+        return false;
+    }
+
+    *value = static_cast < uint32_t >(result);
+    return true;
+}
+
 bool mvle_parse_arg(int argc, char **argv, int *vpz, bool *show,
-        vle::utils::Package& pack)
+        uint32_t *processor, uint32_t *chunk, std::string *result,
+        bool *resume, vle::utils::Package& pack)
 {
     int i = 1;
 
     while (i < argc) {
         if ((std::strcmp(argv[i], "-P") == 0 or
-             std::strcmp(argv[i], "--package") == 0) and i + 1 <= argc) {
+             std::strcmp(argv[i], "--package") == 0) and i + 1 < argc) {
             pack.select(argv[++i]);
+        } else if ((std::strcmp(argv[i], "-o") == 0 or
+                    std::strcmp(argv[i], "--processor") == 0) and
+                   i + 1 < argc) {
+            if (not mvle_parse_uint(argv[++i], processor)) {
+                return false;
+            }
+        } else if ((std::strcmp(argv[i], "-c") == 0 or
+                    std::strcmp(argv[i], "--chunk") == 0) and i + 1 < argc) {
+            if (not mvle_parse_uint(argv[++i], chunk)) {
+                return false;
+            }
+        } else if ((std::strcmp(argv[i], "-r") == 0 or
+                    std::strcmp(argv[i], "--result") == 0) and
+                   i + 1 < argc) {
+            result->assign(argv[++i]);
+        } else if (std::strcmp(argv[i], "--resume") == 0) {
+            *resume = true;
         } else if (std::strcmp(argv[i], "-h") == 0 or
                    std::strcmp(argv[i], "--help") == 0) {
             mvle_show_help();
@@ -183,6 +278,11 @@ bool mvle_parse_arg(int argc, char **argv, int *vpz, bool *show,
         ++i;
     }
 
+    if (*resume and result->empty()) {
+        mvle_print_error(_("--resume needs a result directory"));
+        return false;
+    }
+
     return *vpz < argc and not pack.name().empty();
 }
 
@@ -211,7 +311,7 @@ void mvle_show(const std::string& vpz)
         for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
             expgen.get(i, &conds);
 
-            mvle_print("%d;", i);
+            mvle_print("%u;", i);
             for (it = conds.begin(); it != conds.end(); ++it) {
                 const vle::vpz::Condition& cond = it->second;
                 vle::vpz::Condition::const_iterator jt;
@@ -226,10 +326,373 @@ void mvle_show(const std::string& vpz)
     }
 }
 
+enum mvle_tag
+{
+    MVLE_TAG_REQUEST = 1,       /**< A node needs combinations. */
+    MVLE_TAG_CHUNK = 2,         /**< A list of combinations, empty at
+                                 * the end. */
+    MVLE_TAG_RESULT = 3,        /**< The combination and the binary
+                                 * representation of its result. */
+    MVLE_TAG_DONE = 4           /**< The simulations of a node are
+                                 * ended. */
+};
+
+/*
+ * A result frame is the combination followed by the binary
+ * representation of its result (see vle::value::writeBinary).
+ */
+void mvle_build_frame(uint32_t index, const vle::value::Value *result,
+                      std::string *frame)
+{
+    frame->assign(reinterpret_cast < const char* >(&index), sizeof(index));
+    vle::value::writeBinary(result, frame);
+}
+
+/*
+ * The source of the node 0: the combinations are taken one by one by
+ * the simulation threads of the node 0 and by chunks for the other
+ * nodes. The results of all the nodes are recorded into the journal,
+ * if any, and the combinations completed by a previous run are
+ * skipped.
+ */
+class mvle_master_source : public vle::manager::Source
+{
+public:
+    mvle_master_source(uint32_t size, vle::manager::Journal *journal)
+        : m_next(0), m_size(size), m_journal(journal)
+    {}
+
+    virtual void result(uint32_t index, vle::value::Value *result)
+    {
+        std::string frame;
+
+        mvle_build_frame(index, result, &frame);
+        delete result;
+        store(frame);
+    }
+
+    void store(const std::string& frame)
+    {
+        uint32_t index;
+
+        if (not m_journal or frame.size() < sizeof(index)) {
+            return;
+        }
+
+        std::memcpy(&index, frame.data(), sizeof(index));
+
+        try {
+            m_journal->success(index, frame.substr(sizeof(index)));
+        } catch (const std::exception& e) {
+            mvle_print_error("journal: %s", e.what());
+        }
+    }
+
+    virtual bool next(uint32_t /*thread*/, uint32_t *index)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        skip();
+
+        if (m_next >= m_size) {
+            return false;
+        }
+
+        *index = m_next++;
+        return true;
+    }
+
+    void take(uint32_t chunk, std::vector < uint32_t > *indices)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        indices->clear();
+
+        for (skip(); m_next < m_size and indices->size() < chunk; skip()) {
+            indices->push_back(m_next++);
+        }
+    }
+
+private:
+    void skip()
+    {
+        while (m_journal and m_next < m_size and
+               m_journal->find(m_next, 0)) {
+            ++m_next;
+        }
+    }
+
+    boost::mutex           m_mutex;
+    uint32_t               m_next;
+    uint32_t               m_size;
+    vle::manager::Journal *m_journal;
+};
+
+/*
+ * The source of the others nodes: the main thread requests a new chunk
+ * to the node 0 as soon as the queue is shorter than the number of
+ * simulation threads, so the threads rarely wait for the network. The
+ * results are sent to the node 0 by the main thread.
+ */
+class mvle_worker_source : public vle::manager::Source
+{
+public:
+    enum event { EVENT_REQUEST, EVENT_RESULT, EVENT_DONE };
+
+    mvle_worker_source()
+        : m_finished(false), m_closed(false)
+    {}
+
+    virtual void result(uint32_t index, vle::value::Value *result)
+    {
+        std::string frame;
+
+        mvle_build_frame(index, result, &frame);
+        delete result;
+
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        m_results.push_back(std::string());
+        m_results.back().swap(frame);
+        m_needed.notify_one();
+    }
+
+    virtual bool next(uint32_t /*thread*/, uint32_t *index)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        while (m_queue.empty() and not m_finished) {
+            m_needed.notify_one();
+            m_available.wait(lock);
+        }
+
+        if (m_queue.empty()) {
+            return false;
+        }
+
+        *index = m_queue.front();
+        m_queue.pop_front();
+        m_needed.notify_one();
+
+        return true;
+    }
+
+    /*
+     * Wait for the next job of the main thread: send a result, request
+     * a new chunk or, when the simulation threads are ended, tell the
+     * node 0 that the node is done.
+     */
+    event wait(std::deque < uint32_t >::size_type threshold,
+               std::string *frame)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        for (;;) {
+            if (not m_results.empty()) {
+                frame->swap(m_results.front());
+                m_results.pop_front();
+                return EVENT_RESULT;
+            }
+
+            if (not m_finished and (m_closed or m_queue.size() < threshold)) {
+                return EVENT_REQUEST;
+            }
+
+            if (m_finished and m_closed) {
+                return EVENT_DONE;
+            }
+
+            m_needed.wait(lock);
+        }
+    }
+
+    void push(const std::vector < uint32_t >& indices)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        if (indices.empty()) {
+            m_finished = true;
+        } else if (not m_closed) {
+            m_queue.insert(m_queue.end(), indices.begin(), indices.end());
+        }
+
+        m_available.notify_all();
+    }
+
+    /*
+     * The simulation threads are ended: the main thread requests and
+     * drops the remaining chunks.
+     */
+    void close()
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        m_closed = true;
+        m_queue.clear();
+        m_needed.notify_all();
+    }
+
+private:
+    boost::mutex              m_mutex;
+    boost::condition_variable m_available;
+    boost::condition_variable m_needed;
+    std::deque < uint32_t >   m_queue;
+    std::deque < std::string > m_results;
+    bool                      m_finished;
+    bool                      m_closed;
+};
+
+/*
+ * The simulation threads of a node are run by the manager in a thread,
+ * the main thread communicates with the others nodes.
+ */
+struct mvle_run
+{
+    vle::manager::Manager     &man;
+    vle::vpz::Vpz             *vpz;
+    vle::utils::ModuleManager &modules;
+    uint32_t                   processor;
+    vle::manager::Source      *source;
+    mvle_worker_source        *worker;
+    vle::manager::Error       *error;
+
+    mvle_run(vle::manager::Manager& man, vle::vpz::Vpz *vpz,
+             vle::utils::ModuleManager& modules, uint32_t processor,
+             vle::manager::Source *source, mvle_worker_source *worker,
+             vle::manager::Error *error)
+        : man(man), vpz(vpz), modules(modules), processor(processor),
+          source(source), worker(worker), error(error)
+    {}
+
+    void operator()()
+    {
+        try {
+            man.run(vpz, modules, processor, source, error);
+        } catch (const std::exception& e) {
+            error->code = -1;
+            error->message = e.what();
+        }
+
+        if (worker) {
+            worker->close();
+        }
+    }
+};
+
+/*
+ * The main thread of the node 0 sends the chunks of combinations to
+ * the others nodes and stores their results until all the nodes are
+ * done.
+ */
+void mvle_dispatch(mvle_master_source& source, uint32_t world,
+                   uint32_t chunk)
+{
+    uint32_t active = world - 1;
+
+    while (active) {
+        MPI_Status status;
+
+        MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+
+        switch (status.MPI_TAG) {
+        case MVLE_TAG_REQUEST: {
+            uint32_t request;
+            std::vector < uint32_t > indices;
+
+            MPI_Recv(&request, 1, MPI_UNSIGNED, status.MPI_SOURCE,
+                     MVLE_TAG_REQUEST, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+            source.take(chunk, &indices);
+
+            MPI_Send(indices.empty() ? &request : &indices[0],
+                     indices.size(), MPI_UNSIGNED, status.MPI_SOURCE,
+                     MVLE_TAG_CHUNK, MPI_COMM_WORLD);
+            break;
+        }
+        case MVLE_TAG_RESULT: {
+            int size;
+
+            MPI_Get_count(&status, MPI_BYTE, &size);
+            std::string frame(size, '\0');
+            MPI_Recv(&frame[0], size, MPI_BYTE, status.MPI_SOURCE,
+                     MVLE_TAG_RESULT, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+            source.store(frame);
+            break;
+        }
+        case MVLE_TAG_DONE: {
+            uint32_t done;
+
+            MPI_Recv(&done, 1, MPI_UNSIGNED, status.MPI_SOURCE,
+                     MVLE_TAG_DONE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            --active;
+            break;
+        }
+        default:
+            mvle_print_error("unknown message %d from node %d",
+                             status.MPI_TAG, status.MPI_SOURCE);
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+}
+
+/*
+ * Receive a chunk of combinations from the node 0.
+ */
+std::vector < uint32_t > mvle_receive_chunk()
+{
+    MPI_Status status;
+    int size;
+
+    MPI_Probe(0, MVLE_TAG_CHUNK, MPI_COMM_WORLD, &status);
+    MPI_Get_count(&status, MPI_UNSIGNED, &size);
+
+    std::vector < uint32_t > indices(size);
+    uint32_t empty;
+
+    MPI_Recv(indices.empty() ? &empty : &indices[0], size, MPI_UNSIGNED, 0,
+             MVLE_TAG_CHUNK, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    return indices;
+}
+
+/*
+ * The main thread of the others nodes requests the chunks of
+ * combinations to the node 0 and sends the results until the
+ * simulation threads are ended.
+ */
+void mvle_receive(mvle_worker_source& source, uint32_t processor)
+{
+    for (;;) {
+        std::string frame;
+        uint32_t message = 0;
+
+        switch (source.wait(processor, &frame)) {
+        case mvle_worker_source::EVENT_RESULT:
+            MPI_Send(&frame[0], frame.size(), MPI_BYTE, 0, MVLE_TAG_RESULT,
+                     MPI_COMM_WORLD);
+            break;
+        case mvle_worker_source::EVENT_REQUEST:
+            MPI_Send(&message, 1, MPI_UNSIGNED, 0, MVLE_TAG_REQUEST,
+                     MPI_COMM_WORLD);
+            source.push(mvle_receive_chunk());
+            break;
+        case mvle_worker_source::EVENT_DONE:
+            MPI_Send(&message, 1, MPI_UNSIGNED, 0, MVLE_TAG_DONE,
+                     MPI_COMM_WORLD);
+            return;
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     uint32_t rank = 0;
     uint32_t world = 0;
+    uint32_t processor = 0;
+    uint32_t chunk = 1;
+    std::string resultdir;
+    bool resume = false;
     bool show = false;
     bool result;
 
@@ -238,7 +701,15 @@ int main(int argc, char **argv)
     if ((result = mvle_mpi_init(&argc, &argv, &rank, &world))) {
         int vpz = 0;
         vle::utils::Package pack;
-        if ((result = mvle_parse_arg(argc, argv, &vpz, &show, pack))) {
+        if ((result = mvle_parse_arg(argc, argv, &vpz, &show, &processor,
+                                     &chunk, &resultdir, &resume,
+                                     pack))) {
+            uint32_t local = mvle_mpi_local_size();
+
+            if (not processor) {
+                processor = mvle_default_processor(local);
+            }
+
             if (show) {
                 while (vpz < argc) {
                     mvle_show(
@@ -248,38 +719,92 @@ int main(int argc, char **argv)
             } else {
                 try {
                     vle::manager::Manager man(vle::manager::LOG_SUMMARY,
-                                              vle::manager::SIMULATION_NONE |
-                                              vle::manager::SIMULATION_NO_RETURN,
+                                              resultdir.empty() ?
+                                              vle::manager::SIMULATION_NO_RETURN :
+                                              vle::manager::SIMULATION_NONE,
                                               &std::cout);
                     vle::utils::ModuleManager modules;
 
-                    mvle_print("MPI node %d/%d start\n", rank, world);
+                    mvle_print("MPI node %u/%u start (%u threads, %u"
+                               " processes on the node)\n", rank, world,
+                               processor, local);
 
                     while (vpz < argc) {
                         vle::manager::Error error;
-                        vle::value::Matrix *res = man.run(
-                            new vle::vpz::Vpz(pack.getExpFile(argv[vpz],
-                                    vle::utils::PKG_BINARY)),
-                            modules,
-                            1,
-                            rank,
-                            world,
-                            &error);
+                        vle::vpz::Vpz *file = new vle::vpz::Vpz(
+                            pack.getExpFile(argv[vpz],
+                                            vle::utils::PKG_BINARY));
+
+                        if (rank == 0) {
+                            vle::manager::ExperimentGenerator expgen(
+                                *file, 0, 1);
+                            boost::scoped_ptr < vle::manager::Journal >
+                                journal;
+
+                            if (not resultdir.empty()) {
+                                journal.reset(new vle::manager::Journal(
+                                        vle::utils::Path::buildFilename(
+                                            resultdir,
+                                            vle::utils::Path::basename(
+                                                argv[vpz]) + ".journal"),
+                                        resume, true));
+
+                                if (journal->completed()) {
+                                    mvle_print("%s: %u combinations already"
+                                               " completed\n", argv[vpz],
+                                               journal->completed());
+                                }
+                            }
+
+                            mvle_master_source source(expgen.size(),
+                                                      journal.get());
+                            boost::thread run(mvle_run(man, file, modules,
+                                                       processor, &source,
+                                                       0, &error));
+
+                            mvle_dispatch(source, world, chunk);
+                            run.join();
+
+                            if (journal) {
+                                journal->close();
+                            }
+                        } else {
+                            mvle_worker_source source;
+                            boost::thread run(mvle_run(man, file, modules,
+                                                       processor, &source,
+                                                       &source, &error));
+
+                            mvle_receive(source, processor);
+                            run.join();
+                        }
+
+                        /*
+                         * The messages of the next experimental frame
+                         * must not be received by the node 0 before
+                         * the end of this one.
+                         */
+                        MPI_Barrier(MPI_COMM_WORLD);
 
                         if (error.code) {
                             mvle_print_error("Experimental frames `%s' throws error %s",
                                              argv[vpz], error.message.c_str());
                         }
 
-                        delete res;
-
                         vpz++;
                     }
 
-                    mvle_print("MPI node %d/%d end\n", rank, world);
+                    mvle_print("MPI node %u/%u end\n", rank, world);
 
                 } catch (const std::exception& e) {
                     mvle_print_error("manager problem: %s", e.what());
+
+                    /*
+                     * The others nodes wait for the messages of this
+                     * node.
+                     */
+                    if (world > 1) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                    }
                 }
             }
         }
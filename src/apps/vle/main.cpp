@@ -38,6 +38,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <boost/program_options.hpp>
 
 #ifndef NDEBUG
@@ -195,17 +196,80 @@ static vle::manager::LogOptions convert_log_mode()
 }
 
 static int run_manager(CmdArgs::const_iterator it, CmdArgs::const_iterator end,
-        int processor, vle::utils::Package& pkg)
+        bool spawn, bool journal, bool resume, bool branch, double branchtime,
+        bool reuse, int processor, int memory, vle::utils::Package& pkg)
 {
-    vle::manager::Manager man(convert_log_mode(),
-                              vle::manager::SIMULATION_NONE |
-                              vle::manager::SIMULATION_NO_RETURN,
-                              &std::cout);
+    vle::manager::SimulationOptions options =
+        vle::manager::SIMULATION_NONE | vle::manager::SIMULATION_NO_RETURN;
+
+    if (spawn)
+        options |= vle::manager::SIMULATION_SPAWN_PROCESS;
+
+    if (reuse)
+        options |= vle::manager::SIMULATION_REUSE_MODELS;
+
+    vle::manager::Manager man(convert_log_mode(), options, &std::cout);
     vle::utils::ModuleManager modules;
     int success = EXIT_SUCCESS;
 
+    man.setBranch(branch, branchtime);
+    man.setMemory(memory > 0 ? (uint64_t)memory * 1024 * 1024 : 0);
+
+    /*
+     * Several experimental frames share the same threads: all their
+     * combinations are queued together and the errors are reported by
+     * experimental frame.
+     */
+    if (std::distance(it, end) > 1 and not spawn and not journal and
+        not resume and not branch) {
+        std::vector < vle::vpz::Vpz* > exps;
+        std::vector < std::string > names;
+
+        for (; it != end; ++it) {
+            try {
+                exps.push_back(new vle::vpz::Vpz(search_vpz(*it, pkg)));
+                names.push_back(*it);
+            } catch (const std::exception &e) {
+                std::cerr << vle::fmt(
+                    _("Experimental frames `%s' throws error %s"))
+                    % (*it) % e.what();
+
+                success = EXIT_FAILURE;
+            }
+        }
+
+        std::vector < vle::value::Matrix* > res;
+        std::vector < vle::manager::Error > errors;
+
+        man.run(exps, modules, processor, &res, &errors);
+
+        for (std::vector < std::string >::size_type i = 0; i < names.size();
+             ++i) {
+            if (errors[i].code) {
+                std::cerr << vle::fmt(
+                    _("Experimental frames `%s' throws error %s"))
+                    % names[i] % errors[i].message.c_str();
+
+                success = EXIT_FAILURE;
+            }
+
+            delete res[i];
+        }
+
+        return success;
+    }
+
     for (; it != end; ++it) {
         vle::manager::Error error;
+
+        /*
+         * The journal of the experimental frame `name.vpz' is
+         * `name.journal' in the current directory.
+         */
+        if (journal or resume)
+            man.setJournal(vle::utils::Path::basename(*it) + ".journal",
+                           resume);
+
         vle::value::Matrix *res = man.run(new vle::vpz::Vpz(
                                                search_vpz(*it, pkg)),
                 modules,
@@ -228,7 +292,8 @@ static int run_manager(CmdArgs::const_iterator it, CmdArgs::const_iterator end,
 }
 
 static int run_simulation(CmdArgs::const_iterator it,
-        CmdArgs::const_iterator end, vle::utils::Package& pkg)
+        CmdArgs::const_iterator end, int modelthreads,
+        vle::utils::Package& pkg)
 {
     vle::manager::Simulation sim(convert_log_mode(),
                                  vle::manager::SIMULATION_NONE |
@@ -237,6 +302,8 @@ static int run_simulation(CmdArgs::const_iterator it,
     vle::utils::ModuleManager modules;
     int success = EXIT_SUCCESS;
 
+    sim.setModelThreads(modelthreads > 0 ? modelthreads : 1);
+
     for (; it != end; ++it) {
         vle::manager::Error error;
         vle::value::Map *res = sim.run(new vle::vpz::Vpz(search_vpz(*it, pkg)),
@@ -256,6 +323,38 @@ static int run_simulation(CmdArgs::const_iterator it,
     return success;
 }
 
+static int run_worker(int options, const CmdArgs &args)
+{
+    if (args.size() != 1) {
+        std::cerr << _("Worker error: one experimental frame expected\n");
+
+        return EXIT_FAILURE;
+    }
+
+    vle::manager::Manager man(convert_log_mode(),
+                              static_cast < vle::manager::SimulationOptions >(
+                                  options),
+                              &std::cerr);
+    vle::utils::ModuleManager modules;
+    vle::manager::Error error;
+
+    try {
+        man.runWorker(new vle::vpz::Vpz(args.front()), modules, &error);
+    } catch (const std::exception &e) {
+        std::cerr << vle::fmt(_("Worker error: %1%\n")) % e.what();
+
+        return EXIT_FAILURE;
+    }
+
+    if (error.code) {
+        std::cerr << vle::fmt(_("Worker error: %1%\n")) % error.message;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 static bool init_package(vle::utils::Package& pkg, const CmdArgs &args)
 {
     if (not pkg.existsBinary()) {
@@ -273,7 +372,10 @@ static bool init_package(vle::utils::Package& pkg, const CmdArgs &args)
 }
 
 static int manage_package_mode(const std::string &packagename, bool manager,
-                               int processor, const CmdArgs &args)
+                               bool spawn, bool journal, bool resume,
+                               bool branch, double branchtime, bool reuse,
+                               int processor, int memory, int modelthreads,
+                               const CmdArgs &args)
 {
     CmdArgs::const_iterator it = args.begin();
     CmdArgs::const_iterator end = args.end();
@@ -342,9 +444,10 @@ static int manage_package_mode(const std::string &packagename, bool manager,
         ret = EXIT_FAILURE;
     else if (it != end) {
         if (manager)
-            ret = run_manager(it, end, processor, pkg);
+            ret = run_manager(it, end, spawn, journal, resume, branch,
+                              branchtime, reuse, processor, memory, pkg);
         else
-            ret = run_simulation(it, end, pkg);
+            ret = run_simulation(it, end, modelthreads, pkg);
     }
 
     return ret;
@@ -533,16 +636,24 @@ enum ProgramOptionsCode
     PROGRAM_OPTIONS_PACKAGE = 1,
     PROGRAM_OPTIONS_REMOTE = 2,
     PROGRAM_OPTIONS_CONFIG = 3,
+    PROGRAM_OPTIONS_WORKER = 4,
 };
 
 struct ProgramOptions
 {
-    ProgramOptions(int *verbose, int *trace, int *processor,
-            bool *manager_mode, std::string *packagename,
+    ProgramOptions(int *verbose, int *trace, int *processor, int *memory,
+            int *modelthreads, int *worker, bool *manager_mode,
+            bool *spawn_mode, bool *journal_mode,
+            bool *resume_mode, bool *branch_mode, double *branchtime,
+            bool *reuse_mode, std::string *packagename,
             std::string *remotecmd, std::string *configvar, CmdArgs *args)
         : generic(_("Allowed options")), hidden(_("Hidden options")),
-        verbose(verbose), trace(trace), processor(processor),
-        manager_mode(manager_mode), packagename(packagename),
+        verbose(verbose), trace(trace), processor(processor), memory(memory),
+        modelthreads(modelthreads), worker(worker),
+        manager_mode(manager_mode), spawn_mode(spawn_mode),
+        journal_mode(journal_mode), resume_mode(resume_mode),
+        branch_mode(branch_mode), branchtime(branchtime),
+        reuse_mode(reuse_mode), packagename(packagename),
         remotecmd(remotecmd), configvar(configvar), args(args)
     {
         generic.add_options()
@@ -556,8 +667,25 @@ struct ProgramOptions
             ("log-stdout", _("Trace of the simulation(s) are reported to the"
                          " standard output"))
             ("manager,m", _("Use the manager mode to run experimental frames"))
+            ("spawn", _("Use processes instead of threads in manager mode"))
+            ("journal", _("Record the completed combinations into"
+                          " `name.journal' in manager mode"))
+            ("resume", _("Skip the combinations completed in `name.journal'"
+                         " in manager mode"))
+            ("branch", po::value < double >(branchtime),
+             _("Run the simulations once until this time, then fork a"
+               " process per combination in manager mode"))
+            ("reuse", _("Reset the models between the combinations instead"
+                        " of rebuilding them in manager mode"))
             ("processor,o", po::value < int >(processor)->default_value(1),
              _("Select number of processor in manager mode [>= 0]"))
+            ("memory", po::value < int >(memory)->default_value(0),
+             _("Start a simulation only if the memory of the simulations in"
+               " progress fits into this budget in megabytes in manager"
+               " mode [0 = no limit]"))
+            ("model-threads", po::value < int >(modelthreads)->default_value(1),
+             _("Build and initialize the models of a simulation with this"
+               " number of threads in simulation mode [>= 1]"))
             ("verbose,V", po::value < int >(verbose)->default_value(0),
              ("Verbose mode 0 - 3. [default 0]\n"
               "0 no trace and no long exception\n"
@@ -596,6 +724,9 @@ struct ProgramOptions
 
         hidden.add_options()
             ("input", po::value < CmdArgs >(), _("input"))
+            ("worker", po::value < int >(worker),
+             _("Worker process of the manager mode, with the simulation"
+               " options"))
             ;
 
         desc.add(generic).add(hidden);
@@ -618,6 +749,21 @@ struct ProgramOptions
             if (vm.count("manager"))
                 *manager_mode = true;
 
+            if (vm.count("spawn"))
+                *spawn_mode = true;
+
+            if (vm.count("journal"))
+                *journal_mode = true;
+
+            if (vm.count("resume"))
+                *resume_mode = true;
+
+            if (vm.count("branch"))
+                *branch_mode = true;
+
+            if (vm.count("reuse"))
+                *reuse_mode = true;
+
             if (vm.count("input"))
                 *args = vm["input"].as < CmdArgs >();
 
@@ -650,6 +796,9 @@ struct ProgramOptions
 
             if (vm.count("config"))
                 return PROGRAM_OPTIONS_CONFIG;
+
+            if (vm.count("worker"))
+                return PROGRAM_OPTIONS_WORKER;
         } catch (const std::exception &e) {
             std::cerr << e.what() << std::endl;
 
@@ -664,8 +813,11 @@ struct ProgramOptions
 
     po::options_description desc, generic, hidden;
     po::variables_map vm;
-    int *verbose, *trace, *processor;
-    bool *manager_mode;
+    int *verbose, *trace, *processor, *memory, *modelthreads, *worker;
+    bool *manager_mode, *spawn_mode, *journal_mode, *resume_mode;
+    bool *branch_mode;
+    double *branchtime;
+    bool *reuse_mode;
     std::string *packagename, *remotecmd, *configvar;
     CmdArgs *args;
 };
@@ -675,14 +827,25 @@ int main(int argc, char *argv[])
     int ret;
     int verbose = 0;
     int processor = 1;
+    int memory = 0;
+    int modelthreads = 1;
+    int worker = 0;
     int trace = -1; /* < 0 = stderr, 0 = file and > 0 = stdout */
     bool manager_mode = false;
+    bool spawn_mode = false;
+    bool journal_mode = false;
+    bool resume_mode = false;
+    bool branch_mode = false;
+    double branchtime = 0.0;
+    bool reuse_mode = false;
     std::string packagename, remotecmd, configvar;
     CmdArgs args;
 
     {
-        ProgramOptions prgs(&verbose, &trace, &processor, &manager_mode,
-                &packagename, &remotecmd, &configvar, &args);
+        ProgramOptions prgs(&verbose, &trace, &processor, &memory,
+                &modelthreads, &worker, &manager_mode, &spawn_mode,
+                &journal_mode, &resume_mode, &branch_mode, &branchtime,
+                &reuse_mode, &packagename, &remotecmd, &configvar, &args);
 
         ret = prgs.run(argc, argv);
 
@@ -698,12 +861,15 @@ int main(int argc, char *argv[])
 
     switch (ret) {
     case PROGRAM_OPTIONS_PACKAGE:
-        return manage_package_mode(packagename, manager_mode, processor,
-                args);
+        return manage_package_mode(packagename, manager_mode, spawn_mode,
+                journal_mode, resume_mode, branch_mode, branchtime, reuse_mode,
+                processor, memory, modelthreads, args);
     case PROGRAM_OPTIONS_REMOTE:
         return manage_remote_mode(remotecmd, args);
     case PROGRAM_OPTIONS_CONFIG:
         return manage_config_mode(configvar, args);
+    case PROGRAM_OPTIONS_WORKER:
+        return run_worker(worker, args);
     default:
         break;
     };
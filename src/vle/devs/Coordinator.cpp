@@ -53,7 +53,19 @@ Coordinator::Coordinator(const utils::ModuleManager& modulemgr,
                          const vpz::Experiment& experiment,
                          RootCoordinator& root)
     : m_currentTime(0.0), m_modelFactory(modulemgr, dyn, cls, experiment, root),
-      m_modulemgr(modulemgr), m_isStarted(false)
+      m_modulemgr(modulemgr), m_isStarted(false),
+      m_termination(experiment.conditions())
+{
+}
+
+Coordinator::Coordinator(const utils::ModuleManager& modulemgr,
+                         const vpz::Dynamics* dyn,
+                         const vpz::Classes* cls,
+                         vpz::Experiment* experiment,
+                         RootCoordinator& root)
+    : m_currentTime(0.0), m_modelFactory(modulemgr, dyn, cls, experiment, root),
+      m_modulemgr(modulemgr), m_isStarted(false),
+      m_termination(experiment->conditions())
 {
 }
 
@@ -145,6 +157,10 @@ void Coordinator::run()
         }
     }
 
+    if (not m_termination.reason().empty()) {
+        processFinishViews();
+    }
+
     bags.clear();
 }
 
@@ -162,6 +178,42 @@ void Coordinator::finish()
                       m_currentTime));
 }
 
+void Coordinator::branch(const Time& time, const vpz::Conditions& conditions)
+{
+    m_modelFactory.branch(*this, time, conditions);
+}
+
+void Coordinator::reset(const Time& current, vpz::BaseModel* model,
+                        const vpz::Conditions& conditions,
+                        const std::string& name)
+{
+    std::for_each(m_deletedSimulator.begin(), m_deletedSimulator.end(),
+                  boost::checked_deleter < Simulator >());
+    m_deletedSimulator.clear();
+    m_toDelete = 0;
+
+    m_eventTable.clear();
+    m_obsEventBuffer.erase();
+
+    std::for_each(m_viewList.begin(),
+                  m_viewList.end(),
+                  boost::bind(
+                      boost::checked_deleter < View >(),
+                      boost::bind(&ViewList::value_type::second, _1)));
+
+    m_viewList.clear();
+    m_eventViewList.clear();
+    m_timedViewList.clear();
+    m_finishViewList.clear();
+
+    m_currentTime = current;
+    m_modelFactory.experiment().setName(name);
+    m_termination.clear();
+    buildViews();
+
+    m_modelFactory.reset(*this, model, conditions);
+}
+
 //
 ///
 //// Functions use by Executive models to manage DsDevs simulation.
@@ -460,6 +512,7 @@ void Coordinator::buildViews()
         }
         m_viewList[it->second.name()] = obs;
         stream->setView(obs);
+        obs->setTermination(&m_termination);
     }
 }
 
@@ -473,7 +526,8 @@ StreamWriter* Coordinator::buildOutput(const vpz::View& view,
                       view.name()).str());
 
     stream->open(output.plugin(), output.package(), output.location(), file,
-                 (output.data()) ? output.data()->clone() : 0, m_currentTime);
+                 (output.data()) ? output.data()->clone() : 0, m_currentTime,
+                 output.asynchronous());
 
     return stream;
 }
@@ -498,6 +552,7 @@ void Coordinator::processInternalEvent(
     }
 
     processEventView(sim);
+    m_termination.check(*sim, m_currentTime);
 }
 
 void Coordinator::processExternalEvents(
@@ -514,6 +569,7 @@ void Coordinator::processExternalEvents(
     }
 
     processEventView(sim);
+    m_termination.check(*sim, m_currentTime);
 }
 
 void Coordinator::processConflictEvents(
@@ -530,6 +586,7 @@ void Coordinator::processConflictEvents(
         *modelbag.internal(), modelbag.externals());
 
     processEventView(sim);
+    m_termination.check(*sim, m_currentTime);
 
     if (internal) {
         m_eventTable.putInternalEvent(internal);
@@ -547,6 +604,18 @@ void Coordinator::processEventView(Simulator* model)
     }
 }
 
+void Coordinator::processFinishViews()
+{
+    if (m_currentTime >= m_durationTime) {
+        return;
+    }
+
+    for (FinishViewList::iterator it = m_finishViewList.begin();
+         it != m_finishViewList.end(); ++it) {
+        it->second->run(m_currentTime);
+    }
+}
+
 void Coordinator::processViewEvents(ViewEventList& bag)
 {
     for (ViewEventList::iterator it = bag.begin(); it != bag.end(); ++it) {
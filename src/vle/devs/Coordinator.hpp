@@ -34,6 +34,7 @@
 #include <vle/devs/View.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/devs/ModelFactory.hpp>
+#include <vle/devs/Termination.hpp>
 
 namespace vle { namespace devs {
 
@@ -57,8 +58,28 @@ public:
                 const vpz::Experiment& experiment,
                 RootCoordinator& root);
 
+    /**
+     * @brief Build a Coordinator which shares the dynamics and the classes
+     * of a vpz::Project and takes the ownership of the experiment (see
+     * ModelFactory).
+     */
+    Coordinator(const utils::ModuleManager& modulemgr,
+                const vpz::Dynamics* dyn,
+                const vpz::Classes* cls,
+                vpz::Experiment* experiment,
+                RootCoordinator& root);
+
     ~Coordinator();
 
+    /**
+     * @brief Check if the simulation of a graph hierarchy can modify it,
+     * ie. if one of its atomic models is an Executive.
+     * @param mdls the hierarchy of models.
+     * @return true if an atomic model is an Executive.
+     */
+    bool hasExecutive(const vpz::Model& mdls)
+    { return m_modelFactory.hasExecutive(mdls); }
+
     /**
      * @brief Initialise Coordinator before running simulation. Rand is
      * initialized, send to all Simulator the first init event found and
@@ -90,6 +111,31 @@ public:
      */
     void finish();
 
+    /**
+     * @brief Replace the conditions of the experiment with the
+     * conditions of a branch and apply the new values to the models
+     * which use the modified conditions (see Dynamics::branch).
+     * @param time the time of the branching.
+     * @param conditions the conditions of the branch.
+     * @throw utils::ModellingError if a model does not support the
+     * branching.
+     */
+    void branch(const Time& time, const vpz::Conditions& conditions);
+
+    /**
+     * @brief Restart the simulation without rebuilding the models: the
+     * events are deleted, the views are rebuilt and the models restore
+     * their state (see Dynamics::reset) and are initialized again. The
+     * finish function must be called before.
+     * @param current the time of the beginning of the simulation.
+     * @param model the hierarchy of models of the simulation.
+     * @param conditions the conditions to replace in the experiment.
+     * @param name the name of the experiment.
+     * @throw utils::ModellingError if a model cannot be reset.
+     */
+    void reset(const Time& current, vpz::BaseModel* model,
+               const vpz::Conditions& conditions, const std::string& name);
+
     //
     ///
     //// Functions use by Executive models to manage DsDevs simulation.
@@ -285,6 +331,14 @@ public:
 
     const ViewList& getViews() const { return m_viewList; }
 
+    /**
+     * @brief Check if the simulation is ended before the end of the
+     * experiment by a model or a predicate on the observations (see
+     * devs::Termination).
+     * @return The description of the reason or an empty string.
+     */
+    const std::string& terminated() const { return m_termination.reason(); }
+
 private:
     Coordinator(const Coordinator& other);
     Coordinator& operator=(const Coordinator& other);
@@ -303,6 +357,7 @@ private:
     const utils::ModuleManager& m_modulemgr;
     ViewEventList               m_obsEventBuffer;
     bool                        m_isStarted;
+    Termination                 m_termination;
 
     /**
      * @brief Build, for each vpz::View a StreamWriter and View.
@@ -338,6 +393,12 @@ private:
      */
     void processViewEvents(ViewEventList& bag);
 
+    /**
+     * @brief Observe the models of the finish views at the current time
+     * when the simulation is ended before the end of the experiment.
+     */
+    void processFinishViews();
+
     /**
      * @brief build the simulator from the vpz::BaseModel stock.
      * @param model
@@ -37,6 +37,32 @@
 
 namespace vle { namespace devs {
 
+Dynamics::~Dynamics()
+{
+    delete m_rand;
+}
+
+utils::Rand& Dynamics::rand()
+{
+    if (not m_rand) {
+        m_rand = new utils::Rand(m_seed);
+        m_rand->setAntithetic(m_antithetic);
+    }
+
+    return *m_rand;
+}
+
+void Dynamics::seed(uint32_t seed, bool antithetic)
+{
+    m_seed = seed;
+    m_antithetic = antithetic;
+
+    if (m_rand) {
+        m_rand->seed(seed);
+        m_rand->setAntithetic(antithetic);
+    }
+}
+
 ExternalEvent* Dynamics::buildEvent(const std::string& portName) const
 {
   return new ExternalEvent(portName);
@@ -41,6 +41,7 @@
 #include <vle/value/Boolean.hpp>
 #include <vle/value/String.hpp>
 #include <vle/utils/PackageTable.hpp>
+#include <vle/utils/Rand.hpp>
 #include <vle/version.hpp>
 #include <string>
 
@@ -67,6 +68,8 @@
 namespace vle { namespace devs {
 
     class RootCoordinator;
+    class Simulator;
+    class DynamicsDbg;
 
     /**
      * @brief A PackageId defines a reference to an element of the
@@ -77,9 +80,19 @@ namespace vle { namespace devs {
     class VLE_API DynamicsInit
     {
     public:
+        /**
+         * @param model the atomic model of the Dynamics.
+         * @param packageid the package of the Dynamics.
+         * @param seed the seed of the random stream of the model (see
+         * RootCoordinator::seed).
+         * @param antithetic true if the random stream is antithetic.
+         */
         DynamicsInit(const vpz::AtomicModel& model,
-                     PackageId packageid)
-            : m_model(model), m_packageid(packageid)
+                     PackageId packageid,
+                     uint32_t seed = 0,
+                     bool antithetic = false)
+            : m_model(model), m_packageid(packageid), m_seed(seed),
+            m_antithetic(antithetic)
         {}
 
         virtual ~DynamicsInit()
@@ -87,10 +100,14 @@ namespace vle { namespace devs {
 
         const vpz::AtomicModel& model() const { return m_model; }
         PackageId packageid() const { return m_packageid; }
+        uint32_t seed() const { return m_seed; }
+        bool antithetic() const { return m_antithetic; }
 
     private:
         const vpz::AtomicModel&       m_model;
         PackageId                       m_packageid;
+        uint32_t                        m_seed;
+        bool                            m_antithetic;
     };
 
     /**
@@ -108,14 +125,14 @@ namespace vle { namespace devs {
          */
         Dynamics(const DynamicsInit& init,
                  const vle::devs::InitEventList&  /* events */)
-            : m_model(init.model()), m_packageid(init.packageid())
+            : m_model(init.model()), m_packageid(init.packageid()),
+            m_rand(0), m_seed(init.seed()), m_antithetic(init.antithetic())
         {}
 
 	/**
-	 * @brief Destructor (nothing to do)
+	 * @brief Destructor, delete the random stream.
 	 */
-        virtual ~Dynamics()
-        {}
+        virtual ~Dynamics();
 
 	/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 	  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -200,6 +217,50 @@ namespace vle { namespace devs {
         virtual void finish()
         { }
 
+        /**
+         * @brief Apply new values of the conditions of the model during
+         * the simulation: the manager::Manager runs the beginning of the
+         * simulation once and branches it for each combination of the
+         * experimental frame (see manager::Manager::setBranch). The state
+         * of the model and its next internal event are kept. By default,
+         * a model does not support the branching.
+         * @param time the time of the branching.
+         * @param events the values of the conditions of the model in the
+         * branch.
+         * @return true if the new values are applied, false otherwise.
+         */
+        virtual bool branch(const vle::devs::Time& /* time */,
+                            const vle::devs::InitEventList& /* events */)
+        { return false; }
+
+        /**
+         * @brief Restore the state of the model as the constructor does,
+         * to run a new simulation of the same experiment without
+         * rebuilding the models (see devs::RootCoordinator::reset). The
+         * finish function of the previous simulation is already called
+         * and the init function is called after the reset. By default, a
+         * model cannot be reset. The models of a simulation with an
+         * executive are never reset.
+         * @param events the values of the conditions of the model in the
+         * new simulation.
+         * @return true if the state is restored, false otherwise.
+         */
+        virtual bool reset(const vle::devs::InitEventList& /* events */)
+        { return false; }
+
+        /**
+         * @brief Check if the simulation can end before the end of the
+         * experiment: a controller model detects the extinction of a
+         * population or a steady state for example. This function is
+         * called after each transition of the model and at each
+         * observation of the model by a view (see devs::Termination). By
+         * default, a model does not end the simulation.
+         * @param time the time of the transition or the observation.
+         * @return true to end the simulation at this time.
+         */
+        virtual bool terminate(const vle::devs::Time& /* time */) const
+        { return false; }
+
 	/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 	  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 	 * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -453,13 +514,43 @@ namespace vle { namespace devs {
          */
         inline PackageId packageid() const { return m_packageid; }
 
+        /**
+         * @brief Get the random stream of the model. The stream is seeded
+         * from the seed of the simulation and the complete name of the
+         * model (see RootCoordinator::seed): the numbers drawn by a model
+         * do not depend on the other models nor on the order of their
+         * construction, and two simulations with the same seed draw the
+         * same numbers for the same model (common random numbers). The
+         * stream is seeded again when the model is reset.
+         * @return A reference to the random stream.
+         */
+        utils::Rand& rand();
+
     private:
+        Dynamics(const Dynamics& other);
+        Dynamics& operator=(const Dynamics& other);
+
+        friend class Simulator;
+        friend class DynamicsDbg;
+
+        /**
+         * @brief Assign the seed of the random stream of the model, used
+         * by the Simulator before a reset.
+         * @param seed the seed of the stream.
+         * @param antithetic true if the stream is antithetic.
+         */
+        void seed(uint32_t seed, bool antithetic);
+
         const vpz::AtomicModel& m_model; /**< A constant reference to the
                                              atomic model node of the graph.
                                                */
 
         PackageId m_packageid; /**< An iterator to std::set of the
                                  vle::utils::PackageTable. */
+
+        utils::Rand* m_rand; /**< The random stream, built on demand. */
+        uint32_t m_seed;
+        bool m_antithetic;
     };
 
 }} // namespace vle devs
@@ -125,5 +125,32 @@ void DynamicsDbg::finish()
     mDynamics->finish();
 }
 
+bool DynamicsDbg::branch(const Time& time, const InitEventList& events)
+{
+    TraceDevs(fmt(_("%1$20.10g %2% [DEVS] branch")) % time % mName);
+
+    return mDynamics->branch(time, events);
+}
+
+bool DynamicsDbg::reset(const InitEventList& events)
+{
+    TraceDevs(fmt(_("                     %1% [DEVS] reset")) % mName);
+
+    mDynamics->seed(m_seed, m_antithetic);
+
+    return mDynamics->reset(events);
+}
+
+bool DynamicsDbg::terminate(const Time& time) const
+{
+    bool result = mDynamics->terminate(time);
+
+    if (result) {
+        TraceDevs(fmt(_("%1$20.10g %2% [DEVS] terminate")) % time % mName);
+    }
+
+    return result;
+}
+
 }} // namespace vle devs
 
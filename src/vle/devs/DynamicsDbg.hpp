@@ -155,6 +155,29 @@ namespace vle { namespace devs {
          */
         virtual void finish();
 
+        /**
+         * @brief Apply new values of the conditions of the model during
+         * the simulation.
+         * @param time the time of the branching.
+         * @param events the values of the conditions of the model.
+         * @return true if the new values are applied, false otherwise.
+         */
+        virtual bool branch(const Time& time, const InitEventList& events);
+
+        /**
+         * @brief Restore the state of the model to run a new simulation.
+         * @param events the values of the conditions of the model.
+         * @return true if the state is restored, false otherwise.
+         */
+        virtual bool reset(const InitEventList& events);
+
+        /**
+         * @brief Check if the model ends the simulation.
+         * @param time the time of the observation.
+         * @return true to end the simulation.
+         */
+        virtual bool terminate(const Time& time) const;
+
     private:
         Dynamics* mDynamics;
         std::string mName;
@@ -71,6 +71,11 @@ EventTable::EventTable(size_t sz)
 }
 
 EventTable::~EventTable()
+{
+    clear();
+}
+
+void EventTable::clear()
 {
     std::for_each(mInternalEventList.begin(),
                   mInternalEventList.end(),
@@ -89,6 +94,13 @@ EventTable::~EventTable()
                           boost::checked_deleter < ExternalEvent >());
 	}
     }
+
+    mInternalEventList.clear();
+    mObservationEventList.clear();
+    mInternalEventModel.clear();
+    mExternalEventModel.clear();
+    mCompleteEventBagModel.clear();
+    mCurrentTime = 0.0;
 }
 
 size_t EventTable::getEventNumber() const
@@ -320,6 +320,12 @@ namespace vle { namespace devs {
          */
         void delModelEvents(Simulator* mdl);
 
+        /**
+         * @brief Delete all the events, the current time is reset to
+         * zero.
+         */
+        void clear();
+
     private:
         typedef std::map < Simulator*, InternalEvent* > InternalEventModel;
         typedef std::map < Simulator*, ExternalEventList > ExternalEventModel;
@@ -66,8 +66,11 @@ class VLE_API ExecutiveInit : public DynamicsInit
 public:
     ExecutiveInit(const vpz::AtomicModel& model,
                   PackageId packageid,
-                  Coordinator& coordinator)
-        : DynamicsInit(model, packageid), m_coordinator(coordinator)
+                  Coordinator& coordinator,
+                  uint32_t seed = 0,
+                  bool antithetic = false)
+        : DynamicsInit(model, packageid, seed, antithetic),
+        m_coordinator(coordinator)
     {}
 
     virtual ~ExecutiveInit()
@@ -37,6 +37,9 @@
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Algo.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <set>
 
 namespace vle { namespace devs {
 
@@ -45,24 +48,48 @@ ModelFactory::ModelFactory(const utils::ModuleManager& modulemgr,
                            const vpz::Classes& cls,
                            const vpz::Experiment& exp,
                            RootCoordinator& root)
-    : mModuleMgr(modulemgr), mDynamics(dyn), mClasses(cls), mExperiment(exp),
-      mRoot(root)
+    : mModuleMgr(modulemgr), mDynamics(0), mClasses(0),
+      mOwnedDynamics(new vpz::Dynamics(dyn)),
+      mOwnedClasses(new vpz::Classes(cls)),
+      mExperiment(new vpz::Experiment(exp)), mRoot(root)
 {
+    mDynamics = mOwnedDynamics.get();
+    mClasses = mOwnedClasses.get();
+}
+
+ModelFactory::ModelFactory(const utils::ModuleManager& modulemgr,
+                           const vpz::Dynamics* dyn,
+                           const vpz::Classes* cls,
+                           vpz::Experiment* experiment,
+                           RootCoordinator& root)
+    : mModuleMgr(modulemgr), mDynamics(dyn), mClasses(cls),
+      mExperiment(experiment), mRoot(root)
+{
+}
+
+vpz::Dynamics& ModelFactory::dynamics()
+{
+    if (not mOwnedDynamics) {
+        mOwnedDynamics.reset(new vpz::Dynamics(*mDynamics));
+        mDynamics = mOwnedDynamics.get();
+    }
+
+    return *mOwnedDynamics;
 }
 
 void ModelFactory::cleanCache()
 {
-    mDynamics.cleanNoPermanent();
-    mExperiment.cleanNoPermanent();
+    dynamics().cleanNoPermanent();
+    mExperiment->cleanNoPermanent();
 }
 
-void ModelFactory::addPermanent(const vpz::Dynamic& dynamics)
+void ModelFactory::addPermanent(const vpz::Dynamic& dyn)
 {
     try {
-        mDynamics.add(dynamics);
+        dynamics().add(dyn);
     } catch(const std::exception& e) {
         throw utils::InternalError(fmt(_(
-            "Model factory cannot add dynamics %1%: %2%")) % dynamics.name() %
+            "Model factory cannot add dynamics %1%: %2%")) % dyn.name() %
             e.what());
     }
 }
@@ -70,7 +97,7 @@ void ModelFactory::addPermanent(const vpz::Dynamic& dynamics)
 void ModelFactory::addPermanent(const vpz::Condition& condition)
 {
     try {
-        vpz::Conditions& conds(mExperiment.conditions());
+        vpz::Conditions& conds(mExperiment->conditions());
         conds.add(condition);
     } catch(const std::exception& e) {
         throw utils::InternalError(fmt(_(
@@ -82,7 +109,7 @@ void ModelFactory::addPermanent(const vpz::Condition& condition)
 void ModelFactory::addPermanent(const vpz::Observable& observable)
 {
     try {
-        vpz::Views& views(mExperiment.views());
+        vpz::Views& views(mExperiment->views());
         views.addObservable(observable);
     } catch(const std::exception& e) {
         throw utils::InternalError(fmt(_(
@@ -91,14 +118,229 @@ void ModelFactory::addPermanent(const vpz::Observable& observable)
     }
 }
 
-void ModelFactory::createModel(Coordinator& coordinator,
-                               vpz::AtomicModel* model,
-                               const std::string& dynamics,
-                               const std::vector < std::string >& conditions,
-                               const std::string& observable)
+static devs::Dynamics* buildNewDynamicsWrapper(
+    devs::Simulator* atom,
+    const vpz::Dynamic& dyn,
+    const InitEventList& events,
+    void* symbol,
+    utils::PackageTable::index package,
+    uint32_t seed,
+    bool antithetic)
+{
+    typedef Dynamics*(*fctdw)(const DynamicsWrapperInit&, const InitEventList&);
+
+    fctdw fct = utils::functionCast < fctdw >(symbol);
+
+    try {
+        return fct(DynamicsWrapperInit(
+                *atom->getStructure(),
+                package,
+                dyn.library(),
+                seed,
+                antithetic), events);
+    } catch(const std::exception& e) {
+        throw utils::ModellingError(
+            fmt(_("Atomic model wrapper `%1%:%2%' (from dynamics `%3%'"
+                  " library `%4%' package `%5%') throws error in"
+                  " constructor: `%6%'")) %
+            atom->getStructure()->getParentName() %
+            atom->getStructure()->getName() %
+            dyn.name() % dyn.library() % dyn.package() % e.what());
+    }
+}
+
+static devs::Dynamics* buildNewDynamics(
+    devs::Simulator* atom,
+    const vpz::Dynamic& dyn,
+    const InitEventList& events,
+    void *symbol,
+    utils::PackageTable::index package,
+    uint32_t seed,
+    bool antithetic)
+{
+    typedef Dynamics*(*fctdyn)(const DynamicsInit&, const InitEventList&);
+
+    fctdyn fct = utils::functionCast < fctdyn >(symbol);
+
+    try {
+        return fct(DynamicsInit(
+                *atom->getStructure(),
+                package,
+                seed,
+                antithetic),
+            events);
+    } catch(const std::exception& e) {
+        throw utils::ModellingError(
+            fmt(_("Atomic model `%1%:%2%' (from dynamics `%3%' library"
+                  " `%4%' package `%5%') throws error in constructor:"
+                  " `%6%'")) % atom->getStructure()->getParentName() %
+            atom->getStructure()->getName() % dyn.name() % dyn.library() %
+            dyn.package() % e.what());
+    }
+}
+
+static devs::Dynamics* buildNewExecutive(
+    Coordinator& coordinator,
+    devs::Simulator* atom,
+    const vpz::Dynamic& dyn,
+    const InitEventList& events,
+    void *symbol,
+    utils::PackageTable::index package,
+    uint32_t seed,
+    bool antithetic)
+{
+    typedef Dynamics*(*fctexe)(const ExecutiveInit&, const InitEventList&);
+
+    fctexe fct = utils::functionCast < fctexe >(symbol);
+
+    try {
+        return fct(ExecutiveInit(
+                *atom->getStructure(),
+                package,
+                coordinator,
+                seed,
+                antithetic), events);
+    } catch(const std::exception& e) {
+        throw utils::ModellingError(
+            fmt(_("Executive model `%1%:%2%' (from dynamics `%3%'"
+                  " library `%4%' package `%5%') throws error in"
+                  " constructor: `%6%'")) %
+            atom->getStructure()->getParentName() %
+            atom->getStructure()->getName() % dyn.name() % dyn.library() %
+            dyn.package() % e.what());
+    }
+}
+
+/**
+ * @brief An atomic model built by the ModelFactory::createModelsInParallel
+ * function. The error is filled if the constructor or the init function
+ * throws an exception.
+ */
+struct ModelBuild
+{
+    ModelBuild()
+        : sim(0), dyn(0), symbol(0), type(utils::MODULE_DYNAMICS),
+        events(0), seed(0), antithetic(false), dynamics(0), event(0)
+    {}
+
+    Simulator*                  sim;
+    const vpz::Dynamic*         dyn;
+    void*                       symbol;
+    utils::ModuleType           type;
+    utils::PackageTable::index  package;
+    value::Map*                 events;
+    uint32_t                    seed;
+    bool                        antithetic;
+    Dynamics*                   dynamics;
+    InternalEvent*              event;
+    std::string                 error;
+};
+
+typedef std::vector < ModelBuild > ModelBuildList;
+
+/**
+ * @brief Release the initialization values of a model without deleting
+ * the values owned by the conditions.
+ */
+static void clearInitValues(value::Map* events)
+{
+    if (events) {
+        events->value().clear();
+        delete events;
+    }
+}
+
+/**
+ * @brief The @c ModelBuildWorker is a boost thread functor to build or
+ * initialize a contiguous part of the ModelBuildList. The Executive are
+ * ignored, they are built and initialized by the calling thread.
+ */
+class ModelBuildWorker
 {
-    const vpz::Dynamic& dyn = mDynamics.get(dynamics);
+public:
+    enum Phase { CONSTRUCTOR, INIT };
+
+    ModelBuildWorker(ModelBuildList& builds, Phase phase, const Time& time,
+                     uint32_t index, uint32_t threads)
+        : builds(builds), phase(phase), time(time), index(index),
+        threads(threads)
+    {}
+
+    void operator()()
+    {
+        ModelBuildList::size_type first, last;
+
+        first = (builds.size() * index) / threads;
+        last = (builds.size() * (index + 1)) / threads;
+
+        for (ModelBuildList::size_type i = first; i < last; ++i) {
+            ModelBuild& build(builds[i]);
+
+            if (build.type == utils::MODULE_DYNAMICS_EXECUTIVE) {
+                continue;
+            }
+
+            try {
+                if (phase == CONSTRUCTOR) {
+                    if (build.type == utils::MODULE_DYNAMICS) {
+                        build.dynamics = buildNewDynamics(
+                            build.sim, *build.dyn, *build.events,
+                            build.symbol, build.package, build.seed,
+                            build.antithetic);
+                    } else {
+                        build.dynamics = buildNewDynamicsWrapper(
+                            build.sim, *build.dyn, *build.events,
+                            build.symbol, build.package, build.seed,
+                            build.antithetic);
+                    }
+                } else {
+                    build.event = build.sim->init(time);
+                }
+            } catch (const std::exception& e) {
+                build.error.assign(e.what());
+            }
+        }
+    }
+
+private:
+    ModelBuildList& builds;
+    Phase           phase;
+    Time            time;
+    uint32_t        index;
+    uint32_t        threads;
+};
+
+const ModelFactory::Symbol& ModelFactory::getSymbol(const vpz::Dynamic& dyn)
+{
+    std::pair < std::string, std::string > key(dyn.package(), dyn.library());
+    SymbolList::const_iterator it = mSymbols.find(key);
+
+    if (it != mSymbols.end()) {
+        return it->second;
+    }
+
+    Symbol result;
+    result.type = utils::MODULE_DYNAMICS;
+
+    try {
+        result.symbol = mModuleMgr.get(dyn.package(), dyn.library(),
+                                       utils::MODULE_DYNAMICS, &result.type);
+    } catch (const std::exception& e) {
+        throw utils::ModellingError(fmt(
+                _("Dynamic library loading problem: cannot get any"
+                  " dynamics, executive or wrapper '%1%' in library"
+                  " '%2%' package '%3%'\n:%4%")) % dyn.name() %
+            dyn.library() % dyn.package() % e.what());
+    }
+
+    result.package = mPackages.get(dyn.package());
 
+    return mSymbols.insert(std::make_pair(key, result)).first->second;
+}
+
+Simulator* ModelFactory::buildSimulator(Coordinator& coordinator,
+                                        vpz::AtomicModel* model)
+{
     const SimulatorMap& result(coordinator.modellist());
     if (result.find(model) != result.end()) {
         throw utils::InternalError(fmt(_(
@@ -109,41 +351,41 @@ void ModelFactory::createModel(Coordinator& coordinator,
     Simulator* sim = new Simulator(model);
     coordinator.addModel(model, sim);
 
-    value::Map initValues;
-    if (not conditions.empty()) {
-        for (std::vector < std::string >::const_iterator it =
-             conditions.begin(); it != conditions.end(); ++it) {
-	    const vpz::Condition& cnd(mExperiment.conditions().get(*it));
-	    value::MapValue vl;
-	    cnd.fillWithFirstValues(vl);
-
-	    for (value::MapValue::const_iterator itv = vl.begin();
-		 itv != vl.end(); ++itv) {
-
-                if (initValues.exist(itv->first)) {
-                    initValues.value().clear();
-                    throw utils::InternalError(fmt(_(
-                            "Multiples condition with the same init port " \
-                            "name '%1%'")) % itv->first);
-                }
-                initValues.add(itv->first, itv->second);
-            }
+    return sim;
+}
 
-            vl.clear();
-	}
-    }
+void ModelFactory::buildInitValues(
+    const std::vector < std::string >& conditions,
+    value::Map& initValues)
+{
+    for (std::vector < std::string >::const_iterator it =
+         conditions.begin(); it != conditions.end(); ++it) {
+        const vpz::Condition& cnd(mExperiment->conditions().get(*it));
+        value::MapValue vl;
+        cnd.fillWithFirstValues(vl);
+
+        for (value::MapValue::const_iterator itv = vl.begin();
+             itv != vl.end(); ++itv) {
+
+            if (initValues.exist(itv->first)) {
+                initValues.value().clear();
+                throw utils::InternalError(fmt(_(
+                        "Multiples condition with the same init port " \
+                        "name '%1%'")) % itv->first);
+            }
+            initValues.add(itv->first, itv->second);
+        }
 
-    try {
-        sim->addDynamics(attachDynamics(coordinator, sim, dyn, initValues));
-    } catch(const std::exception& /*e*/) {
-        initValues.value().clear();
-        throw;
+        vl.clear();
     }
+}
 
-    initValues.value().clear();
-
+void ModelFactory::attachObservables(Coordinator& coordinator,
+                                     Simulator* sim,
+                                     const std::string& observable)
+{
     if (not observable.empty()) {
-        vpz::Observable& ob(mExperiment.views().observables().get(observable));
+        vpz::Observable& ob(mExperiment->views().observables().get(observable));
         const vpz::ObservablePortList& lst(ob.observableportlist());
 
         for (vpz::ObservablePortList::const_iterator it = lst.begin();
@@ -165,6 +407,31 @@ void ModelFactory::createModel(Coordinator& coordinator,
             }
         }
     }
+}
+
+void ModelFactory::createModel(Coordinator& coordinator,
+                               vpz::AtomicModel* model,
+                               const std::string& dynamics,
+                               const std::vector < std::string >& conditions,
+                               const std::string& observable)
+{
+    const vpz::Dynamic& dyn = mDynamics->get(dynamics);
+
+    Simulator* sim = buildSimulator(coordinator, model);
+
+    value::Map initValues;
+    buildInitValues(conditions, initValues);
+
+    try {
+        sim->addDynamics(attachDynamics(coordinator, sim, dyn, initValues));
+    } catch(const std::exception& /*e*/) {
+        initValues.value().clear();
+        throw;
+    }
+
+    initValues.value().clear();
+
+    attachObservables(coordinator, sim, observable);
 
     InternalEvent* evt = sim->init(coordinator.getCurrentTime());
     if (evt) {
@@ -172,6 +439,172 @@ void ModelFactory::createModel(Coordinator& coordinator,
     }
 }
 
+/**
+ * Check if the values of two conditions are different.
+ */
+static bool isModified(const vpz::Condition& current,
+                       const vpz::Condition& branch)
+{
+    const vpz::ConditionValues& lhs(current.conditionvalues());
+    const vpz::ConditionValues& rhs(branch.conditionvalues());
+
+    if (lhs.size() != rhs.size()) {
+        return true;
+    }
+
+    for (vpz::ConditionValues::const_iterator it = lhs.begin(),
+             jt = rhs.begin(); it != lhs.end(); ++it, ++jt) {
+        if (it->first != jt->first or not it->second != not jt->second or
+            (it->second and
+             it->second->writeToXml() != jt->second->writeToXml())) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ModelFactory::branch(Coordinator& coordinator,
+                          const Time& time,
+                          const vpz::Conditions& conditions)
+{
+    vpz::Conditions& conds(mExperiment->conditions());
+    std::set < std::string > modified;
+
+    for (vpz::ConditionList::const_iterator it =
+             conditions.conditionlist().begin();
+         it != conditions.conditionlist().end(); ++it) {
+        if (not conds.exist(it->first) or
+            isModified(conds.get(it->first), it->second)) {
+            conds.conditionlist().erase(it->first);
+            conds.add(it->second);
+            modified.insert(it->first);
+        }
+    }
+
+    if (modified.empty()) {
+        return;
+    }
+
+    const SimulatorMap& simulators(coordinator.modellist());
+
+    for (SimulatorMap::const_iterator it = simulators.begin();
+         it != simulators.end(); ++it) {
+        const std::vector < std::string >& names(it->first->conditions());
+        bool found = false;
+
+        for (std::vector < std::string >::const_iterator jt = names.begin();
+             not found and jt != names.end(); ++jt) {
+            found = modified.count(*jt);
+        }
+
+        if (not found) {
+            continue;
+        }
+
+        value::Map initValues;
+        bool applied;
+
+        try {
+            buildInitValues(names, initValues);
+            applied = it->second->branch(time, initValues);
+        } catch (...) {
+            initValues.value().clear();
+            throw;
+        }
+
+        initValues.value().clear();
+
+        if (not applied) {
+            throw utils::ModellingError(fmt(_(
+                        "The model '%1%' does not support the branching of"
+                        " its conditions")) % it->second->getName());
+        }
+    }
+}
+
+void ModelFactory::reset(Coordinator& coordinator,
+                         vpz::BaseModel* model,
+                         const vpz::Conditions& conditions)
+{
+    /*
+     * An executive can have modified the structure of the models during
+     * the previous simulation: the models are rebuilt.
+     */
+    const SimulatorMap& simulators(coordinator.modellist());
+
+    for (SimulatorMap::const_iterator it = simulators.begin();
+         it != simulators.end(); ++it) {
+        if (it->second->dynamics()->isExecutive()) {
+            throw utils::ModellingError(fmt(_(
+                        "The executive model '%1%' can not be reset")) %
+                it->second->getName());
+        }
+    }
+
+    vpz::Conditions& conds(mExperiment->conditions());
+
+    for (vpz::ConditionList::const_iterator it =
+             conditions.conditionlist().begin();
+         it != conditions.conditionlist().end(); ++it) {
+        conds.conditionlist().erase(it->first);
+        conds.add(it->second);
+    }
+
+    vpz::AtomicModelVector atomicmodellist;
+
+    if (model) {
+        if (model->isAtomic()) {
+            atomicmodellist.push_back((vpz::AtomicModel*)model);
+        } else {
+            vpz::BaseModel::getAtomicModelList(model, atomicmodellist);
+        }
+    }
+
+    /*
+     * The models are reset and initialized in the order of the atomic
+     * models, like the construction, to push the internal events in the
+     * same order.
+     */
+    for (vpz::AtomicModelVector::iterator it = atomicmodellist.begin();
+         it != atomicmodellist.end(); ++it) {
+        Simulator* sim = coordinator.getModel(*it);
+
+        if (not sim) {
+            throw utils::InternalError(fmt(_(
+                        "The simulator of the model '%1%' does not exist")) %
+                (*it)->getName());
+        }
+
+        value::Map initValues;
+        bool applied;
+
+        try {
+            buildInitValues((*it)->conditions(), initValues);
+            applied = sim->reset(initValues, mRoot.seed(**it),
+                                 mRoot.antithetic());
+        } catch (...) {
+            initValues.value().clear();
+            throw;
+        }
+
+        initValues.value().clear();
+
+        if (not applied) {
+            throw utils::ModellingError(fmt(_(
+                        "The model '%1%' can not be reset")) %
+                sim->getName());
+        }
+
+        attachObservables(coordinator, sim, (*it)->observables());
+
+        InternalEvent* evt = sim->init(coordinator.getCurrentTime());
+        if (evt) {
+            coordinator.eventtable().putInternalEvent(evt);
+        }
+    }
+}
+
 void ModelFactory::createModels(Coordinator& coordinator,
                                 const vpz::Model& model)
 {
@@ -185,119 +618,198 @@ void ModelFactory::createModels(Coordinator& coordinator,
             vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
         }
 
-        for (vpz::AtomicModelVector::iterator it = atomicmodellist.begin();
-             it != atomicmodellist.end(); ++it) {
-            createModel(coordinator,
-                        *it,
-                        (*it)->dynamics(),
-                        (*it)->conditions(),
-                        (*it)->observables());
+        if (mRoot.modelThreads() > 1 and atomicmodellist.size() > 1) {
+            createModelsInParallel(coordinator, atomicmodellist);
+        } else {
+            for (vpz::AtomicModelVector::iterator it =
+                 atomicmodellist.begin(); it != atomicmodellist.end(); ++it) {
+                createModel(coordinator,
+                            *it,
+                            (*it)->dynamics(),
+                            (*it)->conditions(),
+                            (*it)->observables());
+            }
         }
     }
 }
 
-vpz::BaseModel* ModelFactory::createModelFromClass(Coordinator& coordinator,
-                                                 vpz::CoupledModel* parent,
-                                                 const std::string& classname,
-                                                 const std::string& modelname)
+bool ModelFactory::hasExecutive(const vpz::Model& model)
 {
-    vpz::Class& classe(mClasses.get(classname));
-    vpz::BaseModel* mdl(classe.model()->clone());
     vpz::AtomicModelVector atomicmodellist;
-    vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
-    parent->addModel(mdl, modelname);
+    vpz::BaseModel* mdl = model.model();
+
+    if (mdl) {
+        if (mdl->isAtomic()) {
+            atomicmodellist.push_back((vpz::AtomicModel*)mdl);
+        } else {
+            vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
+        }
+    }
 
     for (vpz::AtomicModelVector::iterator it = atomicmodellist.begin();
          it != atomicmodellist.end(); ++it) {
-        createModel(coordinator,
-                    *it,
-                    (*it)->dynamics(),
-                    (*it)->conditions(),
-                    (*it)->observables());
+        const vpz::Dynamic& dyn(mDynamics->get((*it)->dynamics()));
+
+        if (getSymbol(dyn).type == utils::MODULE_DYNAMICS_EXECUTIVE) {
+            return true;
+        }
     }
 
-    return mdl;
+    return false;
 }
 
-static devs::Dynamics* buildNewDynamicsWrapper(
-    devs::Simulator* atom,
-    const vpz::Dynamic& dyn,
-    const InitEventList& events,
-    void* symbol)
+void ModelFactory::createModelsInParallel(
+    Coordinator& coordinator,
+    const vpz::AtomicModelVector& atomicmodellist)
 {
-    typedef Dynamics*(*fctdw)(const DynamicsWrapperInit&, const InitEventList&);
+    uint32_t threads = std::min(mRoot.modelThreads(),
+                                (uint32_t)atomicmodellist.size());
+    ModelBuildList builds(atomicmodellist.size());
+    std::string error;
+
+    /*
+     * The simulators, the initialization values and the symbols are built
+     * by the calling thread, the ModuleManager, the Coordinator and the
+     * conditions are not shared with the worker threads.
+     */
+    try {
+        for (ModelBuildList::size_type i = 0; i < builds.size(); ++i) {
+            vpz::AtomicModel* atom = atomicmodellist[i];
+            ModelBuild& build(builds[i]);
+
+            build.dyn = &mDynamics->get(atom->dynamics());
+            const Symbol& symbol(getSymbol(*build.dyn));
+            build.symbol = symbol.symbol;
+            build.type = symbol.type;
+            build.package = symbol.package;
+
+            if (build.type != utils::MODULE_DYNAMICS and
+                build.type != utils::MODULE_DYNAMICS_EXECUTIVE and
+                build.type != utils::MODULE_DYNAMICS_WRAPPER) {
+                throw utils::ModellingError();
+            }
 
-    fctdw fct = utils::functionCast < fctdw >(symbol);
+            build.events = new value::Map();
+            buildInitValues(atom->conditions(), *build.events);
+            build.seed = mRoot.seed(*atom);
+            build.antithetic = mRoot.antithetic();
+            build.sim = buildSimulator(coordinator, atom);
+        }
+    } catch (...) {
+        for (ModelBuildList::iterator it = builds.begin();
+             it != builds.end(); ++it) {
+            clearInitValues(it->events);
+        }
+        throw;
+    }
 
-    try {
-        utils::PackageTable pkg_table;
-        return fct(DynamicsWrapperInit(
-                *atom->getStructure(),
-                pkg_table.get(dyn.package()),
-                dyn.library()), events);
-    } catch(const std::exception& e) {
-        throw utils::ModellingError(
-            fmt(_("Atomic model wrapper `%1%:%2%' (from dynamics `%3%'"
-                  " library `%4%' package `%5%') throws error in"
-                  " constructor: `%6%'")) %
-            atom->getStructure()->getParentName() %
-            atom->getStructure()->getName() %
-            dyn.name() % dyn.library() % dyn.package() % e.what());
+    {
+        boost::thread_group gp;
+
+        for (uint32_t i = 0; i < threads; ++i) {
+            gp.create_thread(ModelBuildWorker(
+                    builds, ModelBuildWorker::CONSTRUCTOR,
+                    coordinator.getCurrentTime(), i, threads));
+        }
+
+        gp.join_all();
     }
-}
 
-static devs::Dynamics* buildNewDynamics(
-    devs::Simulator* atom,
-    const vpz::Dynamic& dyn,
-    const InitEventList& events,
-    void *symbol)
-{
-    typedef Dynamics*(*fctdyn)(const DynamicsInit&, const InitEventList&);
+    for (ModelBuildList::iterator it = builds.begin();
+         it != builds.end(); ++it) {
+        if (it->type == utils::MODULE_DYNAMICS_EXECUTIVE and error.empty()) {
+            try {
+                it->dynamics = buildNewExecutive(coordinator, it->sim,
+                                                 *it->dyn, *it->events,
+                                                 it->symbol, it->package,
+                                                 it->seed, it->antithetic);
+            } catch (const std::exception& e) {
+                it->error.assign(e.what());
+            }
+        }
 
-    fctdyn fct = utils::functionCast < fctdyn >(symbol);
+        clearInitValues(it->events);
+        it->events = 0;
 
-    try {
-        utils::PackageTable pkg_table;
-        return fct(DynamicsInit(
-                *atom->getStructure(),
-                pkg_table.get(dyn.package())),
-            events);
-    } catch(const std::exception& e) {
-        throw utils::ModellingError(
-            fmt(_("Atomic model `%1%:%2%' (from dynamics `%3%' library"
-                  " `%4%' package `%5%') throws error in constructor:"
-                  " `%6%'")) % atom->getStructure()->getParentName() %
-            atom->getStructure()->getName() % dyn.name() % dyn.library() %
-            dyn.package() % e.what());
+        if (it->dynamics) {
+            it->sim->addDynamics(it->dynamics);
+        }
+
+        if (error.empty()) {
+            error.swap(it->error);
+        }
+    }
+
+    if (not error.empty()) {
+        throw utils::ModellingError(error);
+    }
+
+    for (ModelBuildList::size_type i = 0; i < builds.size(); ++i) {
+        attachObservables(coordinator, builds[i].sim,
+                          atomicmodellist[i]->observables());
+    }
+
+    {
+        boost::thread_group gp;
+
+        for (uint32_t i = 0; i < threads; ++i) {
+            gp.create_thread(ModelBuildWorker(
+                    builds, ModelBuildWorker::INIT,
+                    coordinator.getCurrentTime(), i, threads));
+        }
+
+        gp.join_all();
+    }
+
+    /*
+     * The internal events are pushed into the event table in the order of
+     * the atomic models, like the sequential construction.
+     */
+    for (ModelBuildList::iterator it = builds.begin();
+         it != builds.end(); ++it) {
+        if (it->type == utils::MODULE_DYNAMICS_EXECUTIVE and error.empty()) {
+            try {
+                it->event = it->sim->init(coordinator.getCurrentTime());
+            } catch (const std::exception& e) {
+                it->error.assign(e.what());
+            }
+        }
+
+        if (it->event) {
+            coordinator.eventtable().putInternalEvent(it->event);
+        }
+
+        if (error.empty()) {
+            error.swap(it->error);
+        }
+    }
+
+    if (not error.empty()) {
+        throw utils::ModellingError(error);
     }
 }
 
-static devs::Dynamics* buildNewExecutive(
-    Coordinator& coordinator,
-    devs::Simulator* atom,
-    const vpz::Dynamic& dyn,
-    const InitEventList& events,
-    void *symbol)
+vpz::BaseModel* ModelFactory::createModelFromClass(Coordinator& coordinator,
+                                                 vpz::CoupledModel* parent,
+                                                 const std::string& classname,
+                                                 const std::string& modelname)
 {
-    typedef Dynamics*(*fctexe)(const ExecutiveInit&, const InitEventList&);
-
-    fctexe fct = utils::functionCast < fctexe >(symbol);
+    const vpz::Class& classe(mClasses->get(classname));
+    vpz::BaseModel* mdl(classe.model()->clone());
+    vpz::AtomicModelVector atomicmodellist;
+    vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
+    parent->addModel(mdl, modelname);
 
-    try {
-        utils::PackageTable pkg_table;
-        return fct(ExecutiveInit(
-                *atom->getStructure(),
-                pkg_table.get(dyn.package()),
-                coordinator), events);
-    } catch(const std::exception& e) {
-        throw utils::ModellingError(
-            fmt(_("Executive model `%1%:%2%' (from dynamics `%3%'"
-                  " library `%4%' package `%5%') throws error in"
-                  " constructor: `%6%'")) %
-            atom->getStructure()->getParentName() %
-            atom->getStructure()->getName() % dyn.name() % dyn.library() %
-            dyn.package() % e.what());
+    for (vpz::AtomicModelVector::iterator it = atomicmodellist.begin();
+         it != atomicmodellist.end(); ++it) {
+        createModel(coordinator,
+                    *it,
+                    (*it)->dynamics(),
+                    (*it)->conditions(),
+                    (*it)->observables());
     }
+
+    return mdl;
 }
 
 devs::Dynamics* ModelFactory::attachDynamics(Coordinator& coordinator,
@@ -305,27 +817,21 @@ devs::Dynamics* ModelFactory::attachDynamics(Coordinator& coordinator,
                                              const vpz::Dynamic& dyn,
                                              const InitEventList& events)
 {
-    void *symbol = NULL;
-    utils::ModuleType type = utils::MODULE_DYNAMICS;
-
-    try {
-        symbol = mModuleMgr.get(dyn.package(), dyn.library(),
-                                utils::MODULE_DYNAMICS, &type);
-    } catch (const std::exception& e) {
-        throw utils::ModellingError(fmt(
-                _("Dynamic library loading problem: cannot get any"
-                  " dynamics, executive or wrapper '%1%' in library"
-                  " '%2%' package '%3%'\n:%4%")) % dyn.name() %
-            dyn.library() % dyn.package() % e.what());
-    }
+    const Symbol& symbol(getSymbol(dyn));
+    uint32_t seed = mRoot.seed(*atom->getStructure());
 
-    switch (type) {
+    switch (symbol.type) {
     case utils::MODULE_DYNAMICS:
-        return buildNewDynamics(atom, dyn, events, symbol);
+        return buildNewDynamics(atom, dyn, events, symbol.symbol,
+                                symbol.package, seed, mRoot.antithetic());
     case utils::MODULE_DYNAMICS_EXECUTIVE:
-        return buildNewExecutive(coordinator, atom, dyn, events, symbol);
+        return buildNewExecutive(coordinator, atom, dyn, events,
+                                 symbol.symbol, symbol.package, seed,
+                                 mRoot.antithetic());
     case utils::MODULE_DYNAMICS_WRAPPER:
-        return buildNewDynamicsWrapper(atom, dyn, events, symbol);
+        return buildNewDynamicsWrapper(atom, dyn, events, symbol.symbol,
+                                       symbol.package, seed,
+                                       mRoot.antithetic());
     default:
         throw utils::ModellingError();
     }
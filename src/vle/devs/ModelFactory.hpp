@@ -36,8 +36,11 @@
 #include <vle/vpz/Experiment.hpp>
 #include <vle/devs/InitEventList.hpp>
 #include <vle/devs/ExternalEventList.hpp>
+#include <vle/devs/Time.hpp>
 #include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/PackageTable.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
 
 namespace vle { namespace devs {
 
@@ -67,48 +70,67 @@ public:
                  const vpz::Experiment& experiment,
                  RootCoordinator& root);
 
+    /**
+     * @brief Build a new ModelFactory which shares the dynamics and the
+     * classes of a vpz::Project: they are not copied and must outlive the
+     * ModelFactory. The dynamics are copied only when an Executive adds
+     * a permanent vpz::Dynamic (see addPermanent).
+     *
+     * @param modulemgr the manager of the dynamics libraries.
+     * @param dyn the shared vpz::Dynamics.
+     * @param cls the shared vpz::Classes.
+     * @param experiment the experiment of the simulation, the
+     * ModelFactory takes the ownership.
+     * @param root the root coordinator of the simulation.
+     */
+    ModelFactory(const utils::ModuleManager& modulemgr,
+                 const vpz::Dynamics* dyn,
+                 const vpz::Classes* cls,
+                 vpz::Experiment* experiment,
+                 RootCoordinator& root);
+
     /**
      * @brief Return the reference to the list of initiale conditions for
      * each models.
      * @return A constant reference to the vpz::Conditions.
      */
     inline const vpz::Conditions& conditions() const
-    { return mExperiment.conditions(); }
+    { return mExperiment->conditions(); }
 
     /**
      * @brief Return the reference to the list of dynamcis.
      * @return A constant reference to the vpz::Dynamics.
      */
     inline const vpz::Dynamics& dynamics() const
-    { return mDynamics; }
+    { return *mDynamics; }
 
     /**
      * @brief Return the reference to the list of views.
      * @return A constant reference to the vpz::Views.
      */
     inline const vpz::Views& views() const
-    { return mExperiment.views(); }
+    { return mExperiment->views(); }
 
     /**
      * @brief Return the reference to the list of outputs.
      * @return A constant reference to the vpz::Outputs.
      */
     inline const vpz::Outputs& outputs() const
-    { return mExperiment.views().outputs(); }
+    { return mExperiment->views().outputs(); }
 
     /**
      * @brief Return the reference to the experiment object.
      * @return A constant reference to the vpz::Experiment.
      */
     inline const vpz::Experiment& experiment() const
-    { return mExperiment; }
+    { return *mExperiment; }
 
     /**
      * @brief Return the reference to the observables object.
      * @return A constant reference to the vpz::Observables.
      */
     inline const vpz::Observables& observables() const
-    { return mExperiment.views().observables(); }
+    { return mExperiment->views().observables(); }
 
     /**
      * @brief Return the reference to the list of initiale conditions for
@@ -116,42 +138,42 @@ public:
      * @return A reference to the vpz::Conditions.
      */
     inline vpz::Conditions& conditions()
-    { return mExperiment.conditions(); }
+    { return mExperiment->conditions(); }
 
     /**
-     * @brief Return the reference to the list of dynamcis.
-     * @return A constant reference to the vpz::Dynamics.
+     * @brief Return the reference to the list of dynamcis. The shared
+     * vpz::Dynamics are copied before the first modification.
+     * @return A reference to the vpz::Dynamics.
      */
-    inline vpz::Dynamics& dynamics()
-    { return mDynamics; }
+    vpz::Dynamics& dynamics();
 
     /**
      * @brief Return the reference to the list of views.
      * @return A reference to the vpz::Views.
      */
     inline vpz::Views& views()
-    { return mExperiment.views(); }
+    { return mExperiment->views(); }
 
     /**
      * @brief Return the reference to the list of outputs.
      * @return A reference to the vpz::Outputs.
      */
     inline vpz::Outputs& outputs()
-    { return mExperiment.views().outputs(); }
+    { return mExperiment->views().outputs(); }
 
     /**
      * @brief Return the reference to the experiment object.
      * @return A reference to the vpz::Experiment.
      */
     inline vpz::Experiment& experiment()
-    { return mExperiment; }
+    { return *mExperiment; }
 
     /**
      * @brief Return the reference to the observables object.
      * @return A constant reference to the vpz::Observables.
      */
     inline vpz::Observables& observables()
-    { return mExperiment.views().observables(); }
+    { return mExperiment->views().observables(); }
 
     //
     ///
@@ -207,12 +229,24 @@ public:
     /**
      * @brief Build a list of devs::Simulator from the dynamics library
      * corresponding to the atomic models from the specified graph
-     * hierarchy.
+     * hierarchy. If the RootCoordinator defines more than one model
+     * thread, the constructors and the init functions of the Dynamics are
+     * called in parallel, the Executive are built and initialized by the
+     * calling thread.
      * @param coordinator the coordinator where attach the simulator.
      * @param model the hierachy of model (coupled model) or atomic model.
      */
     void createModels(Coordinator& coordinator, const vpz::Model& vpmdl);
 
+    /**
+     * @brief Check if an atomic model of the graph hierarchy is an
+     * Executive, ie. if the simulation can modify the graph hierarchy.
+     * @param model the hierachy of model (coupled model) or atomic model.
+     * @return true if a dynamics library of the models is an Executive.
+     * @throw utils::ModellingError if a library cannot be loaded.
+     */
+    bool hasExecutive(const vpz::Model& model);
+
     /**
      * @brief Build a new devs::Simulator from the vpz::Classes information.
      * @param classname the name of the class to clone.
@@ -225,6 +259,33 @@ public:
                                        const std::string& classname,
                                        const std::string& modelname);
 
+    /**
+     * @brief Replace the conditions of the experiment with the conditions
+     * of a branch. The models which use a modified condition receive the
+     * new values of all their conditions (see Dynamics::branch).
+     * @param coordinator the coordinator of the models.
+     * @param time the time of the branching.
+     * @param conditions the conditions of the branch.
+     * @throw utils::ModellingError if a model does not support the
+     * branching.
+     */
+    void branch(Coordinator& coordinator, const Time& time,
+                const vpz::Conditions& conditions);
+
+    /**
+     * @brief Replace the conditions of the experiment and restore the
+     * state of all the models to restart the simulation (see
+     * Dynamics::reset). The models are initialized again at the current
+     * time of the coordinator.
+     * @param coordinator the coordinator of the models.
+     * @param model the hierarchy of models of the simulation.
+     * @param conditions the conditions to replace in the experiment.
+     * @throw utils::ModellingError if a model cannot be reset or if a
+     * model is an executive.
+     */
+    void reset(Coordinator& coordinator, vpz::BaseModel* model,
+               const vpz::Conditions& conditions);
+
 private:
     ModelFactory(const ModelFactory& other);
     ModelFactory& operator=(const ModelFactory& other);
@@ -232,12 +293,87 @@ private:
     const utils::ModuleManager& mModuleMgr; /**< A reference to the
                                               utils::ModuleManager. */
 
-    vpz::Dynamics           mDynamics; /**< List of available vpz::Dynamics. */
-    vpz::Classes            mClasses; /**< List of available vpz::Classes. */
-    vpz::Experiment         mExperiment; /**< A reference to the
-                                           vpz::Experiment. */
+    const vpz::Dynamics*    mDynamics; /**< List of available
+                                         vpz::Dynamics, shared or owned. */
+    const vpz::Classes*     mClasses; /**< List of available vpz::Classes,
+                                        shared or owned. */
+    boost::scoped_ptr < vpz::Dynamics > mOwnedDynamics; /**< The copy of the
+                                                          vpz::Dynamics. */
+    boost::scoped_ptr < vpz::Classes > mOwnedClasses; /**< The copy of the
+                                                        vpz::Classes. */
+    boost::scoped_ptr < vpz::Experiment > mExperiment; /**< The
+                                                         vpz::Experiment. */
     RootCoordinator&        mRoot;
 
+    /**
+     * @brief The symbol of a dynamics library resolved by the
+     * utils::ModuleManager and the identifier of its package.
+     */
+    struct Symbol
+    {
+        void*                       symbol;
+        utils::ModuleType           type;
+        utils::PackageTable::index  package;
+    };
+
+    /**
+     * @brief The cache of symbols, the key is the package and the library
+     * of the vpz::Dynamic.
+     */
+    typedef std::map < std::pair < std::string, std::string >,
+                       Symbol > SymbolList;
+
+    SymbolList              mSymbols; /**< The resolved symbols. */
+    utils::PackageTable     mPackages; /**< The packages of the Dynamics. */
+
+    /**
+     * @brief Get the symbol of the dynamics library from the cache or from
+     * the utils::ModuleManager.
+     * @param dyn the vpz::Dynamic to load.
+     * @return A reference to the symbol.
+     * @throw utils::ModellingError if the library cannot be loaded.
+     */
+    const Symbol& getSymbol(const vpz::Dynamic& dyn);
+
+    /**
+     * @brief Build a new devs::Simulator and attach it to the coordinator.
+     * @param coordinator the coordinator where attach the simulator.
+     * @param model the vpz::AtomicModel of the simulator.
+     * @throw utils::InternalError if the model already exists.
+     */
+    Simulator* buildSimulator(Coordinator& coordinator,
+                              vpz::AtomicModel* model);
+
+    /**
+     * @brief Fill the initialization values of a model with the first
+     * values of its conditions. The values are not cloned.
+     * @param conditions the names of the conditions.
+     * @param initValues the output parameter.
+     * @throw utils::InternalError if two conditions define the same port.
+     */
+    void buildInitValues(const std::vector < std::string >& conditions,
+                         value::Map& initValues);
+
+    /**
+     * @brief Attach the observable ports of a simulator to its views.
+     * @param coordinator the coordinator of the views.
+     * @param sim the simulator to observe.
+     * @param observable the name of the observable.
+     * @throw utils::InternalError if a view does not exist.
+     */
+    void attachObservables(Coordinator& coordinator, Simulator* sim,
+                           const std::string& observable);
+
+    /**
+     * @brief Build and initialize the simulators of a list of atomic
+     * models with the model threads of the RootCoordinator.
+     * @param coordinator the coordinator where attach the simulators.
+     * @param atomicmodellist the list of atomic models.
+     */
+    void createModelsInParallel(
+        Coordinator& coordinator,
+        const vpz::AtomicModelVector& atomicmodellist);
+
     /**
      * Try to open the plug-in and return the type of opened plugin
      * (MODULE_DYNAMICS, MODULE_DYNAMICS_WRAPPER or MODULE_EXECUTIVE).
@@ -27,6 +27,10 @@
 
 #include <vle/devs/RootCoordinator.hpp>
 #include <vle/devs/Coordinator.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/details/Tools.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 namespace vle { namespace devs {
 
@@ -61,27 +65,69 @@ static value::Map * getMatrixFromView(const ViewList &views)
     return result;
 }
 
+/**
+ * Hash a string with FNV-1a.
+ *
+ * @param str The string to hash.
+ *
+ * @return The hash of the string.
+ */
+static uint64_t hash(const std::string& str)
+{
+    uint64_t result = 0xcbf29ce484222325ULL;
+
+    for (std::string::size_type i = 0; i < str.size(); ++i) {
+        result ^= static_cast < unsigned char >(str[i]);
+        result *= 0x100000001b3ULL;
+    }
+
+    return result;
+}
+
+/**
+ * Get the wall-clock time.
+ *
+ * @return The number of seconds since the epoch.
+ */
+static double wallclock()
+{
+    static const boost::posix_time::ptime epoch(
+        boost::gregorian::date(1970, 1, 1));
+
+    return (boost::posix_time::microsec_clock::universal_time() - epoch)
+        .total_microseconds() / 1e6;
+}
+
                        /* - - - - - - - - - -*/
 
 RootCoordinator::RootCoordinator(const utils::ModuleManager& modulemgr)
-    : m_rand(0), m_begin(0), m_currentTime(0), m_end(1.0), m_result(0),
-      m_coordinator(0), m_root(0), m_modulemgr(modulemgr)
+    : m_rand(0), m_seed(0), m_antithetic(false), m_begin(0),
+      m_currentTime(0), m_end(1.0), m_result(0), m_coordinator(0),
+      m_root(0), m_shared(false), m_closed(false), m_modelThreads(1),
+      m_walltime(0.0), m_maxBags(0), m_maxStall(0), m_start(0.0), m_bags(0),
+      m_stall(0), m_previous(0), m_modulemgr(modulemgr)
 {
 }
 
 RootCoordinator::~RootCoordinator()
 {
     delete m_coordinator;
-    delete m_root;
+    if (not m_shared) {
+        delete m_root;
+    }
 }
 
 void RootCoordinator::load(const vpz::Vpz& io)
 {
     if (m_coordinator) {
         delete m_coordinator;
-        delete m_root;
+        if (not m_shared) {
+            delete m_root;
+        }
     }
 
+    m_closed = false;
+    m_shared = false;
     m_begin = io.project().experiment().begin();
     m_end = m_begin + io.project().experiment().duration();
     m_currentTime = m_begin;
@@ -97,40 +143,231 @@ void RootCoordinator::load(const vpz::Vpz& io)
     m_root = io.project().model().model();
 }
 
+void RootCoordinator::load(const vpz::Vpz& io,
+                           const vpz::Conditions& conditions,
+                           const std::string& name)
+{
+    if (m_coordinator) {
+        delete m_coordinator;
+        if (not m_shared) {
+            delete m_root;
+        }
+        m_coordinator = 0;
+        m_root = 0;
+    }
+
+    m_closed = false;
+    m_shared = false;
+
+    vpz::Experiment* experiment = new vpz::Experiment(
+        io.project().experiment());
+
+    try {
+        experiment->setName(name);
+
+        for (vpz::ConditionList::const_iterator it =
+                 conditions.conditionlist().begin();
+             it != conditions.conditionlist().end(); ++it) {
+            experiment->conditions().conditionlist().erase(it->first);
+            experiment->conditions().add(it->second);
+        }
+    } catch (...) {
+        delete experiment;
+        throw;
+    }
+
+    m_begin = experiment->begin();
+    m_end = m_begin + experiment->duration();
+    m_currentTime = m_begin;
+
+    m_coordinator = new Coordinator(m_modulemgr,
+                                    &io.project().dynamics(),
+                                    &io.project().classes(),
+                                    experiment,
+                                    *this);
+
+    /*
+     * Only the Executive modify the hierarchy of models during the
+     * simulation: without Executive, the hierarchy of the vpz::Vpz is
+     * shared, otherwise it is cloned.
+     */
+    const vpz::Model& shared(io.project().model());
+
+    if (m_coordinator->hasExecutive(shared)) {
+        vpz::Model model(shared);
+        m_root = model.model();
+        m_coordinator->init(model, m_currentTime, m_end);
+    } else {
+        m_root = shared.model();
+        m_shared = true;
+        m_coordinator->init(shared, m_currentTime, m_end);
+    }
+}
+
 void RootCoordinator::init()
 {
     m_currentTime = m_begin;
+    startBudget();
 }
 
 bool RootCoordinator::run()
 {
+    if (not m_coordinator->terminated().empty()) {
+        return false;
+    }
+
     m_currentTime = m_coordinator->getNextTime();
 
     if (isInfinity(m_currentTime)) {
         return false;
     } else if ((m_end - m_currentTime) < 0) {
         return false;
+    } else if (exhausted()) {
+        return false;
+    }
+
+    m_coordinator->run();
+    return true;
+}
+
+void RootCoordinator::setBudget(double walltime, uint64_t bags,
+                                uint64_t stall)
+{
+    m_walltime = walltime;
+    m_maxBags = bags;
+    m_maxStall = stall;
+    startBudget();
+}
+
+void RootCoordinator::startBudget()
+{
+    m_start = (m_walltime > 0.0) ? wallclock() : 0.0;
+    m_bags = 0;
+    m_stall = 0;
+    m_previous = m_currentTime;
+    m_interrupted.clear();
+}
+
+bool RootCoordinator::exhausted()
+{
+    if (not m_interrupted.empty()) {
+        return true;
+    }
+
+    ++m_bags;
+
+    if (m_currentTime == m_previous) {
+        ++m_stall;
+    } else {
+        m_stall = 0;
+        m_previous = m_currentTime;
+    }
+
+    if (m_maxBags and m_bags > m_maxBags) {
+        m_interrupted = (fmt(_("the limit of %1% bags is reached at time"
+                               " %2%")) % m_maxBags % m_currentTime).str();
+    } else if (m_maxStall and m_stall > m_maxStall) {
+        m_interrupted = (fmt(_("the time %1% does not progress after %2%"
+                               " bags")) % m_currentTime % m_maxStall).str();
+    } else if (m_walltime > 0.0 and (m_bags & 255) == 0 and
+               wallclock() - m_start > m_walltime) {
+        m_interrupted = (fmt(_("the limit of %1% s is reached at time"
+                               " %2%")) % m_walltime % m_currentTime).str();
+    }
+
+    return not m_interrupted.empty();
+}
+
+bool RootCoordinator::run(const Time& time)
+{
+    const Time& next(m_coordinator->getNextTime());
+
+    if (isInfinity(next) or (m_end - next) < 0 or next > time or
+        not m_coordinator->terminated().empty()) {
+        return false;
     }
 
+    m_currentTime = next;
     m_coordinator->run();
     return true;
 }
 
+void RootCoordinator::setSeed(uint32_t seed, bool antithetic)
+{
+    m_seed = seed;
+    m_antithetic = antithetic;
+    m_rand.seed(seed);
+    m_rand.setAntithetic(antithetic);
+}
+
+uint32_t RootCoordinator::seed(const vpz::AtomicModel& model) const
+{
+    uint64_t x = utils::mix(hash(model.getCompleteName()));
+
+    return static_cast < uint32_t >(
+        utils::mix(x ^ (static_cast < uint64_t >(m_seed) << 32)) >> 32);
+}
+
+const std::string& RootCoordinator::terminated() const
+{
+    static const std::string empty;
+
+    return m_coordinator ? m_coordinator->terminated() : empty;
+}
+
+void RootCoordinator::branch(const Time& time,
+                             const vpz::Conditions& conditions)
+{
+    m_coordinator->branch(time, conditions);
+}
+
+void RootCoordinator::close()
+{
+    if (m_coordinator and not m_closed) {
+        m_coordinator->finish();
+        m_closed = true;
+
+        if (!m_result)
+            m_result = getMatrixFromView(m_coordinator->getViews());
+    }
+}
+
+void RootCoordinator::reset(const vpz::Conditions& conditions,
+                            const std::string& name)
+{
+    if (not m_coordinator or not m_closed) {
+        throw utils::InternalError(
+            _("RootCoordinator: the simulation must be closed before the"
+              " reset"));
+    }
+
+    m_result = 0;
+    m_currentTime = m_begin;
+
+    m_coordinator->reset(m_begin, m_root, conditions, name);
+    m_closed = false;
+}
+
 void RootCoordinator::finish()
 {
     if (m_coordinator) {
-        m_coordinator->finish();
+        if (not m_closed)
+            m_coordinator->finish();
 
         if (!m_result)
             m_result = getMatrixFromView(m_coordinator->getViews());
 
         delete m_coordinator;
         m_coordinator = 0;
+        m_closed = false;
     }
 
     if (m_root) {
-        delete m_root;
+        if (not m_shared) {
+            delete m_root;
+        }
         m_root = 0;
+        m_shared = false;
     }
 }
 
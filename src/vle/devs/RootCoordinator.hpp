@@ -33,6 +33,7 @@
 #include <vle/devs/Time.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/Types.hpp>
 
 namespace vle { namespace vpz {
 
@@ -74,6 +75,24 @@ namespace vle { namespace devs {
          */
         void load(const vpz::Vpz& vp);
 
+        /**
+         * @brief initialiase a new Coordinator with the specified vpz::Vpz
+         * reference, a set of conditions and the name of the experiment.
+         * The vpz::Vpz is not modified and can be shared by several
+         * RootCoordinator: the dynamics, the classes and the model
+         * hierarchy are shared (the hierarchy is cloned only if an
+         * Executive can modify it) and the conditions overlay the
+         * conditions of a copy of the experiment (the values are shared,
+         * not cloned). The vpz::Vpz must outlive the simulation, until the
+         * finish function or the next load.
+         * @param vp a reference to a structure.
+         * @param conditions the conditions to replace or to add in the
+         * experiment.
+         * @param name the name of the experiment.
+         */
+        void load(const vpz::Vpz& vp, const vpz::Conditions& conditions,
+                  const std::string& name);
+
         /**
          * @brief Initialise RootCoordinator and his Coordinator: initiale time
          * is define, coordinator init function is call.
@@ -83,16 +102,76 @@ namespace vle { namespace devs {
         /**
          * @brief Call the coordinator run function and test if current time is
          * the end of the simulation.
-         * @return false when simulation is finished, true otherwise.
+         * @return false when simulation is finished, ended by a
+         * devs::Termination or interrupted by its budget, true otherwise.
          */
         bool run();
 
+        /**
+         * @brief Run the next bag of events if it occurs before a time.
+         * @param time the time limit.
+         * @return false if the simulation is ended or if the next bag
+         * occurs after the time limit.
+         */
+        bool run(const Time& time);
+
+        /**
+         * @brief Apply the conditions of a branch to the models of the
+         * simulation (see Dynamics::branch). The simulation continues
+         * with the next call to the run function.
+         * @param time the time of the branching.
+         * @param conditions the conditions of the branch.
+         * @throw utils::ModellingError if a model does not support the
+         * branching.
+         */
+        void branch(const Time& time, const vpz::Conditions& conditions);
+
         /**
          * @brief Call the coordinator finish function and delete the
          * coordinator and all attached data.
          */
         void finish();
 
+        /**
+         * @brief Call the coordinator finish function like the finish
+         * function but keep the models to restart the simulation with the
+         * reset function. The results are available with the outputs
+         * function.
+         */
+        void close();
+
+        /**
+         * @brief Restart a closed simulation from its beginning without
+         * rebuilding the models: the models restore their state (see
+         * Dynamics::reset) and are initialized again. The results of the
+         * previous simulation must be got with the outputs function
+         * before the reset. The random generator is not seeded again, the
+         * random streams of the models are seeded from the seed of the
+         * setSeed function.
+         *
+         * @code
+         * root.load(vpz, conditions, "exp-0");
+         * root.init();
+         * while (root.run()) {}
+         * root.close();
+         * value::Map *first = root.outputs();
+         *
+         * root.reset(others, "exp-1");
+         * root.init();
+         * while (root.run()) {}
+         * root.finish();
+         * value::Map *second = root.outputs();
+         * @endcode
+         *
+         * @param conditions the conditions to replace in the experiment.
+         * @param name the name of the experiment.
+         * @throw utils::InternalError if the simulation is not closed.
+         * @throw utils::ModellingError if a model cannot be reset, the
+         * RootCoordinator can only be finished.
+         */
+        void reset(const vpz::Conditions& conditions,
+                   const std::string& name);
+
         /**
          * @brief Return the current time of the simulation.
          * @return A constant reference to the current time.
@@ -120,11 +199,84 @@ namespace vle { namespace devs {
          */
         utils::Rand& rand() { return m_rand; }
 
+        /**
+         * @brief Assign the seed of the simulation: the random generator
+         * is seeded and the random streams of the models built or reset
+         * after this call are seeded from this seed and their complete
+         * name (see Dynamics::rand). With the same seed, the simulations
+         * of different scenarios draw the same numbers for the same model
+         * (common random numbers), whatever the other models. The seed is
+         * 0 by default.
+         * @param seed the seed of the simulation.
+         * @param antithetic true to complement the numbers of the
+         * generator and of the streams (see utils::Rand::setAntithetic):
+         * the antithetic replicate of a simulation with the same seed.
+         */
+        void setSeed(uint32_t seed, bool antithetic = false);
+
+        /**
+         * @brief Compute the seed of the random stream of a model from the
+         * seed of the simulation and the complete name of the model.
+         * @param model the atomic model.
+         * @return the seed of the random stream of the model.
+         */
+        uint32_t seed(const vpz::AtomicModel& model) const;
+
+        /**
+         * @brief Check if the random streams are antithetic.
+         * @return true if the numbers are complemented.
+         */
+        bool antithetic() const { return m_antithetic; }
+
+        /**
+         * @brief Assign the number of threads used to build and initialize
+         * the atomic models of the vpz::Model in the next call to load.
+         * With 0 or 1 thread, the models are built one at a time. The
+         * constructors and the init functions of the Dynamics (not the
+         * Executive) must be thread-safe to use more threads.
+         * @param threads the number of threads.
+         */
+        void setModelThreads(uint32_t threads) { m_modelThreads = threads; }
+
+        /**
+         * @brief Get the number of threads used to build the atomic models.
+         * @return The number of threads.
+         */
+        uint32_t modelThreads() const { return m_modelThreads; }
+
+        /**
+         * @brief Assign the budget of the simulation: the run function
+         * interrupts the simulation when a limit is reached. The budget
+         * starts with this call and with each call to the init function.
+         * A limit of zero is no limit.
+         * @param walltime the maximum wall-clock time in seconds (checked
+         * every 256 bags).
+         * @param bags the maximum number of bags of events.
+         * @param stall the maximum number of successive bags at the same
+         * time, to interrupt the simulations which do not progress.
+         */
+        void setBudget(double walltime, uint64_t bags, uint64_t stall);
+
+        /**
+         * @brief Check if the simulation is interrupted by its budget.
+         * @return The description of the limit reached or an empty string.
+         */
+        const std::string& interrupted() const { return m_interrupted; }
+
+        /**
+         * @brief Check if the simulation is ended before the end of the
+         * experiment (see devs::Termination).
+         * @return The description of the reason or an empty string.
+         */
+        const std::string& terminated() const;
+
     private:
         RootCoordinator(const RootCoordinator& other);
         RootCoordinator& operator=(const RootCoordinator& other);
 
         utils::Rand         m_rand;
+        uint32_t            m_seed;
+        bool                m_antithetic;
 
         /** @brief Store the beginning of the simulation. */
         devs::Time          m_begin;
@@ -141,6 +293,29 @@ namespace vle { namespace devs {
         Coordinator*        m_coordinator;
         vpz::BaseModel*     m_root;
 
+        /** @brief The m_root belongs to a shared vpz::Vpz. */
+        bool                m_shared;
+
+        /** @brief The coordinator is finished by the close function. */
+        bool                m_closed;
+
+        /** @brief Number of threads used to build the atomic models. */
+        uint32_t            m_modelThreads;
+
+        /** @brief The budget of the simulation (see setBudget). */
+        double              m_walltime;
+        uint64_t            m_maxBags;
+        uint64_t            m_maxStall;
+
+        /** @brief The consumption of the budget. */
+        double              m_start;
+        uint64_t            m_bags;
+        uint64_t            m_stall;
+        devs::Time          m_previous;
+        std::string         m_interrupted;
+
+        void startBudget();
+        bool exhausted();
 
         const utils::ModuleManager& m_modulemgr;
     };
@@ -223,4 +223,22 @@ value::Value* Simulator::observation(const ObservationEvent& event) const
     return m_dynamics->observation(event);
 }
 
+bool Simulator::branch(const Time& time, const InitEventList& events)
+{
+    return m_dynamics->branch(time, events);
+}
+
+bool Simulator::reset(const InitEventList& events, uint32_t seed,
+                      bool antithetic)
+{
+    m_dynamics->seed(seed, antithetic);
+
+    return m_dynamics->reset(events);
+}
+
+bool Simulator::terminate(const Time& time) const
+{
+    return m_dynamics->terminate(time);
+}
+
 }} // namespace vle devs
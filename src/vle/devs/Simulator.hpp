@@ -174,6 +174,32 @@ namespace vle { namespace devs {
 
         value::Value* observation(const ObservationEvent& event) const;
 
+        /**
+         * @brief Call the branch function of the Dynamics plugin.
+         * @param time the time of the branching.
+         * @param events the values of the conditions of the model.
+         * @return true if the Dynamics plugin applies the new values.
+         */
+        bool branch(const Time& time, const InitEventList& events);
+
+        /**
+         * @brief Seed the random stream of the Dynamics plugin again and
+         * call its reset function.
+         * @param events the values of the conditions of the model.
+         * @param seed the seed of the random stream of the model.
+         * @param antithetic true if the random stream is antithetic.
+         * @return true if the Dynamics plugin restores its state.
+         */
+        bool reset(const InitEventList& events, uint32_t seed,
+                   bool antithetic);
+
+        /**
+         * @brief Call the terminate function of the Dynamics plugin.
+         * @param time the time of the transition or the observation.
+         * @return true if the Dynamics plugin ends the simulation.
+         */
+        bool terminate(const Time& time) const;
+
     private:
         TargetSimulatorList mTargets;
         Dynamics*           m_dynamics;
@@ -27,14 +27,225 @@
 
 #include <vle/devs/StreamWriter.hpp>
 #include <vle/devs/Simulator.hpp>
-#include <vle/oov/Plugin.hpp>
+#include <vle/oov/RowPlugin.hpp>
 #include <vle/oov/CairoPlugin.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Algo.hpp>
 #include <vle/version.hpp>
+#include <boost/checked_delete.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <deque>
 
 namespace vle { namespace devs {
 
+/**
+ * @brief An observation message stored in the queue of the asynchronous
+ * mode. The record owns the values of the row.
+ */
+struct StreamRecord
+{
+    enum Type { NEW_OBSERVABLE, REMOVE_OBSERVABLE, ROW };
+
+    StreamRecord(Type type, const devs::Time& time)
+        : type(type), id(0), time(time)
+    {}
+
+    ~StreamRecord()
+    {
+        std::for_each(row.begin(), row.end(),
+                      boost::checked_deleter < value::Value >());
+    }
+
+    Type                type;
+    oov::ObservableId   id;
+    std::string         simulator;
+    std::string         parent;
+    std::string         port;
+    std::string         view;
+    devs::Time          time;
+    oov::ObservationRow row;
+    std::vector < oov::ObservableId > order;
+};
+
+/**
+ * @brief The writer thread of a StreamWriter. The records are read from a
+ * bounded FIFO queue, so the simulation thread waits when the plug-in is
+ * too slow. If the plug-in throws an exception, the next records are
+ * dropped and the error is reported to the simulation thread by the next
+ * push or flush.
+ */
+class StreamWriter::Worker
+{
+public:
+    Worker(StreamWriter& writer, std::size_t capacity)
+        : m_writer(writer), m_capacity(capacity), m_busy(false),
+        m_stop(false), m_failed(false)
+    {
+        m_thread = boost::thread(boost::bind(&Worker::run, this));
+    }
+
+    ~Worker()
+    {
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_stop = true;
+            std::for_each(m_queue.begin(), m_queue.end(),
+                          boost::checked_deleter < StreamRecord >());
+            m_queue.clear();
+            m_notEmpty.notify_one();
+        }
+
+        m_thread.join();
+    }
+
+    /**
+     * @brief Push a record at the end of the queue and take its
+     * ownership. Wait while the queue is full.
+     * @param record the record to send to the plug-in.
+     * @throw utils::InternalError if the plug-in failed.
+     */
+    void push(StreamRecord* record)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        while (m_queue.size() >= m_capacity and not m_failed) {
+            m_notFull.wait(lock);
+        }
+
+        if (m_failed) {
+            delete record;
+            throw utils::InternalError(m_error);
+        }
+
+        m_queue.push_back(record);
+        m_notEmpty.notify_one();
+    }
+
+    /**
+     * @brief Wait until the queue is empty and the last record is sent to
+     * the plug-in.
+     * @throw utils::InternalError if the plug-in failed.
+     */
+    void flush()
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        while ((not m_queue.empty() or m_busy) and not m_failed) {
+            m_notFull.wait(lock);
+        }
+
+        if (m_failed) {
+            throw utils::InternalError(m_error);
+        }
+    }
+
+private:
+    void run()
+    {
+        for (;;) {
+            StreamRecord* record;
+            bool active;
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+
+                while (m_queue.empty() and not m_stop) {
+                    m_notEmpty.wait(lock);
+                }
+
+                if (m_queue.empty()) {
+                    return;
+                }
+
+                record = m_queue.front();
+                m_queue.pop_front();
+                active = not m_failed;
+                m_busy = true;
+                m_notFull.notify_all();
+            }
+
+            std::string error;
+            bool failed = false;
+
+            if (active) {
+                try {
+                    write(*record);
+                } catch (const std::exception& e) {
+                    failed = true;
+                    error.assign(e.what());
+                } catch (...) {
+                    failed = true;
+                    error.assign(_("Oov: unknown error in the output"
+                                   " plug-in"));
+                }
+            }
+
+            delete record;
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+
+                if (failed) {
+                    m_failed = true;
+                    m_error.swap(error);
+                }
+
+                m_busy = false;
+                m_notFull.notify_all();
+            }
+        }
+    }
+
+    void write(StreamRecord& record)
+    {
+        switch (record.type) {
+        case StreamRecord::NEW_OBSERVABLE:
+            m_writer.writeNewObservable(record.id, record.simulator,
+                                        record.parent, record.port,
+                                        record.view, record.time);
+            break;
+        case StreamRecord::REMOVE_OBSERVABLE:
+            m_writer.writeRemoveObservable(record.id, record.time);
+            break;
+        case StreamRecord::ROW:
+            m_writer.writeRow(record.time, record.view, record.row,
+                              record.order);
+            break;
+        }
+    }
+
+    StreamWriter&                m_writer;
+    std::size_t                  m_capacity;
+    std::deque < StreamRecord* > m_queue;
+    bool                         m_busy;
+    bool                         m_stop;
+    bool                         m_failed;
+    std::string                  m_error;
+    boost::mutex                 m_mutex;
+    boost::condition_variable    m_notEmpty;
+    boost::condition_variable    m_notFull;
+    boost::thread                m_thread;
+};
+
+/**
+ * @brief The number of records stored in the queue of the asynchronous
+ * mode before the simulation waits for the writer thread.
+ */
+static const std::size_t STREAM_WRITER_QUEUE_CAPACITY = 1024;
+
+StreamWriter::~StreamWriter()
+{
+    delete m_worker;
+
+    std::for_each(m_row.begin(), m_row.end(),
+                  boost::checked_deleter < value::Value >());
+}
+
+
 oov::PluginPtr StreamWriter::plugin()
 {
     if (not m_plugin) {
@@ -51,92 +262,258 @@ void StreamWriter::open(const std::string& pluginname,
                         const std::string& location,
                         const std::string& file,
                         value::Value* parameters,
-                        const devs::Time& time)
+                        const devs::Time& time,
+                        bool asynchronous)
 {
     void *symbol = 0;
+    oov::PluginPtr ptr;
 
     try {
         symbol = m_modulemgr.get(package, pluginname, utils::MODULE_OOV);
         oov::OovPluginSlot fct(utils::functionCast < oov::OovPluginSlot>(symbol));
-        oov::PluginPtr ptr(fct(location));
-        m_plugin = ptr;
+        ptr.reset(fct(location));
     } catch(const std::exception& e) {
         throw utils::InternalError(
             fmt(_("Oov: Can not open the plug-in `%1%': %2%")) % pluginname %
             e.what());
     }
 
+    open(ptr, pluginname, location, file, parameters, time, asynchronous);
+}
+
+void StreamWriter::open(const oov::PluginPtr& plugin,
+                        const std::string& pluginname,
+                        const std::string& location,
+                        const std::string& file,
+                        value::Value* parameters,
+                        const devs::Time& time,
+                        bool asynchronous)
+{
+    m_plugin = plugin;
+    m_rowPlugin = oov::toRowPlugin(plugin);
+
     /*
      * For cairo plug-ins, we build the cairo graphics context via the
-     * CairoPlugin::init function.
+     * CairoPlugin::init function and we read the frame-* parameters.
      */
-    if (plugin()->isCairo()) {
-        oov::CairoPluginPtr plg = oov::toCairoPlugin(plugin());
+    if (m_plugin->isCairo()) {
+        oov::CairoPluginPtr plg = oov::toCairoPlugin(m_plugin);
         plg->init();
+        plg->setFrameParameters(parameters);
     }
 
-    plugin()->onParameter(pluginname, location, file, parameters, time);
+    m_plugin->onParameter(pluginname, location, file, parameters, time);
+
+    /*
+     * The writer thread is started after the initialization of the plug-in,
+     * all the next calls to the plug-in are done by this thread.
+     */
+    if (asynchronous) {
+        m_worker = new Worker(*this, STREAM_WRITER_QUEUE_CAPACITY);
+    }
 }
 
-void StreamWriter::processNewObservable(Simulator* simulator,
-                                        const std::string& portname,
-                                        const devs::Time& time,
-                                        const std::string& view)
+oov::ObservableId StreamWriter::processNewObservable(
+    Simulator* simulator,
+    const std::string& portname,
+    const devs::Time& time,
+    const std::string& view)
 {
-    plugin()->onNewObservable(simulator->getName(),
-                              simulator->getParent(),
-                              portname, view, time);
+    oov::ObservableId id;
+
+    if (m_freeIds.empty()) {
+        id = m_row.size();
+        m_row.push_back(0);
+    } else {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+
+    if (m_worker) {
+        StreamRecord* record = new StreamRecord(StreamRecord::NEW_OBSERVABLE,
+                                                time);
+        record->id = id;
+        record->simulator = simulator->getName();
+        record->parent = simulator->getParent();
+        record->port = portname;
+        record->view = view;
+        m_worker->push(record);
+    } else {
+        writeNewObservable(id, simulator->getName(), simulator->getParent(),
+                           portname, view, time);
+    }
+
+    return id;
 }
 
-void StreamWriter::processRemoveObservable(Simulator* simulator,
-                                           const std::string& portname,
-                                           const devs::Time& time,
-                                           const std::string& view)
+void StreamWriter::processRemoveObservable(oov::ObservableId id,
+                                           const devs::Time& time)
 {
-    plugin()->onDelObservable(simulator->getName(),
-                              simulator->getParent(),
-                              portname, view, time);
+    assert(id < m_row.size());
+
+    delete m_row[id];
+    m_row[id] = 0;
+    m_freeIds.push_back(id);
+
+    if (m_worker) {
+        StreamRecord* record = new StreamRecord(
+            StreamRecord::REMOVE_OBSERVABLE, time);
+        record->id = id;
+        m_worker->push(record);
+    } else {
+        writeRemoveObservable(id, time);
+    }
 }
 
-void StreamWriter::process(Simulator* simulator,
-                           const std::string& portname,
-                           const devs::Time& time,
-                           const std::string& view,
-                           value::Value* val)
+void StreamWriter::processRow(const devs::Time& time,
+                              const std::string& view)
 {
-    std::string name, parent;
+    if (m_worker) {
+        StreamRecord* record = new StreamRecord(StreamRecord::ROW, time);
+        record->view = view;
+        record->row.swap(m_row);
+        record->order.swap(m_order);
+        m_row.resize(record->row.size(), 0);
+        m_worker->push(record);
+    } else {
+        try {
+            writeRow(time, view, m_row, m_order);
+        } catch (...) {
+            m_order.clear();
+            throw;
+        }
 
-    if (simulator) {
-        name = simulator->getName();
-        parent = simulator->getParent();
+        m_order.clear();
     }
+}
 
-    if (plugin()->isCairo()) {
-        oov::CairoPluginPtr plg = oov::toCairoPlugin(plugin());
-        plg->needCopy();
-        plg->onValue(name, parent, portname, view, time, val);
-
-        if (plg->isCopyDone()) {
-            std::string file(
-                utils::Path::buildFilename(
-                    plg->location(), (fmt("img-%1$08d.png") %
-                                      plg->getNextFrameNumber()).str()));
-
-            try {
-                plg->stored()->write_to_png(file);
-            } catch(const std::exception& /*e*/) {
-                throw utils::InternalError(
-                    fmt(_("oov: cannot write image '%1%'")) % file);
-            }
+void StreamWriter::writeNewObservable(oov::ObservableId id,
+                                      const std::string& simulator,
+                                      const std::string& parent,
+                                      const std::string& portname,
+                                      const std::string& view,
+                                      const devs::Time& time)
+{
+    if (m_rowPlugin) {
+        m_rowPlugin->onAddObservable(id, simulator, parent, portname, view,
+                                     time);
+    } else {
+        if (id >= m_names.size()) {
+            m_names.resize(id + 1);
         }
+
+        ObservableName& name(m_names[id]);
+        name.simulator.assign(simulator);
+        name.parent.assign(parent);
+        name.port.assign(portname);
+        name.view.assign(view);
+
+        plugin()->onNewObservable(simulator, parent, portname, view, time);
+    }
+}
+
+void StreamWriter::writeRemoveObservable(oov::ObservableId id,
+                                         const devs::Time& time)
+{
+    if (m_rowPlugin) {
+        m_rowPlugin->onRemoveObservable(id, time);
     } else {
-        plugin()->onValue(name, parent, portname, view, time, val);
+        assert(id < m_names.size());
 
+        ObservableName& name(m_names[id]);
+        plugin()->onDelObservable(name.simulator, name.parent, name.port,
+                                  name.view, time);
+        name = ObservableName();
+    }
+}
+
+void StreamWriter::writeValues(oov::Plugin& plugin,
+                               const devs::Time& time,
+                               const std::string& view,
+                               oov::ObservationRow& row,
+                               const std::vector < oov::ObservableId >& order)
+{
+    if (order.empty()) {
+        plugin.onValue(std::string(), std::string(), std::string(), view,
+                       time, 0);
+    }
+
+    for (std::vector < oov::ObservableId >::const_iterator it =
+             order.begin(); it != order.end(); ++it) {
+        const ObservableName& name(m_names[*it]);
+        value::Value* value = row[*it];
+
+        row[*it] = 0;
+        plugin.onValue(name.simulator, name.parent, name.port, view, time,
+                       value);
+    }
+}
+
+void StreamWriter::writeRow(const devs::Time& time,
+                            const std::string& view,
+                            oov::ObservationRow& row,
+                            const std::vector < oov::ObservableId >& order)
+{
+    try {
+        if (plugin()->isCairo()) {
+            oov::CairoPluginPtr plg = oov::toCairoPlugin(plugin());
+            plg->needCopy(time);
+            writeValues(*plg, time, view, row, order);
+
+            if (plg->isCopyDone()) {
+                std::string file(
+                    utils::Path::buildFilename(
+                        plg->location(), (fmt("img-%1$08d.png") %
+                                          plg->getNextFrameNumber()).str()));
+
+                plg->writeStored(file);
+            }
+        } else if (m_rowPlugin) {
+            m_rowPlugin->onRow(view, time, row);
+        } else {
+            writeValues(*plugin(), time, view, row, order);
+        }
+    } catch (...) {
+        /* The values not sent to onValue still belong to the row. */
+        if (not m_rowPlugin) {
+            std::for_each(row.begin(), row.end(),
+                          boost::checked_deleter < value::Value >());
+        }
+
+        std::fill(row.begin(), row.end(), (value::Value*)0);
+        throw;
+    }
+
+    /* The plug-in takes the ownership of the values. */
+    std::fill(row.begin(), row.end(), (value::Value*)0);
+}
+
+void StreamWriter::flush()
+{
+    if (m_worker) {
+        m_worker->flush();
     }
 }
 
 void StreamWriter::close(const devs::Time& time)
 {
+    if (m_worker) {
+        try {
+            m_worker->flush();
+        } catch (...) {
+            delete m_worker;
+            m_worker = 0;
+            throw;
+        }
+
+        delete m_worker;
+        m_worker = 0;
+    }
+
+    if (plugin()->isCairo()) {
+        oov::toCairoPlugin(plugin())->flushStored();
+    }
+
     plugin()->close(time);
 }
 
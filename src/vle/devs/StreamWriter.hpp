@@ -33,7 +33,7 @@
 #include <vle/devs/Simulator.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/value/Value.hpp>
-#include <vle/oov/Plugin.hpp>
+#include <vle/oov/RowPlugin.hpp>
 #include <vle/utils/ModuleManager.hpp>
 
 namespace vle { namespace devs {
@@ -46,18 +46,25 @@ class Observable;
  * the base of the MemoryStreamWriter and NetStreamWriter deployed as
  * plugins.
  *
+ * In asynchronous mode, the observations are pushed into a bounded queue
+ * and a writer thread dedicated to the StreamWriter calls the plug-in. The
+ * simulation is blocked only when the queue is full. The order of the
+ * observations is preserved and the queue is flushed by the close
+ * function.
+ *
+ * A oov::RowPlugin receives the rows of observations. The other plug-ins
+ * receive the values of a row one by one (oov::Plugin::onValue) in the
+ * order of the calls to the process function.
  */
 class VLE_API StreamWriter
 {
 public:
     StreamWriter(const utils::ModuleManager& modulemgr)
-        : m_view(0), m_modulemgr(modulemgr)
+        : m_view(0), m_modulemgr(modulemgr), m_worker(0)
     {
     }
 
-    ~StreamWriter()
-    {
-    }
+    ~StreamWriter();
 
     ///
     ////
@@ -71,36 +78,90 @@ public:
      * @param file name of the file.
      * @param parameters the value attached to the plug-in.
      * @param time the date when the plug-in was opened.
+     * @param asynchronous true to call the plug-in from a writer thread.
      */
     void open(const std::string& plugin,
               const std::string& package,
               const std::string& location,
               const std::string& file,
               value::Value* parameters,
-              const devs::Time& time);
+              const devs::Time& time,
+              bool asynchronous = false);
 
-    void processNewObservable(Simulator* simulator,
-                              const std::string& portname,
-                              const devs::Time& time,
-                              const std::string& view);
+    /**
+     * @brief Initialise an already built plug-in with specified
+     * information.
+     * @param plugin the plug-in.
+     * @param pluginname the plugin's name.
+     * @param location where the plugin write data.
+     * @param file name of the file.
+     * @param parameters the value attached to the plug-in.
+     * @param time the date when the plug-in was opened.
+     * @param asynchronous true to call the plug-in from a writer thread.
+     */
+    void open(const oov::PluginPtr& plugin,
+              const std::string& pluginname,
+              const std::string& location,
+              const std::string& file,
+              value::Value* parameters,
+              const devs::Time& time,
+              bool asynchronous = false);
 
-    void processRemoveObservable(Simulator* simulator,
-                                 const std::string& portname,
-                                 const devs::Time& time,
-                                 const std::string& view);
+    /**
+     * @brief Attach a new observable to the plug-in.
+     * @param simulator the observed simulator.
+     * @param portname the observed port.
+     * @param time the date of the attachment.
+     * @param view the name of the view.
+     * @return The identifier of the observable in the plug-in.
+     */
+    oov::ObservableId processNewObservable(Simulator* simulator,
+                                           const std::string& portname,
+                                           const devs::Time& time,
+                                           const std::string& view);
 
     /**
-     * @brief Process the devs::ObservationEvent and write it to the Stream.
-     * @param event the devs::ObservationEvent to write.
+     * @brief Detach an observable from the plug-in. The identifier can
+     * be reused by the next call to processNewObservable.
+     * @param id the identifier of the observable.
+     * @param time the date of the detachment.
      */
-    void process(Simulator* simulator,
-                 const std::string& portname,
-                 const devs::Time& time,
-                 const std::string& view,
-                 value::Value* value);
+    void processRemoveObservable(oov::ObservableId id,
+                                 const devs::Time& time);
 
     /**
-     * Close the output stream.
+     * @brief Store the observation of an observable into the current
+     * row. The row is sent to the plug-in by processRow.
+     * @param id the identifier of the observable.
+     * @param value the observation.
+     */
+    void process(oov::ObservableId id, value::Value* value)
+    {
+        assert(id < m_row.size());
+
+        delete m_row[id];
+        m_row[id] = value;
+        m_order.push_back(id);
+    }
+
+    /**
+     * @brief Send the current row to the plug-in and clear it.
+     * @param time the date of the observation.
+     * @param view the name of the view.
+     */
+    void processRow(const devs::Time& time, const std::string& view);
+
+    /**
+     * @brief Wait until all the observations pushed into the queue are
+     * sent to the plug-in. Nothing to do in synchronous mode.
+     * @throw utils::InternalError if the plug-in failed in the writer
+     * thread.
+     */
+    void flush();
+
+    /**
+     * Close the output stream. In asynchronous mode, the queue is flushed
+     * and the writer thread is stopped before the plug-in is closed.
      * @return A reference to the oov::Plugin if the plugin is serializable.
      */
     void close(const devs::Time& time);
@@ -144,9 +205,56 @@ private:
     StreamWriter(const StreamWriter& other);
     StreamWriter& operator=(const StreamWriter& other);
 
-    devs::View*                 m_view;
-    const utils::ModuleManager& m_modulemgr;
-    oov::PluginPtr              m_plugin;
+    void writeNewObservable(oov::ObservableId id,
+                            const std::string& simulator,
+                            const std::string& parent,
+                            const std::string& portname,
+                            const std::string& view,
+                            const devs::Time& time);
+
+    void writeRemoveObservable(oov::ObservableId id,
+                               const devs::Time& time);
+
+    void writeRow(const devs::Time& time, const std::string& view,
+                  oov::ObservationRow& row,
+                  const std::vector < oov::ObservableId >& order);
+
+    /**
+     * @brief Send the values of a row to the onValue function of a
+     * plug-in without row interface, in the order of the observation.
+     */
+    void writeValues(oov::Plugin& plugin, const devs::Time& time,
+                     const std::string& view, oov::ObservationRow& row,
+                     const std::vector < oov::ObservableId >& order);
+
+    /**
+     * @brief The names of an observable sent to a plug-in without row
+     * interface.
+     */
+    struct ObservableName
+    {
+        std::string simulator;
+        std::string parent;
+        std::string port;
+        std::string view;
+    };
+
+    class Worker; /**< The writer thread of the asynchronous mode. */
+
+    devs::View*                     m_view;
+    const utils::ModuleManager&     m_modulemgr;
+    oov::PluginPtr                  m_plugin;
+    oov::RowPluginPtr               m_rowPlugin; /**< The plug-in if it
+                                                   has the row interface. */
+    oov::ObservationRow             m_row;
+    std::vector < oov::ObservableId > m_order; /**< The order of the
+                                                 observations of the row. */
+    std::vector < oov::ObservableId > m_freeIds;
+    std::vector < ObservableName >  m_names; /**< The names by identifier
+                                               of the observables of a
+                                               plug-in without row
+                                               interface. */
+    Worker*                         m_worker;
 };
 
 }} // namespace vle devs
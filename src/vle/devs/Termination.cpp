@@ -0,0 +1,221 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/devs/Termination.hpp>
+#include <vle/devs/Simulator.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <sstream>
+#include <cmath>
+
+namespace vle { namespace devs {
+
+const std::string& Termination::name()
+{
+    static const std::string result("vle.stop");
+
+    return result;
+}
+
+Termination::Termination(const vpz::Conditions& conditions)
+{
+    if (not conditions.exist(name())) {
+        return;
+    }
+
+    const vpz::Condition& stop(conditions.get(name()));
+    const vpz::ConditionValues& ports(stop.conditionvalues());
+
+    for (vpz::ConditionValues::const_iterator it = ports.begin();
+         it != ports.end(); ++it) {
+        std::string::size_type dot = it->first.rfind('.');
+
+        if (dot == std::string::npos or dot == 0 or
+            dot + 1 == it->first.size()) {
+            throw utils::ArgError(
+                fmt(_("Termination: the port `%1%' is not a model and an"
+                      " observation port separated by a dot")) % it->first);
+        }
+
+        PredicateList& predicates(
+            m_predicates[std::make_pair(it->first.substr(0, dot),
+                                        it->first.substr(dot + 1))]);
+        const value::Set& values(stop.getSetValues(it->first));
+
+        for (value::Set::const_iterator jt = values.begin();
+             jt != values.end(); ++jt) {
+            if (not *jt or not (*jt)->isString()) {
+                throw utils::ArgError(
+                    fmt(_("Termination: the values of the port `%1%' must"
+                          " be strings")) % it->first);
+            }
+
+            predicates.push_back(parse(it->first, (*jt)->toString().value()));
+        }
+    }
+}
+
+void Termination::check(const Simulator& model, const Time& time)
+{
+    if (m_reason.empty() and model.terminate(time)) {
+        m_reason = (fmt(_("the model `%1%' ends the simulation at time %2%"))
+                    % model.getName() % time).str();
+    }
+}
+
+void Termination::observe(const Simulator& model, const std::string& port,
+                          const value::Value* value, const Time& time)
+{
+    check(model, time);
+
+    if (not m_reason.empty() or m_predicates.empty() or not value) {
+        return;
+    }
+
+    double real;
+
+    if (value->isDouble()) {
+        real = value->toDouble().value();
+    } else if (value->isInteger()) {
+        real = value->toInteger().value();
+    } else {
+        return;
+    }
+
+    PredicateMap::iterator it = m_predicates.find(
+        std::make_pair(model.getName(), port));
+
+    if (it == m_predicates.end()) {
+        return;
+    }
+
+    for (PredicateList::iterator jt = it->second.begin();
+         jt != it->second.end(); ++jt) {
+        if (evaluate(*jt, real, time) and m_reason.empty()) {
+            m_reason = (fmt(_("the predicate `%1%.%2% %3%' is true at time"
+                              " %4%")) % model.getName() % port
+                        % jt->expression % time).str();
+        }
+    }
+}
+
+void Termination::clear()
+{
+    m_reason.clear();
+
+    for (PredicateMap::iterator it = m_predicates.begin();
+         it != m_predicates.end(); ++it) {
+        for (PredicateList::iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            jt->observed = false;
+        }
+    }
+}
+
+Termination::Predicate Termination::parse(const std::string& port,
+                                          const std::string& expression)
+{
+    std::istringstream input(expression);
+    std::string op;
+    Predicate result;
+
+    input >> op >> result.threshold;
+
+    if (input.fail() or not (input >> std::ws).eof()) {
+        throw utils::ArgError(
+            fmt(_("Termination: bad predicate `%1%' on the port `%2%'"))
+            % expression % port);
+    }
+
+    if (op == "<") {
+        result.op = LESS;
+    } else if (op == "<=") {
+        result.op = LESS_EQUAL;
+    } else if (op == ">") {
+        result.op = GREATER;
+    } else if (op == ">=") {
+        result.op = GREATER_EQUAL;
+    } else if (op == "==") {
+        result.op = EQUAL;
+    } else if (op == "!=") {
+        result.op = NOT_EQUAL;
+    } else if (op == "stable" and result.threshold >= 0.0) {
+        result.op = STABLE;
+    } else {
+        throw utils::ArgError(
+            fmt(_("Termination: bad predicate `%1%' on the port `%2%'"))
+            % expression % port);
+    }
+
+    result.expression = expression;
+    result.previous = 0.0;
+    result.time = 0.0;
+    result.observed = false;
+
+    return result;
+}
+
+bool Termination::evaluate(Predicate& predicate, double value,
+                           const Time& time)
+{
+    switch (predicate.op) {
+    case LESS:
+        return value < predicate.threshold;
+    case LESS_EQUAL:
+        return value <= predicate.threshold;
+    case GREATER:
+        return value > predicate.threshold;
+    case GREATER_EQUAL:
+        return value >= predicate.threshold;
+    case EQUAL:
+        return value == predicate.threshold;
+    case NOT_EQUAL:
+        return value != predicate.threshold;
+    case STABLE: {
+        if (predicate.observed and predicate.time == time) {
+            return false;
+        }
+
+        bool result = predicate.observed and
+            std::abs(value - predicate.previous) <= predicate.threshold;
+
+        predicate.previous = value;
+        predicate.time = time;
+        predicate.observed = true;
+        return result;
+    }
+    }
+
+    return false;
+}
+
+}} // namespace vle devs
@@ -0,0 +1,151 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_DEVS_TERMINATION_HPP
+#define VLE_DEVS_TERMINATION_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/Time.hpp>
+#include <vle/value/Value.hpp>
+#include <vle/vpz/Conditions.hpp>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace vle { namespace devs {
+
+class Simulator;
+
+/**
+ * @brief Termination ends a simulation before the end of the
+ * experiment: the simulation ends when the terminate function of a
+ * model returns true (see Dynamics::terminate), evaluated after each
+ * transition of the model and at each of its observations, or when a
+ * predicate on an observed value is true. The predicates are evaluated
+ * at each observation by a view: a predicate on a model or a port that
+ * no view observes is never true.
+ *
+ * The predicates are described by the condition Termination::name() of
+ * the experiment. The name of a port is the name of an atomic model and
+ * the name of its observation port, separated by a dot. A value of the
+ * port is a value::String, a comparison with a real ("< 1", "<= 0",
+ * "> 1e6", ">= 10", "== 0" or "!= 0") or "stable" and a real to end the
+ * simulation when the difference between two successive observations
+ * is lower or equal to the real (the observations at the same time by
+ * several views are compared once):
+ *
+ * @code
+ * <condition name="vle.stop">
+ *  <port name="prey.population"><string>&lt;= 0</string></port>
+ *  <port name="predator.population"><string>stable 1e-6</string></port>
+ * </condition>
+ * @endcode
+ *
+ * Only the numeric observations (value::Double and value::Integer) are
+ * compared.
+ */
+class VLE_API Termination
+{
+public:
+    /**
+     * @brief Build the predicates of the experiment.
+     * @param conditions the conditions of the experiment.
+     * @throw utils::ArgError if a predicate is not valid.
+     */
+    Termination(const vpz::Conditions& conditions);
+
+    /**
+     * @brief Get the name of the condition which describes the
+     * predicates.
+     * @return "vle.stop".
+     */
+    static const std::string& name();
+
+    /**
+     * @brief Evaluate the terminate function of a model after one of
+     * its transitions.
+     * @param model the model.
+     * @param time the time of the transition.
+     */
+    void check(const Simulator& model, const Time& time);
+
+    /**
+     * @brief Evaluate the terminate function of a model and the
+     * predicates of one of its observation.
+     * @param model the observed model.
+     * @param port the observation port.
+     * @param value the observation (can be null).
+     * @param time the time of the observation.
+     */
+    void observe(const Simulator& model, const std::string& port,
+                 const value::Value* value, const Time& time);
+
+    /**
+     * @brief Forget the previous observations and the end of the
+     * simulation, to run a new simulation.
+     */
+    void clear();
+
+    /**
+     * @brief Check if the simulation is ended.
+     * @return The description of the reason or an empty string.
+     */
+    const std::string& reason() const
+    { return m_reason; }
+
+private:
+    enum Operator { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL,
+                    NOT_EQUAL, STABLE };
+
+    struct Predicate
+    {
+        Operator    op;
+        double      threshold;
+        std::string expression;
+        double      previous;
+        Time        time;
+        bool        observed;
+    };
+
+    typedef std::vector < Predicate > PredicateList;
+    typedef std::map < std::pair < std::string, std::string >,
+                       PredicateList > PredicateMap;
+
+    static Predicate parse(const std::string& port,
+                           const std::string& expression);
+
+    static bool evaluate(Predicate& predicate, double value,
+                         const Time& time);
+
+    PredicateMap m_predicates;
+    std::string  m_reason;
+};
+
+}} // namespace vle devs
+
+#endif
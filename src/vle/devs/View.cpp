@@ -27,6 +27,7 @@
 
 #include <vle/devs/View.hpp>
 #include <vle/devs/Simulator.hpp>
+#include <vle/devs/Termination.hpp>
 
 namespace vle { namespace devs {
 
@@ -42,9 +43,11 @@ void View::addObservable(Simulator* model,
     assert(model);
 
     if (not exist(model, portname)) {
-        m_observableList.insert(value_type(model, portname));
-        m_stream->processNewObservable(model, portname, currenttime,
-                                       getName());
+        oov::ObservableId id = m_stream->processNewObservable(
+            model, portname, currenttime, getName());
+
+        m_observableList.insert(value_type(model,
+                                           ObservablePort(portname, id)));
     }
 }
 
@@ -62,8 +65,7 @@ void View::removeObservable(Simulator* sim)
 
     result = m_observableList.equal_range(sim);
     for (it = result.first; it != result.second; ++it) {
-        m_stream->processRemoveObservable(it->first, it->second, 0.0,
-                                          getName());
+        m_stream->processRemoveObservable(it->second.second, 0.0);
     }
 
     m_observableList.erase(result.first, result.second);
@@ -77,7 +79,7 @@ bool View::exist(Simulator* simulator, const std::string& portname) const
 
     result = m_observableList.equal_range(simulator);
     for (it = result.first; it != result.second; ++it) {
-        if (it->second == portname) {
+        if (it->second.first == portname) {
             return true;
         }
     }
@@ -91,21 +93,26 @@ bool View::exist(Simulator* simulator) const
 
 void View::run(const Time& time)
 {
-    if (not m_observableList.empty()) {
-        for (ObservableList::iterator it = m_observableList.begin();
-             it != m_observableList.end(); ++it) {
-            ObservationEvent event(time, it->first, getName(), it->second);
-            value::Value* val = it->first->observation(event);
-            m_stream->process(it->first, it->second, time, getName(), val);
+    for (ObservableList::iterator it = m_observableList.begin();
+         it != m_observableList.end(); ++it) {
+        ObservationEvent event(time, it->first, getName(), it->second.first);
+        value::Value* value = it->first->observation(event);
+
+        if (m_termination) {
+            m_termination->observe(*it->first, it->second.first, value, time);
         }
-    } else {
-        m_stream->process(0, std::string(), time, getName(), 0);
+
+        m_stream->process(it->second.second, value);
     }
+
+    m_stream->processRow(time, getName());
 }
 
 value::Matrix * View::matrix() const
 {
     if (m_stream->plugin()) {
+        m_stream->flush();
+
         return m_stream->plugin()->matrix();
     }
 
@@ -32,6 +32,7 @@
 #include <vle/devs/StreamWriter.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/value/Matrix.hpp>
+#include <vle/oov/RowPlugin.hpp>
 #include <string>
 #include <map>
 
@@ -39,9 +40,16 @@ namespace vle { namespace devs {
 
 class Simulator;
 class StreamWriter;
+class Termination;
 class View;
 
-typedef std::multimap < Simulator*, std::string > ObservableList;
+/**
+ * @brief An observed port of a Simulator and its identifier in the
+ * output plug-in.
+ */
+typedef std::pair < std::string, oov::ObservableId > ObservablePort;
+
+typedef std::multimap < Simulator*, ObservablePort > ObservableList;
 typedef std::map < std::string, View* > ViewList;
 
 /**
@@ -57,7 +65,7 @@ public:
     typedef ObservableList::value_type value_type;
 
     View(const std::string& name, StreamWriter* stream)
-        : m_name(name), m_stream(stream), m_size(0)
+        : m_name(name), m_stream(stream), m_size(0), m_termination(0)
     {}
 
     virtual ~View();
@@ -122,12 +130,22 @@ public:
     inline StreamWriter * getStream() const
     { return m_stream; }
 
+    /**
+     * @brief Assign the Termination which evaluates the observations.
+     * @param termination the Termination of the simulation (can be
+     * null).
+     */
+    inline void setTermination(Termination* termination)
+    { m_termination = termination; }
+
     /**
      * Return a pointer to the \c value::Matrix.
      *
      * If the plug-in does not manage \c value::Matrix, this function
      * returns NULL otherwise, this function return the \c
-     * value::Matrix manager by the plug-in.
+     * value::Matrix manager by the plug-in. With an asynchronous
+     * output, the observations waiting in the queue are sent to the
+     * plug-in first (see StreamWriter::flush).
      *
      * @attention You are in charge of freeing the value::Matrix after
      * the end of the simulation.
@@ -139,6 +157,7 @@ protected:
     std::string         m_name;
     StreamWriter*       m_stream;
     size_t              m_size;
+    Termination*        m_termination;
 };
 
 /**
@@ -38,11 +38,16 @@
 #include <fstream>
 #include <vle/devs/Coordinator.hpp>
 #include <vle/devs/RootCoordinator.hpp>
+#include <vle/devs/Termination.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/vpz/Dynamics.hpp>
 #include <vle/vpz/Experiment.hpp>
 #include <vle/vpz/Classes.hpp>
+#include <vle/vpz/Conditions.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Integer.hpp>
 #include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/Exception.hpp>
 
 using namespace vle;
 
@@ -65,3 +70,86 @@ BOOST_AUTO_TEST_CASE(test_del_coupled_model)
     delete depth0;
     delete simdepth2;
 }
+
+BOOST_AUTO_TEST_CASE(test_reset_without_close)
+{
+    utils::ModuleManager modules;
+    devs::RootCoordinator root(modules);
+    vpz::Conditions conditions;
+
+    BOOST_CHECK_THROW(root.reset(conditions, "experiment"),
+                      utils::InternalError);
+}
+
+BOOST_AUTO_TEST_CASE(test_termination_predicates)
+{
+    vpz::Conditions conditions;
+    vpz::Condition stop(devs::Termination::name());
+    stop.addValueToPort("prey.population", value::String("<= 0"));
+    stop.addValueToPort("prey.population", value::String("stable 1e-6"));
+    stop.addValueToPort("top.predator.population", value::String("> 1e6"));
+    conditions.add(stop);
+
+    devs::Termination termination(conditions);
+    BOOST_CHECK(termination.reason().empty());
+
+    const char *invalid[] = { "<", "< x", "=< 1", "stable -1", "> 1 2" };
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        vpz::Conditions bad;
+        vpz::Condition predicate(devs::Termination::name());
+        predicate.addValueToPort("prey.population", value::String(invalid[i]));
+        bad.add(predicate);
+
+        BOOST_CHECK_THROW(devs::Termination test(bad), utils::ArgError);
+    }
+
+    vpz::Conditions noport;
+    vpz::Condition port(devs::Termination::name());
+    port.addValueToPort("population", value::String("< 1"));
+    noport.add(port);
+    BOOST_CHECK_THROW(devs::Termination test(noport), utils::ArgError);
+
+    vpz::Conditions nostring;
+    vpz::Condition integer(devs::Termination::name());
+    integer.addValueToPort("prey.population", value::Integer(1));
+    nostring.add(integer);
+    BOOST_CHECK_THROW(devs::Termination test(nostring), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(test_random_streams)
+{
+    utils::ModuleManager modules;
+    devs::RootCoordinator root(modules);
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* a = top->addAtomicModel("a");
+    vpz::CoupledModel* sub(top->addCoupledModel("sub"));
+    vpz::AtomicModel* suba = sub->addAtomicModel("a");
+
+    root.setSeed(123);
+    BOOST_REQUIRE(not root.antithetic());
+
+    uint32_t seed = root.seed(*a);
+    BOOST_CHECK(seed != root.seed(*suba));
+
+    top->addAtomicModel("b");
+    top->delModel(sub);
+    BOOST_CHECK_EQUAL(seed, root.seed(*a));
+
+    root.setSeed(124, true);
+    BOOST_REQUIRE(root.antithetic());
+    BOOST_CHECK(seed != root.seed(*a));
+
+    devs::InitEventList events;
+    devs::Dynamics first(devs::DynamicsInit(*a, devs::PackageId(), seed),
+                         events);
+    devs::Dynamics second(devs::DynamicsInit(*a, devs::PackageId(), seed,
+                                             true), events);
+
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_SMALL(first.rand().getDouble() +
+                          second.rand().getDouble() - 1.0, 1e-9);
+    }
+
+    delete top;
+}
@@ -0,0 +1,519 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devsstreamwriter_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <vle/devs/StreamWriter.hpp>
+#include <vle/devs/Simulator.hpp>
+#include <vle/oov/CairoPlugin.hpp>
+#include <vle/oov/RowPlugin.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/Path.hpp>
+#include <vle/utils/i18n.hpp>
+
+using namespace vle;
+
+typedef std::vector < std::string > Log;
+
+/*
+ * Write a value of an observation into the log of a plug-in.
+ */
+static std::string str(value::Value* value)
+{
+    std::ostringstream out;
+
+    if (value) {
+        out << value::toDouble(value);
+    } else {
+        out << "null";
+    }
+
+    delete value;
+
+    return out.str();
+}
+
+/*
+ * A plug-in with the first interface: one value per call.
+ */
+class Values : public oov::Plugin
+{
+public:
+    Values(Log* log)
+        : oov::Plugin(std::string()), mLog(log)
+    {
+    }
+
+    virtual void onParameter(const std::string& /* plugin */,
+                             const std::string& /* location */,
+                             const std::string& /* file */,
+                             value::Value* parameters,
+                             const double& /* time */)
+    {
+        delete parameters;
+    }
+
+    virtual void onNewObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {
+        mLog->push_back("new " + parent + " " + simulator + " " + port);
+    }
+
+    virtual void onDelObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {
+        mLog->push_back("del " + parent + " " + simulator + " " + port);
+    }
+
+    virtual void onValue(const std::string& simulator,
+                         const std::string& /* parent */,
+                         const std::string& port,
+                         const std::string& view,
+                         const double& time,
+                         value::Value* value)
+    {
+        std::ostringstream out;
+
+        out << "value " << view << " " << time << " " << simulator << " "
+            << port << " " << str(value);
+        mLog->push_back(out.str());
+    }
+
+    virtual void close(const double& /* time */)
+    {
+        mLog->push_back("close");
+    }
+
+private:
+    Log* mLog;
+};
+
+/*
+ * A plug-in with the row interface.
+ */
+class Rows : public oov::RowPlugin
+{
+public:
+    Rows(Log* log)
+        : oov::RowPlugin(std::string()), mLog(log)
+    {
+    }
+
+    virtual void onParameter(const std::string& /* plugin */,
+                             const std::string& /* location */,
+                             const std::string& /* file */,
+                             value::Value* parameters,
+                             const double& /* time */)
+    {
+        delete parameters;
+    }
+
+    virtual void onAddObservable(oov::ObservableId id,
+                                 const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {
+        std::ostringstream out;
+
+        out << "add " << id << " " << parent << " " << simulator << " "
+            << port;
+        mLog->push_back(out.str());
+    }
+
+    virtual void onRemoveObservable(oov::ObservableId id,
+                                    const double& /* time */)
+    {
+        std::ostringstream out;
+
+        out << "remove " << id;
+        mLog->push_back(out.str());
+    }
+
+    virtual void onRow(const std::string& view,
+                       const double& time,
+                       const oov::ObservationRow& row)
+    {
+        std::ostringstream out;
+
+        out << "row " << view << " " << time;
+        for (oov::ObservationRow::const_iterator it = row.begin();
+             it != row.end(); ++it) {
+            out << " " << str(*it);
+        }
+        mLog->push_back(out.str());
+    }
+
+    virtual void close(const double& /* time */)
+    {
+        mLog->push_back("close");
+    }
+
+private:
+    Log* mLog;
+};
+
+/*
+ * Attach three observables to a StreamWriter, observe them in an order
+ * different from their identifiers, remove the second one and attach a
+ * new observable.
+ */
+static void observe(const oov::PluginPtr& plugin, bool asynchronous)
+{
+    utils::ModuleManager modules;
+    vpz::CoupledModel top("top", 0);
+    devs::Simulator a(top.addAtomicModel("a"));
+    devs::Simulator b(top.addAtomicModel("b"));
+    devs::Simulator c(top.addAtomicModel("c"));
+    devs::Simulator d(top.addAtomicModel("d"));
+    devs::StreamWriter writer(modules);
+
+    writer.open(plugin, "test", std::string(), std::string(), 0, 0.0,
+                asynchronous);
+
+    BOOST_REQUIRE_EQUAL(writer.processNewObservable(&a, "x", 0.0, "view"),
+                        0u);
+    BOOST_REQUIRE_EQUAL(writer.processNewObservable(&b, "x", 0.0, "view"),
+                        1u);
+    BOOST_REQUIRE_EQUAL(writer.processNewObservable(&c, "y", 0.0, "view"),
+                        2u);
+
+    writer.process(2, value::Double::create(3.0));
+    writer.process(0, value::Double::create(1.0));
+    writer.process(1, value::Double::create(2.0));
+    writer.processRow(1.0, "view");
+
+    writer.processRemoveObservable(1, 1.5);
+    writer.process(2, value::Double::create(5.0));
+    writer.process(0, value::Double::create(4.0));
+    writer.processRow(2.0, "view");
+
+    BOOST_REQUIRE_EQUAL(writer.processNewObservable(&d, "z", 2.5, "view"),
+                        1u);
+    writer.process(1, value::Double::create(6.0));
+    writer.processRow(3.0, "view");
+
+    writer.close(4.0);
+}
+
+BOOST_AUTO_TEST_CASE(streamwriter_values)
+{
+    /*
+     * The values are sent to onValue in the order of the observation, like
+     * the order of the observables of a devs::View, not in the order of
+     * the identifiers.
+     */
+    const char* expected[] = {
+        "new top a x", "new top b x", "new top c y",
+        "value view 1 c y 3", "value view 1 a x 1", "value view 1 b x 2",
+        "del top b x",
+        "value view 2 c y 5", "value view 2 a x 4",
+        "new top d z",
+        "value view 3 d z 6",
+        "close" };
+
+    for (int i = 0; i < 2; ++i) {
+        Log log;
+
+        observe(oov::PluginPtr(new Values(&log)), i == 1);
+
+        BOOST_REQUIRE_EQUAL(log.size(),
+                            sizeof(expected) / sizeof(expected[0]));
+        for (Log::size_type j = 0; j < log.size(); ++j) {
+            BOOST_CHECK_EQUAL(log[j], expected[j]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(streamwriter_values_empty)
+{
+    /*
+     * A view without observable sends one empty value per observation.
+     */
+    utils::ModuleManager modules;
+    Log log;
+    devs::StreamWriter writer(modules);
+
+    writer.open(oov::PluginPtr(new Values(&log)), "test", std::string(),
+                std::string(), 0, 0.0);
+    writer.processRow(1.0, "view");
+    writer.close(2.0);
+
+    BOOST_REQUIRE_EQUAL(log.size(), 2u);
+    BOOST_CHECK_EQUAL(log[0], "value view 1   null");
+    BOOST_CHECK_EQUAL(log[1], "close");
+}
+
+BOOST_AUTO_TEST_CASE(streamwriter_rows)
+{
+    /*
+     * The rows are indexed by the identifiers, the identifier of the
+     * removed observable is reused.
+     */
+    const char* expected[] = {
+        "add 0 top a x", "add 1 top b x", "add 2 top c y",
+        "row view 1 1 2 3",
+        "remove 1",
+        "row view 2 4 null 5",
+        "add 1 top d z",
+        "row view 3 null 6 null",
+        "close" };
+
+    for (int i = 0; i < 2; ++i) {
+        Log log;
+
+        observe(oov::PluginPtr(new Rows(&log)), i == 1);
+
+        BOOST_REQUIRE_EQUAL(log.size(),
+                            sizeof(expected) / sizeof(expected[0]));
+        for (Log::size_type j = 0; j < log.size(); ++j) {
+            BOOST_CHECK_EQUAL(log[j], expected[j]);
+        }
+    }
+}
+
+/*
+ * A plug-in which throws an exception which is not a std::exception.
+ */
+class Failing : public oov::RowPlugin
+{
+public:
+    Failing()
+        : oov::RowPlugin(std::string())
+    {
+    }
+
+    virtual void onParameter(const std::string& /* plugin */,
+                             const std::string& /* location */,
+                             const std::string& /* file */,
+                             value::Value* parameters,
+                             const double& /* time */)
+    {
+        delete parameters;
+    }
+
+    virtual void onAddObservable(oov::ObservableId /* id */,
+                                 const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* port */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {
+    }
+
+    virtual void onRemoveObservable(oov::ObservableId /* id */,
+                                    const double& /* time */)
+    {
+    }
+
+    virtual void onRow(const std::string& /* view */,
+                       const double& /* time */,
+                       const oov::ObservationRow& row)
+    {
+        for (oov::ObservationRow::const_iterator it = row.begin();
+             it != row.end(); ++it) {
+            delete *it;
+        }
+
+        throw 42;
+    }
+
+    virtual void close(const double& /* time */)
+    {
+    }
+};
+
+BOOST_AUTO_TEST_CASE(streamwriter_unknown_error)
+{
+    /*
+     * The error of the writer thread is reported by the close function,
+     * whatever the type of the exception.
+     */
+    utils::ModuleManager modules;
+    vpz::CoupledModel top("top", 0);
+    devs::Simulator a(top.addAtomicModel("a"));
+    devs::StreamWriter writer(modules);
+
+    writer.open(oov::PluginPtr(new Failing()), "test", std::string(),
+                std::string(), 0, 0.0, true);
+    writer.processNewObservable(&a, "x", 0.0, "view");
+    writer.process(0, value::Double::create(1.0));
+    writer.processRow(1.0, "view");
+
+    BOOST_CHECK_THROW(writer.close(2.0), utils::InternalError);
+}
+
+/*
+ * A Cairo plug-in which paints each frame with a red level of ten times the
+ * observed value.
+ */
+class Frames : public oov::CairoPlugin
+{
+public:
+    Frames(const std::string& location)
+        : oov::CairoPlugin(location)
+    {
+    }
+
+    virtual void onParameter(const std::string& /* plugin */,
+                             const std::string& /* location */,
+                             const std::string& /* file */,
+                             value::Value* parameters,
+                             const double& /* time */)
+    {
+        delete parameters;
+    }
+
+    virtual void onNewObservable(const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* port */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {
+    }
+
+    virtual void onDelObservable(const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* port */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {
+    }
+
+    virtual void onValue(const std::string& /* simulator */,
+                         const std::string& /* parent */,
+                         const std::string& /* port */,
+                         const std::string& /* view */,
+                         const double& /* time */,
+                         value::Value* value)
+    {
+        m_ctx->set_source_rgb(value::toDouble(value) * 10.0 / 255.0,
+                              0.0, 0.0);
+        m_ctx->paint();
+        delete value;
+
+        copy();
+    }
+
+    virtual void close(const double& /* time */)
+    {
+    }
+
+    virtual void preferredSize(int& width, int& height)
+    {
+        width = 8;
+        height = 8;
+    }
+};
+
+/*
+ * Get the red level of the first pixel of a frame.
+ */
+static int red(const std::string& file)
+{
+    Cairo::RefPtr < Cairo::ImageSurface > img =
+        Cairo::ImageSurface::create_from_png(file);
+    const uint32_t pixel = *reinterpret_cast < const uint32_t* >(
+        img->get_data());
+
+    return (pixel >> 16) & 0xff;
+}
+
+BOOST_AUTO_TEST_CASE(streamwriter_cairo)
+{
+    namespace fs = boost::filesystem;
+
+    /*
+     * The counter is observed at the times 1 to 20. One frame over two is
+     * kept (1, 3, 5, ...) and three units of time must separate two
+     * written frames: the frames of the times 1, 5, 9, 13 and 17 are
+     * written in this order by four encoder threads.
+     */
+    const int expected[] = { 1, 5, 9, 13, 17 };
+    const int size = sizeof(expected) / sizeof(expected[0]);
+
+    for (int i = 0; i < 2; ++i) {
+        fs::path location(fs::temp_directory_path() /
+                          fs::unique_path("vle-cairo-%%%%-%%%%"));
+        fs::create_directories(location);
+
+        utils::ModuleManager modules;
+        vpz::CoupledModel top("top", 0);
+        devs::Simulator a(top.addAtomicModel("a"));
+        devs::StreamWriter writer(modules);
+
+        value::Map *parameters = new value::Map();
+        parameters->addInt("frame-step", 2);
+        parameters->addDouble("frame-time-step", 3.0);
+        parameters->addInt("frame-threads", 4);
+
+        writer.open(oov::PluginPtr(new Frames(location.string())), "test",
+                    location.string(), std::string(), parameters, 0.0,
+                    i == 1);
+        writer.processNewObservable(&a, "x", 0.0, "view");
+
+        for (int time = 1; time <= 20; ++time) {
+            writer.process(0, value::Double::create(time));
+            writer.processRow(time, "view");
+        }
+        writer.close(21.0);
+
+        for (int j = 0; j < size; ++j) {
+            std::string file(utils::Path::buildFilename(
+                    location.string(), (fmt("img-%1$08d.png") % j).str()));
+
+            BOOST_REQUIRE(fs::exists(file));
+            BOOST_CHECK(std::abs(red(file) - expected[j] * 10) <= 1);
+        }
+        BOOST_CHECK(not fs::exists(utils::Path::buildFilename(
+                    location.string(), (fmt("img-%1$08d.png") % size).str())));
+
+        fs::remove_all(location);
+    }
+}
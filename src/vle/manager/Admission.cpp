@@ -0,0 +1,136 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Admission.hpp>
+#include <fstream>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace vle { namespace manager {
+
+/*
+ * The weight of the estimation against a new sample in the decaying
+ * average.
+ */
+static const uint64_t admissionDecay = 3;
+
+Admission::Admission(uint64_t budget, uint64_t baseline)
+    : mBudget(budget), mBaseline(baseline), mEstimate(0), mRunning(0),
+      mMeasured(false)
+{
+}
+
+bool Admission::admit() const
+{
+    if (mRunning == 0) {
+        return true;
+    }
+
+    if (not mMeasured) {
+        return false;
+    }
+
+    return mBaseline + (uint64_t)(mRunning + 1) * mEstimate <= mBudget;
+}
+
+void Admission::acquire()
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    while (not admit()) {
+        mReleased.wait(lock);
+    }
+
+    ++mRunning;
+}
+
+bool Admission::tryAcquire()
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    if (not admit()) {
+        return false;
+    }
+
+    ++mRunning;
+    return true;
+}
+
+void Admission::release(uint64_t start)
+{
+    release(start, resident());
+}
+
+void Admission::release(uint64_t start, uint64_t resident)
+{
+    {
+        boost::mutex::scoped_lock lock(mMutex);
+
+        if (mRunning > 0) {
+            uint64_t sample = (resident > start) ?
+                (resident - start) / mRunning : 0;
+
+            if (mMeasured) {
+                mEstimate = (admissionDecay * mEstimate + sample) /
+                    (admissionDecay + 1);
+            } else {
+                mEstimate = sample;
+            }
+
+            --mRunning;
+        }
+
+        mMeasured = true;
+    }
+
+    mReleased.notify_all();
+}
+
+uint64_t Admission::estimate() const
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    return mEstimate;
+}
+
+uint64_t Admission::resident()
+{
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size, pages;
+
+    if (statm >> size >> pages) {
+        return pages * (uint64_t)::sysconf(_SC_PAGESIZE);
+    }
+#endif
+
+    return 0;
+}
+
+}} // namespace vle manager
@@ -0,0 +1,142 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_MANAGER_ADMISSION_HPP
+#define VLE_MANAGER_ADMISSION_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::Admission limits the number of simulations running at the
+ * same time in a process to keep the resident memory of the process
+ * under a budget.
+ *
+ * The memory of a simulation is estimated from the growth of the
+ * resident memory of the process during the simulation: when a
+ * simulation ends, the growth since its start divided by the number of
+ * simulations in progress (they grew at the same time) is a sample, and
+ * the estimation is a decaying average of the samples. The memory freed
+ * by the previous simulations and kept by the allocator, or kept by
+ * their results, is not a part of the growth of the next simulations.
+ * Until the end of the first simulation, only one simulation runs.
+ * Then a simulation starts only if the estimated memory of the
+ * simulations in progress and of the new one fits into the budget. A
+ * simulation always starts if no other is in progress.
+ *
+ * The functions are thread safe.
+ *
+ * @code
+ * manager::Admission admission(budget, manager::Admission::resident());
+ *
+ * admission.acquire();
+ * uint64_t start = manager::Admission::resident();
+ * simulate();
+ * admission.release(start);
+ * @endcode
+ */
+class VLE_API Admission
+{
+public:
+    /**
+     * Build an admission control.
+     *
+     * @param budget The memory budget in bytes.
+     * @param baseline The resident memory of the process before the
+     * simulations, in bytes.
+     */
+    Admission(uint64_t budget, uint64_t baseline);
+
+    /**
+     * Wait until a new simulation can start.
+     */
+    void acquire();
+
+    /**
+     * Start a new simulation if the budget allows it.
+     *
+     * @return true if the simulation can start.
+     */
+    bool tryAcquire();
+
+    /**
+     * End a simulation and measure the resident memory of the process.
+     *
+     * @param start The resident memory at the start of the simulation
+     * in bytes.
+     */
+    void release(uint64_t start);
+
+    /**
+     * End a simulation with a measure of the resident memory of the
+     * process.
+     *
+     * @param start The resident memory at the start of the simulation
+     * in bytes.
+     * @param resident The resident memory at the end of the simulation
+     * in bytes.
+     */
+    void release(uint64_t start, uint64_t resident);
+
+    /**
+     * Get the estimated memory of a simulation.
+     *
+     * @return The estimation in bytes.
+     */
+    uint64_t estimate() const;
+
+    /**
+     * Get the resident memory of the process.
+     *
+     * @return The resident memory in bytes or 0 if it is not available
+     * on this system (then the simulations are not limited).
+     */
+    static uint64_t resident();
+
+private:
+    Admission(const Admission& other);
+    Admission& operator=(const Admission& other);
+
+    bool admit() const;
+
+    mutable boost::mutex      mMutex;
+    boost::condition_variable mReleased;
+    uint64_t                  mBudget;
+    uint64_t                  mBaseline;
+    uint64_t                  mEstimate;
+    uint32_t                  mRunning;
+    bool                      mMeasured;
+};
+
+}} // namespace vle manager
+
+#endif
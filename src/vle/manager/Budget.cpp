@@ -0,0 +1,92 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Budget.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/details/Tools.hpp>
+
+namespace vle { namespace manager {
+
+const std::string& Budget::name()
+{
+    static const std::string result("vle.budget");
+
+    return result;
+}
+
+Budget::Budget(const vpz::Conditions& conditions)
+    : mWalltime(0.0), mBags(0), mStall(0), mRequeue(false)
+{
+    const vpz::Condition& budget(conditions.get(name()));
+    const vpz::ConditionValues& ports(budget.conditionvalues());
+
+    for (vpz::ConditionValues::const_iterator it = ports.begin();
+         it != ports.end(); ++it) {
+        if (it->first == "walltime") {
+            const value::Value *value = utils::getPortValue(
+                budget, it->first, "Budget");
+
+            if (value->isDouble()) {
+                mWalltime = value->toDouble().value();
+            } else if (value->isInteger()) {
+                mWalltime = value->toInteger().value();
+            } else {
+                mWalltime = -1.0;
+            }
+
+            if (not (mWalltime >= 0.0)) {
+                throw utils::ArgError(
+                    _("Budget: the port `walltime' must be a positive"
+                      " real"));
+            }
+        } else if (it->first == "bags") {
+            mBags = utils::toPortUnsigned(budget, it->first, "Budget");
+        } else if (it->first == "stall") {
+            mStall = utils::toPortUnsigned(budget, it->first, "Budget");
+        } else if (it->first == "requeue") {
+            const value::Value *value = utils::getPortValue(
+                budget, it->first, "Budget");
+
+            if (not value->isBoolean()) {
+                throw utils::ArgError(
+                    _("Budget: the port `requeue' must be a boolean"));
+            }
+
+            mRequeue = value->toBoolean().value();
+        } else {
+            throw utils::ArgError(
+                fmt(_("Budget: unknown port `%1%'")) % it->first);
+        }
+    }
+}
+
+}} // namespace vle manager
@@ -0,0 +1,108 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_BUDGET_HPP
+#define VLE_MANAGER_BUDGET_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/vpz/Conditions.hpp>
+#include <string>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::Budget limits the run of each simulation of the
+ * experimental frame, to keep a few pathological combinations from
+ * holding the whole experimental frame (see @c
+ * devs::RootCoordinator::setBudget). A simulation which reaches a limit
+ * is interrupted: its error code is @c manager::ERROR_BUDGET and its
+ * results are the partial results.
+ *
+ * The budget is described by the condition @c Budget::name() of the
+ * experiment. Its ports are optional:
+ * - @c walltime: a @c value::Double, the maximum wall-clock time of a
+ *   simulation in seconds.
+ * - @c bags: a @c value::Integer, the maximum number of bags of events
+ *   of a simulation.
+ * - @c stall: a @c value::Integer, the maximum number of successive bags
+ *   of events at the same time.
+ * - @c requeue: a @c value::Boolean. If true, the interrupted
+ *   combinations are simulated again without limit after the others.
+ *   Otherwise (the default), they are reported as errors and their
+ *   partial results are kept.
+ *
+ * @code
+ * <condition name="vle.budget">
+ *  <port name="walltime"><double>60</double></port>
+ *  <port name="stall"><integer>1000000</integer></port>
+ *  <port name="requeue"><boolean>true</boolean></port>
+ * </condition>
+ * @endcode
+ */
+class VLE_API Budget
+{
+public:
+    /**
+     * Build the budget from its condition.
+     *
+     * @param conditions The conditions of the experiment. The
+     * condition @c Budget::name() describes the budget.
+     *
+     * @throw utils::ArgError if the description is not valid.
+     */
+    Budget(const vpz::Conditions& conditions);
+
+    /**
+     * Get the name of the condition which describes the budget.
+     *
+     * @return "vle.budget".
+     */
+    static const std::string& name();
+
+    double walltime() const
+    { return mWalltime; }
+
+    uint64_t bags() const
+    { return mBags; }
+
+    uint64_t stall() const
+    { return mStall; }
+
+    bool requeue() const
+    { return mRequeue; }
+
+private:
+    double   mWalltime;
+    uint64_t mBags;
+    uint64_t mStall;
+    bool     mRequeue;
+};
+
+}} // namespace vle manager
+
+#endif
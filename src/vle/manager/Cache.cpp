@@ -0,0 +1,331 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Cache.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/value/Binary.hpp>
+#include <boost/filesystem.hpp>
+#include <glibmm/checksum.h>
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace vle { namespace manager {
+
+/*
+ * The size of a key: the hexadecimal SHA-256 digest.
+ */
+static const std::string::size_type cacheKeySize = 64;
+
+/*
+ * The eviction removes the least recently used results until the size
+ * is below this part of the capacity, to avoid an eviction at each
+ * new result.
+ */
+static const double cacheEvictionRatio = 0.9;
+
+static bool isKey(const std::string& name)
+{
+    return name.size() == cacheKeySize and
+        name.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+/*
+ * Append the content of a file to a checksum, or only its name if the
+ * file does not exist.
+ */
+static void updateFile(Glib::Checksum *checksum, const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+    checksum->update(filename);
+
+    if (file.is_open()) {
+        char buffer[65536];
+
+        while (file.read(buffer, sizeof(buffer)) or file.gcount() > 0) {
+            checksum->update(reinterpret_cast < const guchar* >(buffer),
+                             file.gcount());
+        }
+    }
+}
+
+Cache::Cache(const std::string& directory, uint64_t capacity)
+    : mDirectory(directory), mCapacity(capacity), mSize(0), mAccess(0)
+{
+    /*
+     * The time of the last access of a result is its modification
+     * time, the results are ordered by this time.
+     */
+    std::vector < std::pair < std::time_t, std::string > > results;
+
+    try {
+        fs::create_directories(directory);
+
+        for (fs::recursive_directory_iterator it(directory), end; it != end;
+             ++it) {
+            std::string name(it->path().filename().string());
+
+            if (fs::is_regular_file(it->status()) and isKey(name)) {
+                Entry entry;
+
+                entry.size = fs::file_size(it->path());
+                mEntries[name] = entry;
+                mSize += entry.size;
+
+                results.push_back(std::make_pair(
+                        fs::last_write_time(it->path()), name));
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        throw utils::FileError(
+            fmt(_("Cache: cannot open `%1%': %2%")) % directory % e.what());
+    }
+
+    std::sort(results.begin(), results.end());
+
+    for (std::vector < std::pair < std::time_t, std::string > >
+             ::const_iterator it = results.begin(); it != results.end();
+         ++it) {
+        mEntries[it->second].access = mAccess++;
+    }
+
+    evict();
+}
+
+std::string Cache::fingerprint(const vpz::Vpz& vpz)
+{
+    Glib::Checksum checksum(Glib::Checksum::CHECKSUM_SHA256);
+    std::ostringstream out;
+    const vpz::Project& project(vpz.project());
+    const vpz::Experiment& experiment(project.experiment());
+
+    /*
+     * The conditions are not a part of the fingerprint: the conditions
+     * of each combination are a part of its key, so the change of a
+     * condition only invalidates the combinations which use it.
+     */
+    out << std::showpoint
+        << std::fixed
+        << std::setprecision(std::numeric_limits < double >::digits10)
+        << project.model()
+        << project.dynamics()
+        << project.classes()
+        << experiment.name() << '\n'
+        << experiment.combination() << '\n'
+        << experiment.views();
+    checksum.update(out.str());
+
+    const vpz::Dynamics& dynamics(vpz.project().dynamics());
+
+    for (vpz::Dynamics::const_iterator it = dynamics.begin();
+         it != dynamics.end(); ++it) {
+        updateFile(&checksum, utils::ModuleManager::buildModuleFilename(
+                       it->second.package(), it->second.library(),
+                       utils::MODULE_DYNAMICS));
+    }
+
+    const vpz::Outputs& outputs(vpz.project().experiment().views().outputs());
+
+    for (vpz::Outputs::const_iterator it = outputs.begin();
+         it != outputs.end(); ++it) {
+        updateFile(&checksum, utils::ModuleManager::buildModuleFilename(
+                       it->second.package(), it->second.plugin(),
+                       utils::MODULE_OOV));
+    }
+
+    return checksum.get_string();
+}
+
+std::string Cache::key(const std::string& fingerprint,
+                       const vpz::Conditions& conditions)
+{
+    Glib::Checksum checksum(Glib::Checksum::CHECKSUM_SHA256);
+    std::ostringstream out;
+
+    conditions.write(out);
+    checksum.update(fingerprint);
+    checksum.update(out.str());
+
+    return checksum.get_string();
+}
+
+bool Cache::get(const std::string& key, value::Value **result)
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    EntryList::iterator it = mEntries.find(key);
+
+    if (it == mEntries.end()) {
+        return false;
+    }
+
+    std::string name(filename(key));
+    std::ifstream file(name.c_str(), std::ios::in | std::ios::binary);
+    std::string buffer((std::istreambuf_iterator < char >(file)),
+                       std::istreambuf_iterator < char >());
+
+    try {
+        std::string::size_type position = 0;
+
+        if (not file.is_open()) {
+            throw utils::FileError(
+                fmt(_("Cache: cannot open `%1%'")) % name);
+        }
+
+        *result = value::readBinary(buffer, &position);
+        it->second.access = mAccess++;
+        fs::last_write_time(name, std::time(0));
+    } catch (const std::exception& /*e*/) {
+        /*
+         * A missing or corrupted result is removed from the cache and
+         * the simulation is run again.
+         */
+        boost::system::error_code error;
+
+        mSize -= it->second.size;
+        mEntries.erase(it);
+        fs::remove(name, error);
+
+        return false;
+    }
+
+    return true;
+}
+
+void Cache::put(const std::string& key, const value::Value *result)
+{
+    std::string buffer;
+
+    value::writeBinary(result, &buffer);
+
+    boost::mutex::scoped_lock lock(mMutex);
+
+    std::string name(filename(key));
+    std::string temporary(name + ".tmp");
+
+    try {
+        fs::create_directories(fs::path(name).parent_path());
+
+        {
+            std::ofstream file(temporary.c_str(), std::ios::out |
+                               std::ios::binary | std::ios::trunc);
+
+            if (not file.write(buffer.data(), buffer.size())) {
+                throw utils::FileError(
+                    fmt(_("Cache: cannot write `%1%'")) % temporary);
+            }
+        }
+
+        fs::rename(temporary, name);
+    } catch (const fs::filesystem_error& e) {
+        throw utils::FileError(
+            fmt(_("Cache: cannot write `%1%': %2%")) % name % e.what());
+    }
+
+    EntryList::iterator it = mEntries.find(key);
+
+    if (it != mEntries.end()) {
+        mSize -= it->second.size;
+    } else {
+        it = mEntries.insert(std::make_pair(key, Entry())).first;
+    }
+
+    it->second.size = buffer.size();
+    it->second.access = mAccess++;
+    mSize += buffer.size();
+
+    evict();
+}
+
+void Cache::clear()
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    for (EntryList::const_iterator it = mEntries.begin();
+         it != mEntries.end(); ++it) {
+        fs::remove(filename(it->first));
+    }
+
+    mEntries.clear();
+    mSize = 0;
+}
+
+std::string Cache::filename(const std::string& key) const
+{
+    fs::path path(mDirectory);
+
+    path /= key.substr(0, 2);
+    path /= key;
+
+    return path.string();
+}
+
+void Cache::evict()
+{
+    if (mSize <= mCapacity or mEntries.empty()) {
+        return;
+    }
+
+    std::vector < std::pair < uint64_t, std::string > > entries;
+
+    entries.reserve(mEntries.size());
+    for (EntryList::const_iterator it = mEntries.begin();
+         it != mEntries.end(); ++it) {
+        entries.push_back(std::make_pair(it->second.access, it->first));
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    uint64_t target = static_cast < uint64_t >(mCapacity *
+                                               cacheEvictionRatio);
+
+    /*
+     * The most recently used result is kept even if it exceeds the
+     * capacity alone.
+     */
+    for (std::vector < std::pair < uint64_t, std::string > >
+             ::const_iterator it = entries.begin();
+         it + 1 != entries.end() and mSize > target; ++it) {
+        EntryList::iterator jt = mEntries.find(it->second);
+        boost::system::error_code error;
+
+        fs::remove(filename(it->second), error);
+        mSize -= jt->second.size;
+        mEntries.erase(jt);
+    }
+}
+
+}} // namespace vle manager
@@ -0,0 +1,173 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_CACHE_HPP
+#define VLE_MANAGER_CACHE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/value/Value.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <boost/thread/mutex.hpp>
+#include <string>
+#include <map>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::Cache stores the results of the simulations into a
+ * directory, indexed by a digest (SHA-256) of all the inputs of a
+ * simulation: the experimental frame, the values of the conditions of
+ * the combination (the seeds of the random generators are conditions)
+ * and the contents of the dynamics libraries. A simulation with the
+ * same inputs is not run again, its result is read from the cache.
+ *
+ * The cache is invalidated by the changes of its inputs: a package
+ * rebuilt with different dynamics libraries gives different digests
+ * and the old results are never read again. The cache is bounded: if
+ * the size of the results exceeds the capacity, the least recently
+ * used results are removed.
+ *
+ * The functions are thread safe.
+ *
+ * @code
+ * manager::Cache cache(utils::Path::path().getHomeFile("cache"),
+ *                      1024 * 1024 * 1024);
+ * std::string fingerprint = manager::Cache::fingerprint(vpz);
+ * std::string key = manager::Cache::key(fingerprint, conditions);
+ * value::Value *result;
+ *
+ * if (not cache.get(key, &result)) {
+ *     result = simulate(conditions);
+ *     cache.put(key, result);
+ * }
+ * @endcode
+ */
+class VLE_API Cache
+{
+public:
+    /**
+     * Open or create a cache.
+     *
+     * @param directory The directory of the cache.
+     * @param capacity The maximum size of the results in bytes.
+     *
+     * @throw utils::FileError if the directory can not be created.
+     */
+    Cache(const std::string& directory, uint64_t capacity);
+
+    /**
+     * Compute the digest of the inputs shared by all the combinations
+     * of an experimental frame: the experimental frame without its
+     * conditions (the models, the dynamics, the classes and the views)
+     * and the contents of its dynamics and output libraries. The
+     * conditions are hashed by @c key, so the change of a condition
+     * only invalidates the combinations which use it.
+     *
+     * @param vpz The experimental frame.
+     *
+     * @return The hexadecimal digest.
+     */
+    static std::string fingerprint(const vpz::Vpz& vpz);
+
+    /**
+     * Compute the key of a combination.
+     *
+     * @param fingerprint The digest of the experimental frame.
+     * @param conditions The conditions of the combination.
+     *
+     * @return The hexadecimal digest.
+     */
+    static std::string key(const std::string& fingerprint,
+                           const vpz::Conditions& conditions);
+
+    /**
+     * Read a result of the cache.
+     *
+     * @param key The key of the combination.
+     * @param[out] result The result (a new allocated value or null).
+     *
+     * @return true if the cache contains the key.
+     */
+    bool get(const std::string& key, value::Value **result);
+
+    /**
+     * Store a result into the cache and remove the least recently used
+     * results if the capacity is exceeded.
+     *
+     * @param key The key of the combination.
+     * @param result The result (can be null).
+     */
+    void put(const std::string& key, const value::Value *result);
+
+    /**
+     * Remove all the results of the cache.
+     */
+    void clear();
+
+    /**
+     * Get the size of the results of the cache.
+     *
+     * @return The size in bytes.
+     */
+    uint64_t size() const
+    { return mSize; }
+
+    /**
+     * Get the number of results of the cache.
+     *
+     * @return The number of results.
+     */
+    uint32_t entries() const
+    { return mEntries.size(); }
+
+private:
+    Cache(const Cache& other);
+    Cache& operator=(const Cache& other);
+
+    struct Entry
+    {
+        uint64_t size;
+        uint64_t access; /**< The order of the last access. */
+    };
+
+    typedef std::map < std::string, Entry > EntryList;
+
+    std::string filename(const std::string& key) const;
+    void evict();
+
+    boost::mutex mMutex;
+    std::string  mDirectory;
+    uint64_t     mCapacity;
+    uint64_t     mSize;
+    uint64_t     mAccess;
+    EntryList    mEntries;
+};
+
+}} // namespace vle manager
+
+#endif
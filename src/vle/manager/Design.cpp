@@ -0,0 +1,503 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Design.hpp>
+#include <vle/manager/TableFile.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Path.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/details/Tools.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <memory>
+#include <limits>
+#include <cmath>
+
+namespace vle { namespace manager {
+
+/*
+ * The primitive polynomials and the initial direction numbers of the
+ * Sobol sequence (S. Joe and F. Y. Kuo, 2008) for the dimensions 2 to
+ * 21. The first dimension is the van der Corput sequence.
+ */
+struct SobolDimension
+{
+    uint32_t degree;
+    uint32_t coefficients;
+    uint32_t directions[7];
+};
+
+static const SobolDimension sobolDimensions[] = {
+    { 1,  0, { 1 } },
+    { 2,  1, { 1, 3 } },
+    { 3,  1, { 1, 3, 1 } },
+    { 3,  2, { 1, 1, 1 } },
+    { 4,  1, { 1, 1, 3, 3 } },
+    { 4,  4, { 1, 3, 5, 13 } },
+    { 5,  2, { 1, 1, 5, 5, 17 } },
+    { 5,  4, { 1, 1, 5, 5, 5 } },
+    { 5,  7, { 1, 1, 7, 11, 19 } },
+    { 5, 11, { 1, 1, 5, 1, 1 } },
+    { 5, 13, { 1, 1, 1, 3, 11 } },
+    { 5, 14, { 1, 3, 5, 5, 31 } },
+    { 6,  1, { 1, 3, 3, 9, 7, 49 } },
+    { 6, 13, { 1, 1, 1, 15, 21, 21 } },
+    { 6, 16, { 1, 3, 1, 13, 27, 49 } },
+    { 6, 19, { 1, 1, 1, 15, 7, 5 } },
+    { 6, 22, { 1, 3, 1, 15, 13, 25 } },
+    { 6, 25, { 1, 1, 5, 5, 19, 61 } },
+    { 7,  1, { 1, 3, 7, 11, 23, 15, 103 } },
+    { 7,  4, { 1, 3, 7, 13, 13, 15, 69 } }
+};
+
+static const uint32_t sobolMaximumFactors =
+    1 + sizeof(sobolDimensions) / sizeof(SobolDimension);
+
+static uint64_t key(uint32_t seed, uint32_t factor, uint32_t round)
+{
+    return utils::mix((static_cast < uint64_t >(seed) << 32) ^
+                      (static_cast < uint64_t >(factor) << 8) ^ round);
+}
+
+/*
+ * Split the name of a factor into the condition and the port, which
+ * must exist.
+ */
+static void toFactor(const vpz::Conditions& conditions,
+                     const std::string& name,
+                     std::string *condition,
+                     std::string *port)
+{
+    std::string::size_type dot = name.rfind('.');
+
+    if (dot == std::string::npos or dot == 0 or dot + 1 == name.size()) {
+        throw utils::ArgError(
+            fmt(_("Design: the factor `%1%' is not a"
+                  " `condition.port' name")) % name);
+    }
+
+    *condition = name.substr(0, dot);
+    *port = name.substr(dot + 1);
+
+    if (*condition == Design::name() or
+        not conditions.exist(*condition) or
+        not conditions.get(*condition).conditionvalues().count(*port)) {
+        throw utils::ArgError(
+            fmt(_("Design: the factor `%1%' is not a port of the"
+                  " conditions")) % name);
+    }
+}
+
+const std::string& Design::name()
+{
+    static const std::string result("vle.design");
+
+    return result;
+}
+
+void Design::absolute(vpz::Conditions& conditions,
+                      const std::string& directory)
+{
+    if (directory.empty() or not conditions.exist(name())) {
+        return;
+    }
+
+    vpz::Condition& design(conditions.get(name()));
+    const vpz::ConditionValues& ports(design.conditionvalues());
+    vpz::ConditionValues::const_iterator it = ports.find("file");
+
+    /*
+     * An invalid port is reported by the constructor.
+     */
+    if (it == ports.end() or it->second->size() != 1 or
+        not it->second->get(0) or not it->second->get(0)->isString()) {
+        return;
+    }
+
+    std::string file(it->second->get(0)->toString().value());
+
+    if (not file.empty() and
+        not boost::filesystem::path(file).is_absolute()) {
+        design.setValueToPort("file", value::String(
+                utils::Path::buildFilename(directory, file)));
+    }
+}
+
+Design::Design(const vpz::Conditions& conditions,
+               const std::string& directory)
+    : mType(FACTORIAL), mSize(0), mSeed(0)
+{
+    const vpz::Condition& design(conditions.get(name()));
+    const vpz::ConditionValues& ports(design.conditionvalues());
+    std::string file;
+    bool hasSize = false;
+
+    for (vpz::ConditionValues::const_iterator it = ports.begin();
+         it != ports.end(); ++it) {
+        if (it->first == "type") {
+            const value::Set& values(*it->second);
+            std::string type;
+
+            if (values.size() == 1 and values.get(0) and
+                values.get(0)->isString()) {
+                type = values.get(0)->toString().value();
+            }
+
+            if (type == "factorial") {
+                mType = FACTORIAL;
+            } else if (type == "lhs") {
+                mType = LHS;
+            } else if (type == "sobol") {
+                mType = SOBOL;
+            } else if (type == "table") {
+                mType = TABLE;
+            } else {
+                throw utils::ArgError(
+                    fmt(_("Design: unknown type `%1%' (factorial, lhs,"
+                          " sobol or table)")) % type);
+            }
+        } else if (it->first == "size") {
+            mSize = static_cast < uint32_t >(
+                utils::toPortUnsigned(design, it->first, "Design"));
+            hasSize = true;
+        } else if (it->first == "seed") {
+            mSeed = static_cast < uint32_t >(
+                utils::toPortUnsigned(design, it->first, "Design"));
+        } else if (it->first == "file") {
+            const value::Set& values(*it->second);
+
+            if (values.size() != 1 or not values.get(0) or
+                not values.get(0)->isString()) {
+                throw utils::ArgError(
+                    _("Design: the port `file' must be a string"));
+            }
+
+            file = values.get(0)->toString().value();
+        } else {
+            Factor factor;
+            factor.min = 0.0;
+            factor.max = 0.0;
+
+            toFactor(conditions, it->first, &factor.condition, &factor.port);
+
+            const value::Set& values(*it->second);
+
+            if (values.size() == 1 and values.get(0) and
+                values.get(0)->isTuple()) {
+                const value::TupleValue& tuple(
+                    values.get(0)->toTuple().value());
+
+                if (tuple.size() == 2) {
+                    factor.min = tuple[0];
+                    factor.max = tuple[1];
+                } else if (tuple.size() == 3 and tuple[2] >= 1.0) {
+                    uint32_t number = static_cast < uint32_t >(tuple[2]);
+                    factor.levels.reset(value::Set::create());
+
+                    for (uint32_t i = 0; i < number; ++i) {
+                        factor.levels->add(value::Double::create(
+                                number == 1 ? tuple[0] : tuple[0] +
+                                (tuple[1] - tuple[0]) * i / (number - 1)));
+                    }
+                } else {
+                    throw utils::ArgError(
+                        fmt(_("Design: the range of the factor `%1%' must"
+                              " be (min, max) or (min, max, levels)"))
+                        % it->first);
+                }
+            } else if (values.size() > 0) {
+                factor.levels = it->second;
+            } else {
+                throw utils::ArgError(
+                    fmt(_("Design: the factor `%1%' has no level"))
+                    % it->first);
+            }
+
+            mFactors.push_back(factor);
+        }
+    }
+
+    if (mType == TABLE) {
+        if (not mFactors.empty()) {
+            throw utils::ArgError(
+                _("Design: the factors of a table design are the columns"
+                  " of its file"));
+        }
+
+        if (file.empty()) {
+            throw utils::ArgError(
+                _("Design: the table design needs a file"));
+        }
+
+        if (not directory.empty() and
+            not boost::filesystem::path(file).is_absolute()) {
+            file = utils::Path::buildFilename(directory, file);
+        }
+
+        readTable(conditions, file);
+
+        if (not hasSize or mSize == 0 or mSize > mTable->rows()) {
+            mSize = mTable->rows();
+        }
+
+        return;
+    } else if (not file.empty()) {
+        throw utils::ArgError(
+            _("Design: only the table design reads a file"));
+    }
+
+    if (mType == FACTORIAL) {
+        uint64_t size = mFactors.empty() ? 0 : 1;
+
+        for (std::vector < Factor >::const_iterator it = mFactors.begin();
+             it != mFactors.end(); ++it) {
+            if (not it->levels) {
+                throw utils::ArgError(
+                    fmt(_("Design: the factor `%1%.%2%' of a factorial"
+                          " design needs levels")) % it->condition
+                    % it->port);
+            }
+
+            size *= it->levels->size();
+
+            if (size > std::numeric_limits < uint32_t >::max()) {
+                throw utils::ArgError(
+                    _("Design: too many combinations in the factorial"
+                      " design"));
+            }
+        }
+
+        mSize = static_cast < uint32_t >(size);
+    } else if (not hasSize or mSize == 0) {
+        throw utils::ArgError(
+            _("Design: the lhs and sobol designs need a size"));
+    }
+
+    if (mType == SOBOL) {
+        if (mFactors.size() > sobolMaximumFactors) {
+            throw utils::ArgError(
+                fmt(_("Design: the sobol design accepts at most %1%"
+                      " factors")) % sobolMaximumFactors);
+        }
+
+        mDirections.resize(mFactors.size() * 32);
+
+        for (uint32_t k = 0; k < mFactors.size(); ++k) {
+            uint32_t *v = &mDirections[k * 32];
+
+            if (k == 0) {
+                for (uint32_t j = 0; j < 32; ++j) {
+                    v[j] = 1u << (31 - j);
+                }
+            } else {
+                const SobolDimension& dim(sobolDimensions[k - 1]);
+                uint32_t s = dim.degree;
+
+                for (uint32_t j = 0; j < s; ++j) {
+                    v[j] = dim.directions[j] << (31 - j);
+                }
+
+                for (uint32_t j = s; j < 32; ++j) {
+                    v[j] = v[j - s] ^ (v[j - s] >> s);
+
+                    for (uint32_t l = 1; l < s; ++l) {
+                        if ((dim.coefficients >> (s - 1 - l)) & 1) {
+                            v[j] ^= v[j - l];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Design::readTable(const vpz::Conditions& conditions,
+                       const std::string& filename)
+{
+    mTable.reset(new TableFile(filename));
+
+    for (std::vector < std::string >::const_iterator it =
+             mTable->columns().begin(); it != mTable->columns().end(); ++it) {
+        Factor factor;
+        factor.min = 0.0;
+        factor.max = 0.0;
+
+        toFactor(conditions, *it, &factor.condition, &factor.port);
+
+        if (isFactor(factor.condition, factor.port)) {
+            throw utils::ArgError(
+                fmt(_("Design: the column `%1%' is duplicated in `%2%'"))
+                % *it % filename);
+        }
+
+        mFactors.push_back(factor);
+    }
+}
+
+void Design::get(uint32_t index, vpz::Conditions *conditions) const
+{
+    if (index >= mSize) {
+        throw utils::ArgError(
+            fmt(_("Design: the combination %1% is out of the design (%2%)"))
+            % index % mSize);
+    }
+
+    if (mType == TABLE) {
+        std::auto_ptr < value::Set > row(mTable->row(index));
+
+        for (uint32_t k = 0; k < mFactors.size(); ++k) {
+            vpz::ConditionValueSet values(value::Set::create());
+            values->add(row->give(k));
+
+            conditions->get(mFactors[k].condition).setSetValues(
+                mFactors[k].port, values);
+        }
+
+        return;
+    }
+
+    for (uint32_t k = 0; k < mFactors.size(); ++k) {
+        vpz::ConditionValueSet values(value::Set::create());
+        values->add(value(mFactors[k], coordinate(index, k)));
+
+        conditions->get(mFactors[k].condition).setSetValues(
+            mFactors[k].port, values);
+    }
+}
+
+bool Design::isFactor(const std::string& condition,
+                      const std::string& port) const
+{
+    for (std::vector < Factor >::const_iterator it = mFactors.begin();
+         it != mFactors.end(); ++it) {
+        if (it->condition == condition and it->port == port) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+double Design::coordinate(uint32_t index, uint32_t factor) const
+{
+    switch (mType) {
+    case FACTORIAL: {
+        for (uint32_t k = 0; k < factor; ++k) {
+            index /= mFactors[k].levels->size();
+        }
+
+        uint32_t levels = mFactors[factor].levels->size();
+        return ((index % levels) + 0.5) / levels;
+    }
+    case LHS: {
+        double jitter = (utils::mix(key(mSeed, factor, 0xff) ^ index) >>
+                         11) * (1.0 / 9007199254740992.0);
+
+        return (permutation(index, factor) + jitter) / mSize;
+    }
+    case SOBOL: {
+        /*
+         * The first point of the sequence (the origin) is skipped, the
+         * point is computed from the Gray code of its index.
+         */
+        uint64_t number = static_cast < uint64_t >(index) + 1;
+        uint64_t gray = number ^ (number >> 1);
+        const uint32_t *v = &mDirections[factor * 32];
+        uint32_t x = 0;
+
+        for (uint32_t j = 0; gray; ++j, gray >>= 1) {
+            if (gray & 1) {
+                x ^= v[j];
+            }
+        }
+
+        return x * (1.0 / 4294967296.0);
+    }
+    case TABLE:
+        throw utils::ArgError(
+            _("Design: the combinations of a table design have no"
+              " coordinate"));
+    }
+
+    return 0.0;
+}
+
+value::Value * Design::value(const Factor& factor, double coordinate) const
+{
+    if (not factor.levels) {
+        return value::Double::create(
+            factor.min + (factor.max - factor.min) * coordinate);
+    }
+
+    value::Set::size_type size = factor.levels->size();
+    value::Set::size_type level = std::min(
+        size - 1, static_cast < value::Set::size_type >(coordinate * size));
+
+    const value::Value *result = factor.levels->get(level);
+    return result ? result->clone() : 0;
+}
+
+/*
+ * The permutation of the combinations of a factor of the latin
+ * hypercube is a four rounds Feistel network over the smallest power of
+ * four greater or equal to the size. The cycle walking restricts the
+ * permutation to [0, size[: the permutation is never stored.
+ */
+uint32_t Design::permutation(uint32_t index, uint32_t factor) const
+{
+    uint32_t half = 1;
+
+    while ((static_cast < uint64_t >(1) << (2 * half)) < mSize) {
+        ++half;
+    }
+
+    uint64_t mask = (static_cast < uint64_t >(1) << half) - 1;
+    uint64_t x = index;
+
+    do {
+        uint64_t left = x >> half;
+        uint64_t right = x & mask;
+
+        for (uint32_t round = 0; round < 4; ++round) {
+            uint64_t tmp = right;
+            right = left ^ (utils::mix(key(mSeed, factor, round) ^ right) &
+                            mask);
+            left = tmp;
+        }
+
+        x = (left << half) | right;
+    } while (x >= mSize);
+
+    return static_cast < uint32_t >(x);
+}
+
+}} // namespace vle manager
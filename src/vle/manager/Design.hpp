@@ -0,0 +1,196 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_DESIGN_HPP
+#define VLE_MANAGER_DESIGN_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/vpz/Conditions.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+namespace vle { namespace manager {
+
+class TableFile;
+
+/**
+ * @c manager::Design computes the combinations of an experimental
+ * design on demand from a compact description: the combination @e i is
+ * computed without computing or storing the others.
+ *
+ * The design is described by the condition @c Design::name() of the
+ * experiment. Its ports are:
+ * - @c type: a @c value::String, the type of the design: @e factorial
+ *   (full factorial design), @e lhs (latin hypercube sampling) or @e
+ *   sobol (Sobol quasi-random sequence) or @e table (the rows of an
+ *   external file).
+ * - @c size: a @c value::Integer, the number of combinations of the @e
+ *   lhs and @e sobol designs. The size of the @e factorial design is
+ *   the product of the number of levels of the factors. The size of
+ *   the @e table design is the number of rows of the file, or the
+ *   first @c size rows if @c size is not null (optional).
+ * - @c file: a @c value::String, the file of the @e table design (see
+ *   @c manager::TableFile). A relative name is relative to the
+ *   directory of the vpz file. The columns of the file are the
+ *   factors, named @e condition.port, and the combination @e i is the
+ *   row @e i: the file is mapped in memory and only the row of the
+ *   combination is read. The @e table design has no other factor.
+ * - @c seed: a @c value::Integer, the seed of the @e lhs design
+ *   (optional).
+ * - @c condition.port: a factor which assigns the port @e port of the
+ *   condition @e condition. A @c value::Tuple (min, max) defines a
+ *   continuous range of reals, a @c value::Tuple (min, max, n) defines
+ *   @e n levels regularly spaced from min to max and several values
+ *   define the levels of the factor. The @e factorial design accepts
+ *   only levels. The factors are sorted by name and, in the @e
+ *   factorial design, the levels of the first factor vary first.
+ *
+ * @code
+ * <condition name="vle.design">
+ *  <port name="type"><string>lhs</string></port>
+ *  <port name="size"><integer>1000000</integer></port>
+ *  <port name="seed"><integer>123</integer></port>
+ *  <port name="cond.alpha"><tuple>0.1 0.9</tuple></port>
+ *  <port name="cond.model"><string>a</string><string>b</string></port>
+ * </condition>
+ *
+ * <condition name="vle.design">
+ *  <port name="type"><string>table</string></port>
+ *  <port name="file"><string>plan.csv</string></port>
+ * </condition>
+ * @endcode
+ */
+class VLE_API Design
+{
+public:
+    enum Type { FACTORIAL, LHS, SOBOL, TABLE };
+
+    /**
+     * Build the design from its condition.
+     *
+     * @param conditions The conditions of the experiment. The
+     * condition @c Design::name() describes the design and the
+     * factors must be ports of the others conditions.
+     * @param directory The directory of the relative file of the @e
+     * table design.
+     *
+     * @throw utils::ArgError if the description is not valid or if the
+     * file of the @e table design cannot be read.
+     */
+    Design(const vpz::Conditions& conditions,
+           const std::string& directory = std::string());
+
+    /**
+     * Get the name of the condition which describes the design.
+     *
+     * @return "vle.design".
+     */
+    static const std::string& name();
+
+    /**
+     * Make the file of a @e table design absolute. A relative file is
+     * relative to the directory of the experimental frame, which is
+     * lost when the experimental frame is copied elsewhere (the worker
+     * processes of the @c manager::Manager read a temporary copy).
+     *
+     * @param conditions The conditions of the experiment.
+     * @param directory The directory of the experimental frame.
+     */
+    static void absolute(vpz::Conditions& conditions,
+                         const std::string& directory);
+
+    /**
+     * Assign the values of the factors of a combination.
+     *
+     * @param index The combination in [0, size()[.
+     * @param[out] conditions The conditions to update. The ports of
+     * the factors are replaced with a new @c value::Set.
+     */
+    void get(uint32_t index, vpz::Conditions *conditions) const;
+
+    /**
+     * Get the coordinate of a factor of a combination in the unit
+     * hypercube.
+     *
+     * @param index The combination in [0, size()[.
+     * @param factor The factor in [0, factors()[.
+     *
+     * @return A real in [0, 1[.
+     * @throw utils::ArgError with the @e table design.
+     */
+    double coordinate(uint32_t index, uint32_t factor) const;
+
+    /**
+     * Check if a port of a condition is a factor of the design.
+     *
+     * @param condition The name of the condition.
+     * @param port The name of the port.
+     *
+     * @return true if the port is assigned by the design.
+     */
+    bool isFactor(const std::string& condition,
+                  const std::string& port) const;
+
+    Type type() const
+    { return mType; }
+
+    uint32_t size() const
+    { return mSize; }
+
+    uint32_t factors() const
+    { return mFactors.size(); }
+
+private:
+    struct Factor
+    {
+        std::string            condition;
+        std::string            port;
+        vpz::ConditionValueSet levels; /**< Null for a continuous range. */
+        double                 min;
+        double                 max;
+    };
+
+    value::Value * value(const Factor& factor, double coordinate) const;
+    uint32_t permutation(uint32_t index, uint32_t factor) const;
+
+    void readTable(const vpz::Conditions& conditions,
+                   const std::string& filename);
+
+    std::vector < Factor >   mFactors;
+    std::vector < uint32_t > mDirections; /**< The direction numbers of
+                                           * the Sobol sequence. */
+    boost::shared_ptr < TableFile > mTable;
+    Type                     mType;
+    uint32_t                 mSize;
+    uint32_t                 mSeed;
+};
+
+}} // namespace vle manager
+
+#endif
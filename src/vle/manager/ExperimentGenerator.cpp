@@ -26,9 +26,17 @@
 
 
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/Design.hpp>
+#include <vle/manager/Replication.hpp>
+#include <vle/manager/Budget.hpp>
+#include <vle/manager/Streams.hpp>
+#include <vle/devs/Termination.hpp>
 #include <vle/vpz/Condition.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/BaseModel.hpp>
+#include <vle/utils/Path.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <limits>
 
 namespace vle { namespace manager {
 
@@ -52,9 +60,21 @@ class ExperimentGenerator::Pimpl
             const vpz::Condition& cnd(it->second);
             vpz::ConditionValues::const_iterator jt;
 
+            if (it->first == Design::name() or
+                it->first == Replication::name() or
+                it->first == Budget::name() or
+                it->first == Streams::name() or
+                it->first == devs::Termination::name()) {
+                ++it;
+                continue;
+            }
+
             if (not cnd.conditionvalues().empty()) {
                 for (jt = cnd.conditionvalues().begin(); jt !=
                      cnd.conditionvalues().end(); ++jt) {
+                    if (mDesign and mDesign->isFactor(it->first, jt->first)) {
+                        continue;
+                    }
 
                     int conditionsize = jt->second->size();
 
@@ -78,9 +98,49 @@ class ExperimentGenerator::Pimpl
         return result;
     }
 
+    /*
+     * With a design, the combinations of the design are crossed with
+     * the combinations of the conditions: the combination @e i uses
+     * the combination @e i / mLinearSize of the design and the
+     * combination @e i % mLinearSize of the conditions.
+     */
     void computeRange()
     {
+        const vpz::Conditions& cnds(mVpz.project().experiment().conditions());
+
+        if (cnds.exist(Design::name())) {
+            mDesign.reset(new Design(cnds, mVpz.filename().empty() ?
+                                     std::string() :
+                                     utils::Path::dirname(mVpz.filename())));
+        }
+
+        if (cnds.exist(Replication::name())) {
+            mReplication.reset(new Replication(cnds));
+        }
+
+        if (cnds.exist(Budget::name())) {
+            mBudget.reset(new Budget(cnds));
+        }
+
+        if (cnds.exist(Streams::name())) {
+            mStreams.reset(new Streams(cnds));
+        }
+
         mCompleteSize = computeMaximumValue();
+        mLinearSize = std::max(mCompleteSize, (uint32_t)1);
+
+        if (mDesign) {
+            uint64_t size = static_cast < uint64_t >(mDesign->size()) *
+                mLinearSize;
+
+            if (size > std::numeric_limits < uint32_t >::max()) {
+                throw utils::InternalError(
+                    fmt(_("ExperimentGenerator: too many combinations"
+                          " (%1%)")) % size);
+            }
+
+            mCompleteSize = static_cast < uint32_t >(size);
+        }
 
         uint32_t number = mCompleteSize / mWorld;
         uint32_t modulo = mCompleteSize % mWorld;
@@ -98,10 +158,15 @@ public:
     uint32_t mCompleteSize;
     uint32_t mMin;
     uint32_t mMax;
+    uint32_t mLinearSize;
+    boost::scoped_ptr < Design > mDesign;
+    boost::scoped_ptr < Replication > mReplication;
+    boost::scoped_ptr < Budget > mBudget;
+    boost::scoped_ptr < Streams > mStreams;
 
     Pimpl(const std::string& filename, uint32_t rank, uint32_t size)
         : mVpz(filename), mRank(rank), mWorld(size), mCompleteSize(0), mMin(0),
-        mMax(0)
+        mMax(0), mLinearSize(1)
     {
         if (rank >= size) {
             throw utils::InternalError(_("Bad rank"));
@@ -112,7 +177,7 @@ public:
 
     Pimpl(const vpz::Vpz& vpz, uint32_t rank, uint32_t size)
         : mVpz(vpz), mRank(rank), mWorld(size), mCompleteSize(0), mMin(0),
-        mMax(0)
+        mMax(0), mLinearSize(1)
     {
         if (rank >= size) {
             throw utils::InternalError(_("Bad rank"));
@@ -132,37 +197,58 @@ public:
         conditions->deleteValueSet();
         vpz::ConditionList& cdldst(conditions->conditionlist());
 
+        uint32_t design = 0;
+        if (mDesign) {
+            design = index / mLinearSize;
+            index = index % mLinearSize;
+        }
+
         vpz::ConditionList::const_iterator it;
         for (it = cnds.begin(); it != cnds.end(); ++it) {
+            if ((mDesign and it->first == Design::name()) or
+                it->first == Replication::name() or
+                it->first == Budget::name() or
+                it->first == Streams::name() or
+                it->first == devs::Termination::name()) {
+                continue;
+            }
 
             std::pair < vpz::ConditionList::iterator, bool > r =
                 cdldst.insert(std::make_pair(
                         it->first, vpz::Condition(it->first)));
 
             const vpz::ConditionValues& cnvsrc = it->second.conditionvalues();
-            vpz::ConditionValues& cnvdst = r.first->second.conditionvalues();
+            vpz::Condition& cnddst = r.first->second;
 
             for (vpz::ConditionValues::const_iterator jt = cnvsrc.begin();
                  jt != cnvsrc.end(); ++jt) {
 
-                value::Set *cpy = new value::Set();
-
-                if (jt->second->size() == 1) {
-                    cpy->add(jt->second->get(0)->clone());
+                /*
+                 * A port with only one value is shared by all the
+                 * experiments, the values are never cloned. The
+                 * factors of the design are assigned at the end.
+                 */
+                if (mDesign and mDesign->isFactor(it->first, jt->first)) {
+                    continue;
+                } else if (jt->second->size() == 1) {
+                    cnddst.setSetValues(jt->first, jt->second);
                 } else if (jt->second->size() > 1 and jt->second->size() >
                            index) {
+                    vpz::ConditionValueSet cpy(value::Set::create());
                     cpy->add(jt->second->get(index)->clone());
+                    cnddst.setSetValues(jt->first, cpy);
                 } else {
                     throw utils::InternalError(fmt(
                             _("ExperimentGenerator can not access to the index"
                               " `%1%' of the condition `%2%' port `%3%' ")) %
                         index % it->first % jt->first);
                 }
-
-                delete cnvdst[jt->first];
-                cnvdst[jt->first] = cpy;
             }
         }
+
+        if (mDesign) {
+            mDesign->get(design, conditions);
+        }
     }
 };
 
@@ -208,4 +294,19 @@ uint32_t ExperimentGenerator::size() const
     return mPimpl->mCompleteSize;
 }
 
+const Replication * ExperimentGenerator::replication() const
+{
+    return mPimpl->mReplication.get();
+}
+
+const Budget * ExperimentGenerator::budget() const
+{
+    return mPimpl->mBudget.get();
+}
+
+const Streams * ExperimentGenerator::streams() const
+{
+    return mPimpl->mStreams.get();
+}
+
 }}  // namespace vle manager
@@ -36,6 +36,10 @@
 
 namespace vle { namespace manager {
 
+class Replication;
+class Budget;
+class Streams;
+
 /**
  * ExperimentGenerator build @e vpz::Conditions from an experimental frame.
  *
@@ -58,6 +62,23 @@ namespace vle { namespace manager {
  * }
  * @endcode
  *
+ * If the experiment has a condition @c manager::Design::name(), the
+ * combinations of the experimental design are computed on demand (see
+ * @c manager::Design) and crossed with the combinations of the others
+ * conditions. Only the description of the design is stored, whatever
+ * its size, or the external table of the @e table design, mapped in
+ * memory and shared by the threads.
+ *
+ * If the experiment has a condition @c manager::Replication::name(), it
+ * describes the replicates of each combination (see @c
+ * manager::Replication). This condition is not a part of the
+ * combinations. Likewise, the condition @c manager::Budget::name()
+ * describes the limits of the simulations (see @c manager::Budget), the
+ * condition @c manager::Streams::name() the seeds of the simulations
+ * (see @c manager::Streams) and the condition @c
+ * devs::Termination::name() the predicates which end the simulations
+ * early (see @c devs::Termination).
+ *
  * The class ExperimentGenerator is no copyable and nonassignable and uses the
  * Pimpl idiom.
  */
@@ -118,6 +139,29 @@ public:
      */
     uint32_t size() const;
 
+    /**
+     * Get the replication of the combinations.
+     *
+     * @return The replication or null if each combination is simulated
+     * once.
+     */
+    const Replication * replication() const;
+
+    /**
+     * Get the budget of the simulations.
+     *
+     * @return The budget or null if the simulations are not limited.
+     */
+    const Budget * budget() const;
+
+    /**
+     * Get the random streams of the simulations.
+     *
+     * @return The streams or null if the simulations are seeded with 0
+     * or by the replication.
+     */
+    const Streams * streams() const;
+
 private:
     ExperimentGenerator(const ExperimentGenerator& other);
     ExperimentGenerator& operator=(const ExperimentGenerator& other);
@@ -0,0 +1,269 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Journal.hpp>
+#include <vle/manager/ResultStore.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Path.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/lexical_cast.hpp>
+#include <sstream>
+
+namespace vle { namespace manager {
+
+/*
+ * The journal is a text file of lines [index]\t[status]\t[store]\n. The
+ * store is the result store relative to the directory of the journal
+ * or "-". A line without end of line (the writer was interrupted) is
+ * ignored.
+ */
+static const char *journalSuccess = "success";
+static const char *journalFailure = "failure";
+static const char *journalNoStore = "-";
+
+/*
+ * Get the name of the result store of a session: @e base.res for the
+ * first session, then the first free name in @e base.1.res, @e
+ * base.2.res etc.
+ */
+static std::string journalStore(const std::string& filename, bool resume)
+{
+    std::string base(filename);
+    std::string::size_type extension = base.rfind(".journal");
+
+    if (extension != std::string::npos and
+        extension + 8 == base.size()) {
+        base.erase(extension);
+    }
+
+    std::string store(base + ".res");
+
+    if (resume) {
+        for (uint32_t i = 1; utils::Path::exist(store); ++i) {
+            store = base + "." + boost::lexical_cast < std::string >(i)
+                + ".res";
+        }
+    }
+
+    return store;
+}
+
+Journal::Journal(const std::string& filename, bool resume, bool store)
+    : mFilename(filename), mCompleted(0)
+{
+    bool newline = false;
+
+    if (resume and utils::Path::existFile(filename)) {
+        newline = read();
+    }
+
+    mFile.open(filename.c_str(), resume ? std::ios::out | std::ios::app :
+               std::ios::out | std::ios::trunc);
+
+    if (not mFile.is_open()) {
+        throw utils::FileError(
+            fmt(_("Journal: cannot open `%1%'")) % filename);
+    }
+
+    if (newline) {
+        mFile << '\n';
+    }
+
+    if (store) {
+        std::string storename(journalStore(filename, resume));
+
+        mWriter.reset(new ResultWriter(storename));
+        mStore = utils::Path::filename(storename);
+    }
+}
+
+Journal::~Journal()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+
+    for (ReaderList::iterator it = mReaders.begin(); it != mReaders.end();
+         ++it) {
+        delete it->second;
+    }
+}
+
+bool Journal::find(uint32_t index, value::Value **result)
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    EntryList::const_iterator it = mEntries.find(index);
+
+    if (it == mEntries.end()) {
+        return false;
+    }
+
+    if (result) {
+        *result = 0;
+
+        if (it->second.empty()) {
+            return false;
+        }
+
+        ReaderList::iterator jt = mReaders.find(it->second);
+
+        if (jt == mReaders.end()) {
+            std::string dir(utils::Path::dirname(mFilename));
+            ResultReader *reader = 0;
+
+            /*
+             * The result store of a crashed run can be missing or
+             * truncated: its combinations are not found (a null reader)
+             * and they are simulated again.
+             */
+            try {
+                reader = new ResultReader(
+                    dir.empty() ? it->second :
+                    utils::Path::buildFilename(dir, it->second));
+            } catch (const std::exception& /*e*/) {
+            }
+
+            jt = mReaders.insert(std::make_pair(it->second, reader)).first;
+        }
+
+        if (not jt->second) {
+            return false;
+        }
+
+        try {
+            *result = jt->second->read(index);
+        } catch (const std::exception& /*e*/) {
+            *result = 0;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Journal::success(uint32_t index, const value::Value *result)
+{
+    std::string binary;
+
+    if (mWriter) {
+        value::writeBinary(result, &binary);
+    }
+
+    success(index, binary);
+}
+
+void Journal::success(uint32_t index, const std::string& binary)
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    if (mWriter) {
+        mWriter->write(index, binary);
+        mWriter->flush();
+        write(index, true, mStore);
+    } else {
+        write(index, true, journalNoStore);
+    }
+}
+
+void Journal::failure(uint32_t index)
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    write(index, false, journalNoStore);
+}
+
+void Journal::close()
+{
+    boost::mutex::scoped_lock lock(mMutex);
+
+    if (mWriter) {
+        mWriter->close();
+    }
+
+    if (mFile.is_open()) {
+        mFile.close();
+    }
+}
+
+bool Journal::read()
+{
+    std::ifstream in(mFilename.c_str());
+    std::string line;
+    bool newline = false;
+
+    if (not in.is_open()) {
+        throw utils::FileError(
+            fmt(_("Journal: cannot open `%1%'")) % mFilename);
+    }
+
+    while (std::getline(in, line)) {
+        if (in.eof()) {
+            newline = true;
+            break;
+        }
+
+        std::istringstream fields(line);
+        uint32_t index;
+        std::string status, store;
+
+        if (not (fields >> index >> status >> store)) {
+            continue;
+        }
+
+        if (status == journalSuccess) {
+            mEntries[index] = store == journalNoStore ? std::string() : store;
+        } else if (status == journalFailure) {
+            mEntries.erase(index);
+        }
+    }
+
+    mCompleted = mEntries.size();
+
+    return newline;
+}
+
+void Journal::write(uint32_t index, bool success, const std::string& store)
+{
+    if (not mFile.is_open()) {
+        throw utils::FileError(
+            fmt(_("Journal: `%1%' is closed")) % mFilename);
+    }
+
+    mFile << index << '\t' << (success ? journalSuccess : journalFailure)
+          << '\t' << store << '\n';
+    mFile.flush();
+
+    if (not mFile.good()) {
+        throw utils::FileError(
+            fmt(_("Journal: cannot write into `%1%'")) % mFilename);
+    }
+}
+
+}} // namespace vle manager
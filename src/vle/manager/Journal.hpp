@@ -0,0 +1,173 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_JOURNAL_HPP
+#define VLE_MANAGER_JOURNAL_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/value/Value.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <fstream>
+#include <string>
+#include <map>
+
+namespace vle { namespace manager {
+
+class ResultWriter;
+class ResultReader;
+
+/**
+ * @c manager::Journal records the completed combinations of an
+ * experimental frame into an append-only text file, to resume an
+ * interrupted campaign. A line of the journal is the combination, its
+ * status (@e success or @e failure) and the result store of its result
+ * (@e - if the result is not stored), separated by tabulations.
+ *
+ * The results are written into the result stores next to the journal
+ * (see @c manager::ResultWriter): @e name.res for the first run of the
+ * journal @e name.journal, then @e name.1.res, @e name.2.res etc. for
+ * the resumed runs.
+ *
+ * The functions are thread safe.
+ *
+ * @code
+ * manager::Journal journal("exp.journal", true, true);
+ *
+ * for (uint32_t i = 0; i < size; ++i) {
+ *     value::Value *result;
+ *
+ *     if (not journal.find(i, &result)) {
+ *         result = simulate(i);
+ *         journal.success(i, result);
+ *     }
+ * }
+ * @endcode
+ */
+class VLE_API Journal
+{
+public:
+    /**
+     * Open a journal.
+     *
+     * @param filename The name of the journal.
+     * @param resume If true, the journal is read and the new lines are
+     * appended, otherwise the journal is truncated.
+     * @param store If true, the results are written into a result
+     * store.
+     *
+     * @throw utils::FileError if the journal or the result store can
+     * not be opened.
+     */
+    Journal(const std::string& filename, bool resume, bool store);
+
+    ~Journal();
+
+    /**
+     * Check if a combination was completed with success by a previous
+     * run and read its result.
+     *
+     * @param index The combination.
+     * @param[out] result If not null, the result of the combination (a
+     * new allocated value). A combination whose result is not stored
+     * (@e -) or can not be read (a missing or truncated result store)
+     * is not found: it is simulated again to get its result.
+     *
+     * @return true if the combination was completed with success.
+     */
+    bool find(uint32_t index, value::Value **result);
+
+    /**
+     * Record a combination completed with success and store its
+     * result.
+     *
+     * @param index The combination.
+     * @param result The result of the combination (can be null).
+     */
+    void success(uint32_t index, const value::Value *result);
+
+    /**
+     * Record a combination completed with success and store the binary
+     * representation of its result (see @c value::writeBinary).
+     *
+     * @param index The combination.
+     * @param binary The binary representation of the result.
+     */
+    void success(uint32_t index, const std::string& binary);
+
+    /**
+     * Record a combination completed with failure. The combination is
+     * simulated again by the next resumed run.
+     *
+     * @param index The combination.
+     */
+    void failure(uint32_t index);
+
+    /**
+     * Get the number of combinations completed with success by the
+     * previous runs.
+     *
+     * @return The number of combinations.
+     */
+    uint32_t completed() const
+    { return mCompleted; }
+
+    /**
+     * Close the journal and the result store.
+     *
+     * @throw utils::FileError if the result store can not be written.
+     */
+    void close();
+
+private:
+    Journal(const Journal& other);
+    Journal& operator=(const Journal& other);
+
+    bool read();
+    void write(uint32_t index, bool success, const std::string& store);
+
+    /**
+     * The result store of a combination completed with success by a
+     * previous run or an empty string if the result is not stored.
+     */
+    typedef std::map < uint32_t, std::string > EntryList;
+    typedef std::map < std::string, ResultReader* > ReaderList;
+
+    boost::mutex                     mMutex;
+    std::string                      mFilename;
+    std::ofstream                    mFile;
+    EntryList                        mEntries;
+    ReaderList                       mReaders;
+    boost::scoped_ptr < ResultWriter > mWriter;
+    std::string                      mStore;
+    uint32_t                         mCompleted;
+};
+
+}} // namespace vle manager
+
+#endif
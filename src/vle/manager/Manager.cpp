@@ -31,168 +31,2132 @@
 #endif
 
 #include <vle/manager/Manager.hpp>
+#include <vle/manager/Admission.hpp>
+#include <vle/manager/Budget.hpp>
+#include <vle/manager/Cache.hpp>
+#include <vle/manager/Design.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/Journal.hpp>
+#include <vle/manager/Replication.hpp>
+#include <vle/manager/Scheduler.hpp>
+#include <vle/manager/Streams.hpp>
 #include <vle/manager/Simulation.hpp>
+#include <vle/manager/Statistics.hpp>
+#include <vle/devs/RootCoordinator.hpp>
+#include <vle/utils/Path.hpp>
+#include <vle/utils/Spawn.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Trace.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Set.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/BaseModel.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+#if defined _WIN32 || defined __CYGWIN__
+# include <io.h>
+# include <fcntl.h>
+#else
+# include <unistd.h>
+# include <poll.h>
+# include <signal.h>
+# include <sys/wait.h>
+# include <cerrno>
+#endif
+
+#if defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+#endif
 
 namespace vle { namespace manager {
 
 /**
- * Assign an new name to the experiment.
+ * Build the name of an experiment.
  *
- * This function assign a new name to the experiment file.
+ * This function builds the name of the experiment of a combination.
  *
- * @param destination The experiment where change the name.
  * @param name The base name of the experiment.
  * @param number The combination number.
+ *
+ * @return The name of the experiment.
  */
-static void setExperimentName(vpz::Vpz           *destination,
-                              const std::string&  name,
-                              uint32_t            number)
+static std::string getExperimentName(const std::string& name,
+                                     uint32_t           number)
 {
     std::string result(name.size() + 12, '-');
 
-    result.replace(0, name.size(), name);
-    result.replace(name.size() + 1, std::string::npos,
-                   utils::to < uint32_t >(number));
+    result.replace(0, name.size(), name);
+    result.replace(name.size() + 1, std::string::npos,
+                   utils::to < uint32_t >(number));
+
+    return result;
+}
+
+/**
+ * Pin the calling thread to a processor.
+ *
+ * The @c index of the thread is used modulo the number of processors.
+ * This function does nothing on the systems without thread affinity.
+ *
+ * @param index The index of the thread.
+ */
+static void pinThread(uint32_t index)
+{
+#if defined(__linux__)
+    unsigned int cpus = boost::thread::hardware_concurrency();
+
+    if (cpus > 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(index % cpus, &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    }
+#else
+    (void)index;
+#endif
+}
+
+/**
+ * The @c Queue gives a list of combinations to the threads, the
+ * combinations interrupted by their budget and requeued for example.
+ * The results are given to another @c Source.
+ */
+class Queue : public Source
+{
+public:
+    Queue(const std::vector < uint32_t >& indices, Source& target)
+        : mIndices(indices), mNext(0), mTarget(target)
+    {
+    }
+
+    virtual bool next(uint32_t /*thread*/, uint32_t *index)
+    {
+        boost::mutex::scoped_lock lock(mMutex);
+
+        if (mNext >= mIndices.size()) {
+            return false;
+        }
+
+        *index = mIndices[mNext++];
+        return true;
+    }
+
+    virtual void result(uint32_t index, value::Value *result)
+    {
+        mTarget.result(index, result);
+    }
+
+private:
+    boost::mutex                               mMutex;
+    const std::vector < uint32_t >&            mIndices;
+    std::vector < uint32_t >::size_type        mNext;
+    Source&                                    mTarget;
+};
+
+/**
+ * The @c Admitted runs a simulation under the admission control of the
+ * threads (see @c Manager::setMemory): the simulation waits until the
+ * memory budget allows it and ends with the scope.
+ */
+class Admitted
+{
+public:
+    Admitted(Admission *admission)
+        : mAdmission(admission), mStart(0)
+    {
+        if (mAdmission) {
+            mAdmission->acquire();
+            mStart = Admission::resident();
+        }
+    }
+
+    ~Admitted()
+    {
+        if (mAdmission) {
+            mAdmission->release(mStart);
+        }
+    }
+
+private:
+    Admitted(const Admitted& other);
+    Admitted& operator=(const Admitted& other);
+
+    Admission *mAdmission;
+    uint64_t   mStart;
+};
+
+/**
+ * The @c WorkerResult stores the errors of the simulations of a
+ * thread and the combinations to simulate again without budget.
+ */
+struct WorkerResult
+{
+    typedef std::vector < std::pair < uint32_t, std::string > > ErrorList;
+
+    ErrorList                errors;
+    std::vector < uint32_t > requeued;
+};
+
+/**
+ * The @c Results stores the results of the simulations as soon as they
+ * are available. Depending on the simulation options, the results are
+ * stored into a matrix with a cell by combination (and a row by
+ * replicate), folded into a @c manager::Reduction or deleted. The @c
+ * add function can be called by several threads.
+ */
+class Results
+{
+public:
+    Results(SimulationOptions              options,
+            const std::vector < double >&  probabilities,
+            uint32_t                       min,
+            uint32_t                       size)
+        : mResult(0), mMin(min)
+    {
+        if (not (options & manager::SIMULATION_NO_RETURN)) {
+            if (options & manager::SIMULATION_REDUCE) {
+                mReduction.reset(new Reduction(probabilities));
+                mResult = new value::Matrix(1, 1, 1, 1);
+            } else {
+                mResult = new value::Matrix(size, 1, size, 1);
+            }
+        }
+    }
+
+    ~Results()
+    {
+        delete mResult;
+    }
+
+    /**
+     * Store the result of a combination.
+     *
+     * @param index The combination.
+     * @param simresult The result of the simulation or the @c
+     * value::Set of the results of the replicates, @c Results takes
+     * the ownership.
+     * @param partial true if the simulation is interrupted by its
+     * budget: the partial result is stored but not folded into the
+     * reduction.
+     */
+    void add(uint32_t index, value::Value *simresult, bool partial = false)
+    {
+        std::auto_ptr < value::Value > value(simresult);
+
+        if (not mResult or not simresult or (partial and mReduction)) {
+            return;
+        }
+
+        boost::mutex::scoped_lock lock(mMutex);
+
+        if (not simresult->isSet()) {
+            add(index, 0, value.release());
+        } else {
+            value::Set& replicates(simresult->toSet());
+
+            for (value::Set::size_type i = 0; i < replicates.size(); ++i) {
+                add(index, i, replicates.give(i));
+            }
+        }
+    }
+
+    /**
+     * Release the result matrix, the summary of the reduction is
+     * stored into its only cell.
+     *
+     * @return The result matrix or null with SIMULATION_NO_RETURN.
+     */
+    value::Matrix * release()
+    {
+        value::Matrix *result = mResult;
+
+        if (mReduction) {
+            result->add(0, 0, mReduction->summary());
+        }
+
+        mResult = 0;
+        return result;
+    }
+
+private:
+    Results(const Results& other);
+    Results& operator=(const Results& other);
+
+    void add(uint32_t index, value::Matrix::size_type row,
+             value::Value *simresult)
+    {
+        std::auto_ptr < value::Value > value(simresult);
+
+        if (mReduction) {
+            if (simresult and simresult->isMap()) {
+                mReduction->add(simresult->toMap());
+            }
+        } else {
+            while (mResult->rows() <= row) {
+                mResult->addRow();
+            }
+
+            mResult->add(index - mMin, row, value.release());
+        }
+    }
+
+    boost::mutex                   mMutex;
+    value::Matrix                 *mResult;
+    boost::scoped_ptr < Reduction > mReduction;
+    uint32_t                       mMin;
+};
+
+/**
+ * The @c Frame is an experimental frame simulated by the threads of
+ * the @c Manager. The threads can share several frames: the
+ * combinations of the frames are numbered one after the other, the
+ * combination @e i of a frame is the combination @e offset + @e i of
+ * the threads.
+ */
+struct Frame
+{
+    Frame(vpz::Vpz            *vpz,
+          ExperimentGenerator *expgen,
+          Results             *results,
+          Journal             *journal,
+          Cache               *cache,
+          const std::string&   fingerprint,
+          uint32_t             offset)
+        : vpz(vpz), expgen(expgen), results(results), journal(journal),
+          cache(cache), fingerprint(fingerprint), offset(offset)
+    {
+    }
+
+    vpz::Vpz            *vpz;
+    ExperimentGenerator *expgen;
+    Results             *results;
+    Journal             *journal;
+    Cache               *cache;
+    std::string          fingerprint;
+    uint32_t             offset;
+};
+
+/**
+ * Find the frame of a combination of the threads.
+ *
+ * @param frames The frames sorted by offset.
+ * @param index The combination of the threads.
+ *
+ * @return The index of the frame.
+ */
+static std::vector < Frame >::size_type findFrame(
+    const std::vector < Frame >& frames, uint32_t index)
+{
+    std::vector < Frame >::size_type first = 0;
+    std::vector < Frame >::size_type last = frames.size();
+
+    while (last - first > 1) {
+        std::vector < Frame >::size_type middle = first + (last - first) / 2;
+
+        if (frames[middle].offset <= index) {
+            first = middle;
+        } else {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+/**
+ * Find the result of a combination completed by a previous run (in the
+ * journal) or of a simulation with the same inputs (in the cache). A
+ * result found in the cache is recorded into the journal. If the
+ * results are returned, a combination of the journal whose result is
+ * not stored is not found and is simulated again.
+ *
+ * @param journal The journal (can be null).
+ * @param cache The cache (can be null).
+ * @param key The key of the combination in the cache.
+ * @param index The combination.
+ * @param options The simulation options.
+ * @param[out] result The result found (can be null).
+ *
+ * @return true if the result is found.
+ */
+static bool find(Journal            *journal,
+                 Cache              *cache,
+                 const std::string&  key,
+                 uint32_t            index,
+                 SimulationOptions   options,
+                 value::Value      **result)
+{
+    *result = 0;
+
+    if (journal and journal->find(
+            index, options & manager::SIMULATION_NO_RETURN ? 0 : result)) {
+        return true;
+    }
+
+    if (cache and cache->get(key, result)) {
+        if (journal) {
+            journal->success(index, *result);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Record the end of a simulation into the journal and its result into
+ * the cache. A simulation whose end cannot be recorded fails.
+ *
+ * @param journal The journal (can be null).
+ * @param cache The cache (can be null).
+ * @param key The key of the combination in the cache.
+ * @param index The combination.
+ * @param[in,out] error The error of the simulation.
+ * @param result The result of the simulation (can be null).
+ */
+static void record(Journal            *journal,
+                   Cache              *cache,
+                   const std::string&  key,
+                   uint32_t            index,
+                   Error              *error,
+                   const value::Value *result)
+{
+    try {
+        if (error->code) {
+            if (journal) {
+                journal->failure(index);
+            }
+        } else {
+            if (journal) {
+                journal->success(index, result);
+            }
+
+            if (cache) {
+                cache->put(key, result);
+            }
+        }
+    } catch (const std::exception& e) {
+        error->code = -1;
+        error->message = e.what();
+    }
+}
+
+/**
+ * Compute the key of a combination in the cache. The seeds of the
+ * replicates of @c manager::Replication without streams and the seeds
+ * of the independent streams (see @c manager::Streams::common) are
+ * derived from the index of the combination: the index is a part of
+ * the key, so two identical rows of the experimental frame do not share
+ * their results.
+ *
+ * @param fingerprint The digest of the experimental frame.
+ * @param expgen The combinations of the experimental frame.
+ * @param conditions The conditions of the combination.
+ * @param index The combination.
+ *
+ * @return The key of the combination.
+ */
+static std::string getKey(const std::string&         fingerprint,
+                          const ExperimentGenerator& expgen,
+                          const vpz::Conditions&     conditions,
+                          uint32_t                   index)
+{
+    if ((expgen.replication() and not expgen.streams()) or
+        (expgen.streams() and not expgen.streams()->common())) {
+        return Cache::key(fingerprint + '/' + utils::to < uint32_t >(index),
+                          conditions);
+    }
+
+    return Cache::key(fingerprint, conditions);
+}
+
+/**
+ * Build the simulation used by a thread or a process for all its
+ * combinations. With the option @c SIMULATION_REUSE_MODELS, the models
+ * are kept between the simulations and reset when they support it (see
+ * @c Simulation::setReuse). The results are
+ * always returned by the simulation to get the observations of the
+ * replicates.
+ *
+ * @param logoptions The log options of the simulations.
+ * @param simulationoptions The simulation options.
+ * @param budget The budget of the simulations (can be null).
+ *
+ * @return The simulation to freed.
+ */
+static Simulation * makeSimulation(LogOptions        logoptions,
+                                   SimulationOptions simulationoptions,
+                                   const Budget     *budget)
+{
+    Simulation *sim = new Simulation(
+        logoptions, simulationoptions & ~manager::SIMULATION_NO_RETURN, NULL);
+
+    sim->setReuse(simulationoptions & manager::SIMULATION_REUSE_MODELS);
+
+    if (budget) {
+        sim->setBudget(budget->walltime(), budget->bags(), budget->stall());
+    }
+
+    return sim;
+}
+
+/**
+ * Assign the budget of the next simulations of a @c Simulation built
+ * with @c makeSimulation.
+ *
+ * @param sim The simulation.
+ * @param budget The budget of the simulations (can be null).
+ */
+static void setBudget(Simulation& sim, const Budget *budget)
+{
+    if (budget) {
+        sim.setBudget(budget->walltime(), budget->bags(), budget->stall());
+    } else {
+        sim.setBudget(0.0, 0, 0);
+    }
+}
+
+/**
+ * Check if a simulation interrupted by its budget is simulated again
+ * without budget after the others combinations.
+ *
+ * @param budget The budget of the simulations (can be null).
+ * @param error The error of the simulation.
+ *
+ * @return true if the combination is requeued.
+ */
+static bool isRequeued(const Budget *budget, const Error& error)
+{
+    return budget and budget->requeue() and
+        error.code == manager::ERROR_BUDGET;
+}
+
+/**
+ * Keep the partial result of a simulation interrupted by its budget,
+ * the result of another failure is freed.
+ *
+ * @param values The results.
+ * @param index The combination.
+ * @param error The error of the simulation.
+ * @param simresult The result of the simulation (can be null).
+ */
+static void keepPartial(Results&      values,
+                        uint32_t      index,
+                        const Error&  error,
+                        value::Value *simresult)
+{
+    if (error.code == manager::ERROR_BUDGET) {
+        values.add(index, simresult, true);
+    } else {
+        delete simresult;
+    }
+}
+
+/**
+ * Look for the result of a combination in the journal and the cache of
+ * its frame before its simulation. A result found is stored into the
+ * results of the frame.
+ *
+ * @param frame The frame of the combination.
+ * @param index The combination of the frame.
+ * @param options The simulation options.
+ * @param[out] conditions The conditions of the combination.
+ * @param[out] key The key of the combination in the cache.
+ * @param[out] error The error if the conditions of the combination
+ * cannot be computed.
+ *
+ * @return true if the result is found, false if the combination must
+ * be simulated or ended with its error.
+ */
+static bool findCombination(const Frame&       frame,
+                            uint32_t           index,
+                            SimulationOptions  options,
+                            vpz::Conditions   *conditions,
+                            std::string       *key,
+                            Error             *error)
+{
+    try {
+        value::Value *previous;
+
+        frame.expgen->get(index, conditions);
+
+        if (frame.cache) {
+            *key = getKey(frame.fingerprint, *frame.expgen, *conditions,
+                          index);
+        }
+
+        if (find(frame.journal, frame.cache, *key, index, options,
+                 &previous)) {
+            if (frame.results) {
+                frame.results->add(index, previous);
+            } else {
+                delete previous;
+            }
+
+            return true;
+        }
+    } catch (const std::exception& e) {
+        error->code = -1;
+        error->message = e.what();
+    }
+
+    return false;
+}
+
+/**
+ * End a combination. A combination interrupted by its budget is
+ * requeued if the budget allows it. Otherwise the end of the
+ * combination is recorded into the journal and the cache of its frame,
+ * its result is stored into the results of the frame (or given to the
+ * @c Source if the frame has no results) and its error into the @c
+ * WorkerResult.
+ *
+ * @param frame The frame of the combination.
+ * @param index The combination of the frame.
+ * @param budget The budget of the simulation (can be null).
+ * @param key The key of the combination in the cache.
+ * @param[in,out] error The error of the simulation.
+ * @param simresult The result of the simulation to freed (can be null).
+ * @param source The source of the combination (can be null).
+ * @param[out] result The errors and the requeued combinations, indexed
+ * by the combinations of the threads.
+ *
+ * @return false if the combination is requeued.
+ */
+static bool endCombination(const Frame&        frame,
+                           uint32_t            index,
+                           const Budget       *budget,
+                           const std::string&  key,
+                           Error              *error,
+                           value::Value       *simresult,
+                           Source             *source,
+                           WorkerResult       *result)
+{
+    uint32_t combination = frame.offset + index;
+
+    if (isRequeued(budget, *error)) {
+        delete simresult;
+        result->requeued.push_back(combination);
+        return false;
+    }
+
+    record(frame.journal, frame.cache, key, index, error, simresult);
+
+    if (error->code) {
+        result->errors.push_back(std::make_pair(combination,
+                                                error->message));
+
+        if (frame.results) {
+            keepPartial(*frame.results, index, *error, simresult);
+        } else {
+            delete simresult;
+        }
+    } else if (frame.results) {
+        frame.results->add(index, simresult);
+    } else if (source and simresult) {
+        source->result(index, simresult);
+    } else {
+        delete simresult;
+    }
+
+    return true;
+}
+
+/**
+ * Simulate a combination.
+ *
+ * Without replication, the combination is simulated once, or once by
+ * antithetic pair. Otherwise, the replicates of the combination are
+ * simulated with their own seed until the @c manager::Replication is
+ * satisfied. With antithetic pairs, the statistics of the replication
+ * are the means of the pairs. If the results are returned, the result
+ * of several replicates is the @c value::Set of their results. A
+ * failure of a replicate is a failure of the combination. A
+ * combination interrupted by its budget returns its partial result
+ * with the error @c manager::ERROR_BUDGET.
+ *
+ * The seeds are given by the @c manager::Streams or, without streams,
+ * by the @c manager::Replication.
+ *
+ * @param sim The simulation of the thread or of the process, built with
+ * @c makeSimulation.
+ * @param vpz The experiment to simulate.
+ * @param replication The replication (can be null).
+ * @param streams The random streams (can be null).
+ * @param conditions The conditions of the combination.
+ * @param index The combination.
+ * @param name The name of the experiment of the combination.
+ * @param simulationoptions The simulation options.
+ * @param modulemgr The modules of the simulations.
+ * @param[out] error The error of the simulation.
+ *
+ * @return The result to freed (can be null).
+ */
+static value::Value * simulate(Simulation&                 sim,
+                               const vpz::Vpz&             vpz,
+                               const Replication          *replication,
+                               const Streams              *streams,
+                               vpz::Conditions&            conditions,
+                               uint32_t                    index,
+                               const std::string&          name,
+                               SimulationOptions           simulationoptions,
+                               const utils::ModuleManager& modulemgr,
+                               Error                      *error)
+{
+    uint32_t group = streams ? streams->group() : 1;
+
+    if (not replication and group == 1) {
+        if (streams) {
+            sim.setSeed(streams->seed(index, 0));
+        }
+
+        value::Map *result = sim.run(vpz, conditions, name, modulemgr, error);
+
+        if (simulationoptions & manager::SIMULATION_NO_RETURN) {
+            delete result;
+            return 0;
+        }
+
+        return result;
+    }
+
+    std::auto_ptr < value::Set > result(value::Set::create());
+    Statistics statistics;
+    double sum = 0.0;
+
+    for (uint32_t i = 0; i % group or (replication ?
+                                       not replication->done(statistics) :
+                                       i < group); ++i) {
+        if (streams) {
+            uint32_t seed = streams->seed(index, i);
+
+            if (replication) {
+                replication->assign(seed, &conditions);
+            }
+            sim.setSeed(seed, streams->antithetic(i));
+        } else {
+            uint32_t seed = replication->seed(index, i);
+
+            replication->assign(seed, &conditions);
+            sim.setSeed(seed);
+        }
+
+        std::auto_ptr < value::Map > simresult(
+            sim.run(vpz, conditions, name, modulemgr, error));
+
+        if (error->code) {
+            return 0;
+        }
+
+        if (replication) {
+            try {
+                sum += replication->observe(simresult.get());
+            } catch (const std::exception& e) {
+                error->code = -1;
+                error->message = e.what();
+                return 0;
+            }
+
+            if ((i + 1) % group == 0) {
+                statistics.add(sum / group);
+                sum = 0.0;
+            }
+        }
+
+        if (not (simulationoptions & manager::SIMULATION_NO_RETURN)) {
+            result->add(simresult.release());
+        }
+    }
+
+    if (simulationoptions & manager::SIMULATION_NO_RETURN) {
+        return 0;
+    }
+
+    return result.release();
+}
+
+/**
+ * Build a result frame of a worker process.
+ *
+ * The frame is the size of the frame, the combination index, the
+ * error code, the error message and the binary representation of the
+ * result of the simulation (see @c value::writeBinary).
+ *
+ * @param index The combination index.
+ * @param error The error of the simulation.
+ * @param result The result of the simulation (can be null).
+ * @param[out] frame The frame.
+ */
+static void buildFrame(uint32_t            index,
+                       const Error&        error,
+                       const value::Value *result,
+                       std::string        *frame)
+{
+    int32_t code = error.code;
+    uint32_t size = error.message.size();
+
+    frame->assign(sizeof(uint32_t), '\0');
+    frame->append(reinterpret_cast < const char* >(&index), sizeof(index));
+    frame->append(reinterpret_cast < const char* >(&code), sizeof(code));
+    frame->append(reinterpret_cast < const char* >(&size), sizeof(size));
+    frame->append(error.message);
+    value::writeBinary(result, frame);
+
+    size = frame->size() - sizeof(uint32_t);
+    frame->replace(0, sizeof(size), reinterpret_cast < const char* >(&size),
+                   sizeof(size));
+}
+
+/**
+ * Extract the first result frame of a buffer filled by a worker
+ * process.
+ *
+ * @param[in,out] buffer The buffer, the frame is removed.
+ * @param[out] index The combination index.
+ * @param[out] error The error of the simulation.
+ * @param[out] result The result of the simulation (can be null).
+ *
+ * @return false if the buffer does not contain a complete frame.
+ * @throw utils::ArgError if the frame is corrupted.
+ */
+static bool extractFrame(std::string   *buffer,
+                         uint32_t      *index,
+                         Error         *error,
+                         value::Value **result)
+{
+    uint32_t size, length;
+    int32_t code;
+
+    if (buffer->size() < sizeof(size)) {
+        return false;
+    }
+
+    std::memcpy(&size, buffer->data(), sizeof(size));
+
+    if (buffer->size() - sizeof(size) < size) {
+        return false;
+    }
+
+    std::string frame(*buffer, sizeof(size), size);
+    buffer->erase(0, sizeof(size) + size);
+
+    if (frame.size() < sizeof(*index) + sizeof(code) + sizeof(length)) {
+        throw utils::ArgError(_("Manager: corrupted worker frame"));
+    }
+
+    std::string::size_type position = 0;
+    std::memcpy(index, frame.data() + position, sizeof(*index));
+    position += sizeof(*index);
+    std::memcpy(&code, frame.data() + position, sizeof(code));
+    position += sizeof(code);
+    std::memcpy(&length, frame.data() + position, sizeof(length));
+    position += sizeof(length);
+
+    if (frame.size() - position < length) {
+        throw utils::ArgError(_("Manager: corrupted worker frame"));
+    }
+
+    error->code = code;
+    error->message.assign(frame, position, length);
+    position += length;
+
+    *result = value::readBinary(frame, &position);
+
+    return true;
+}
+
+#if not defined _WIN32 && not defined __CYGWIN__
+/**
+ * The @c Branch is a child process forked by the @c Manager after the
+ * simulation of the common beginning of the combinations (see @c
+ * Manager::setBranch). It simulates the end of one combination.
+ */
+struct Branch
+{
+    Branch()
+        : pid(0), fd(-1), index(0), received(false)
+    {
+    }
+
+    pid_t       pid;        /**< 0 if the branch is idle. */
+    int         fd;         /**< The pipe of the result frame. */
+    std::string output;     /**< The part of frame not yet extracted. */
+    uint32_t    index;      /**< The combination in progress. */
+    bool        received;   /**< The result frame is extracted. */
+};
+
+/**
+ * Check that the outputs of the experimental frame can be branched. The
+ * children inherit the output plug-ins opened by the parent: the writer
+ * thread of an asynchronous output does not exist in a child and a file
+ * would be written by each child and again by the parent. Only the
+ * synchronous outputs of the @c storage plug-in, whose matrices are
+ * sent back in the result frames, are accepted.
+ *
+ * @param vpz The experimental frame.
+ *
+ * @throw utils::ArgError if an output can not be branched.
+ */
+static void checkBranchOutputs(const vpz::Vpz& vpz)
+{
+    const vpz::Outputs& outputs(
+        vpz.project().experiment().views().outputs());
+
+    for (vpz::Outputs::const_iterator it = outputs.begin();
+         it != outputs.end(); ++it) {
+        if (it->second.asynchronous()) {
+            throw utils::ArgError(
+                fmt(_("Manager: the asynchronous output `%1%' can not be"
+                      " branched")) % it->first);
+        }
+
+        if (it->second.format() != vpz::Output::LOCAL or
+            it->second.plugin() != "storage") {
+            throw utils::ArgError(
+                fmt(_("Manager: the output `%1%' can not be branched, only"
+                      " the storage plug-in is available")) % it->first);
+        }
+    }
+}
+
+/**
+ * Kill and reap the running branches when the @c Manager fails, so no
+ * child is left running.
+ *
+ * @param pool The branches.
+ * @param processes The size of the pool.
+ */
+static void reapBranches(Branch *pool, uint32_t processes)
+{
+    for (uint32_t i = 0; i < processes; ++i) {
+        if (pool[i].pid) {
+            ::kill(pool[i].pid, SIGKILL);
+            ::close(pool[i].fd);
+
+            while (::waitpid(pool[i].pid, 0, 0) < 0 and errno == EINTR) {
+            }
+
+            pool[i].pid = 0;
+            pool[i].fd = -1;
+        }
+    }
+}
+
+/**
+ * Simulate the end of a combination in a branch: the conditions of the
+ * combination are applied to the models, the simulation is run until
+ * the end and the result frame is written into the pipe.
+ *
+ * @param root The simulation stopped at the time of the branching.
+ * @param time The time of the branching.
+ * @param conditions The conditions of the combination.
+ * @param index The combination.
+ * @param options The simulation options.
+ * @param budget The budget of the end of the simulation (can be null).
+ * @param fd The pipe of the result frame.
+ */
+static void runBranch(devs::RootCoordinator& root,
+                      double                 time,
+                      const vpz::Conditions& conditions,
+                      uint32_t               index,
+                      SimulationOptions      options,
+                      const Budget          *budget,
+                      int                    fd)
+{
+    Error err;
+    value::Map *result = 0;
+    std::string frame;
+
+    try {
+        root.branch(time, conditions);
+
+        if (budget) {
+            root.setBudget(budget->walltime(), budget->bags(),
+                           budget->stall());
+        }
+
+        while (root.run()) {}
+        root.finish();
+
+        if (not (options & manager::SIMULATION_NO_RETURN)) {
+            result = root.outputs();
+        }
+
+        if (not root.interrupted().empty()) {
+            err.code = manager::ERROR_BUDGET;
+            err.message = (fmt(_("Simulation interrupted: %1%"))
+                           % root.interrupted()).str();
+        }
+    } catch (const std::exception& e) {
+        err.message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%"))
+                       % utils::demangle(typeid(e)) % e.what()).str();
+        err.code = -1;
+    }
+
+    try {
+        buildFrame(index, err, result, &frame);
+    } catch (const std::exception &e) {
+        err.code = -1;
+        err.message = e.what();
+        buildFrame(index, err, 0, &frame);
+    }
+
+    std::string::size_type written = 0;
+
+    while (written < frame.size()) {
+        ssize_t size = ::write(fd, frame.data() + written,
+                               frame.size() - written);
+
+        if (size < 0 and errno != EINTR) {
+            break;
+        } else if (size > 0) {
+            written += size;
+        }
+    }
+
+    ::close(fd);
+}
+#endif
+
+/**
+ * Get the program started by the worker processes: the vle program of
+ * the installation or the vle program of the PATH.
+ *
+ * @return The path of the vle program.
+ * @throw utils::InternalError if the program is not found.
+ */
+static std::string getWorkerProgram()
+{
+    std::string exe = utils::Path::buildFilename(
+        utils::Path::path().getPrefixDir(), "bin", "vle");
+
+    if (not utils::Path::existFile(exe)) {
+        exe = utils::Path::findProgram("vle");
+
+        if (exe.empty()) {
+            throw utils::InternalError(
+                _("Manager: failed to find the vle program"));
+        }
+    }
+
+    return exe;
+}
+
+/*
+ * The maximum time in milliseconds the manager waits for the outputs of
+ * its idle worker processes before it checks again their ends.
+ */
+static const unsigned int processPoll = 100;
+
+/**
+ * The @c Process is a worker process of the @c Manager. It simulates
+ * one combination at a time.
+ */
+struct Process
+{
+    Process()
+        : started(false), busy(false), index(0)
+    {
+    }
+
+    utils::Spawn spawn;
+    std::string  output;     /**< The part of frame not yet extracted. */
+    std::string  error;      /**< The latest standard error messages. */
+    bool         started;
+    bool         busy;
+    uint32_t     index;      /**< The combination in progress. */
+    std::string  key;        /**< Its key in the cache. */
+};
+
+/**
+ * Read the output of a worker process. The output of an ended worker is
+ * read until its end: the frames written before the end of the worker
+ * are extracted before its combination is reported as failed.
+ *
+ * @param process The worker process.
+ * @param finished true if the worker has ended.
+ *
+ * @return true if a part of a frame is read.
+ */
+static bool readProcess(Process& process, bool finished)
+{
+    bool activity = false;
+    std::string out, errout;
+
+    do {
+        out.clear();
+        errout.clear();
+        process.spawn.get(&out, &errout);
+        process.output.append(out);
+        process.error.append(errout);
+        activity = activity or not out.empty();
+    } while (finished and (not out.empty() or not errout.empty()));
+
+    if (process.error.size() > 4096) {
+        process.error.erase(0, process.error.size() - 4096);
+    }
+
+    return activity;
+}
+
+/**
+ * Kill and reap the running worker processes when the @c Manager fails,
+ * so no worker is left running.
+ *
+ * @param pool The worker processes.
+ * @param processes The size of the pool.
+ */
+static void killProcesses(Process *pool, uint32_t processes)
+{
+    for (uint32_t i = 0; i < processes; ++i) {
+        if (pool[i].started) {
+            pool[i].spawn.kill();
+            pool[i].started = false;
+        }
+    }
+}
+
+class Manager::Pimpl
+{
+public:
+    Pimpl(LogOptions            logoptions,
+          SimulationOptions     simulationoptions,
+          std::ostream         *output)
+        : mLogOption(logoptions),
+          mSimulationOption(simulationoptions),
+          mOutputStream(output), mResume(false), mCacheCapacity(0),
+          mBranch(false), mBranchTime(0.0), mMemory(0)
+    {
+        mQuantiles.push_back(0.05);
+        mQuantiles.push_back(0.5);
+        mQuantiles.push_back(0.95);
+    }
+
+    ~Pimpl()
+    {
+    }
+
+    template <typename T >
+    void writeSummaryLog(const T& fmt)
+    {
+        if (mLogOption & manager::LOG_SUMMARY) {
+            if (mOutputStream) {
+                *mOutputStream << fmt;
+            } else {
+                utils::Trace::send(fmt);
+            }
+        }
+    }
+
+    template <typename T >
+    void writeRunLog(const T& fmt)
+    {
+        if (mLogOption & manager::LOG_RUN) {
+            if (mOutputStream) {
+                *mOutputStream << fmt;
+            } else {
+                utils::Trace::send(fmt);
+            }
+        }
+    }
+
+    /**
+     * Write the errors of the combinations into the log in the order of
+     * the combinations and report the failure of the manager.
+     *
+     * @param errors The errors of the combinations.
+     * @param[out] error The error of the manager.
+     */
+    void reportErrors(WorkerResult::ErrorList *errors, Error *error)
+    {
+        std::sort(errors->begin(), errors->end());
+
+        for (WorkerResult::ErrorList::const_iterator it = errors->begin();
+             it != errors->end(); ++it) {
+            writeRunLog(it->second);
+
+            if (not error->code) {
+                error->code = -1;
+                error->message = _("Manager failure.");
+            }
+        }
+    }
+
+    /**
+     * The @c worker is a boost thread functor to execute threaded
+     * source code. The combinations are taken from the @c Source and
+     * can belong to several @c Frame, the results are stored into the
+     * shared @c Results of their frame (or given to the @c Source
+     * without @c Results) and the errors into the @c WorkerResult of
+     * the thread, the @c runThreads function merges them at the end.
+     * The partial results of the simulations interrupted by their
+     * budget are given only to the @c Results.
+     *
+     */
+    struct worker
+    {
+        const std::vector < Frame >& frames;
+        utils::ModuleManager        &modulemgr;
+        LogOptions                   mLogOption;
+        SimulationOptions            mSimulationOption;
+        uint32_t                     index;
+        Source                      &source;
+        bool                         budgeted;
+        Admission                   *admission;
+        WorkerResult                *result;
+
+        worker(const std::vector < Frame >& frames,
+               utils::ModuleManager&        modulemgr,
+               LogOptions                   logoptions,
+               SimulationOptions            simulationoptions,
+               uint32_t                     index,
+               Source&                      source,
+               bool                         budgeted,
+               Admission                   *admission,
+               WorkerResult                *result)
+            : frames(frames), modulemgr(modulemgr),
+              mLogOption(logoptions), mSimulationOption(simulationoptions),
+              index(index), source(source), budgeted(budgeted),
+              admission(admission), result(result)
+        {
+        }
+
+        ~worker()
+        {
+        }
+
+        void operator()()
+        {
+            std::string vpzname;
+            const Frame *frame = 0;
+            const Budget *budget = 0;
+            uint32_t combination;
+
+            if (mSimulationOption & manager::SIMULATION_PIN_THREADS) {
+                pinThread(index);
+            }
+
+            boost::scoped_ptr < Simulation > sim(
+                makeSimulation(mLogOption, mSimulationOption, 0));
+
+            while (source.next(index, &combination)) {
+                const Frame& current(frames[findFrame(frames, combination)]);
+                uint32_t i = combination - current.offset;
+
+                /*
+                 * The models of the simulation are kept while the
+                 * combinations belong to the same frame.
+                 */
+                if (frame != &current) {
+                    frame = &current;
+                    vpzname = frame->vpz->project().experiment().name();
+                    budget = budgeted ? frame->expgen->budget() : 0;
+                    setBudget(*sim, budget);
+                }
+
+                Error err;
+                vpz::Conditions conditions;
+                std::string key;
+                value::Value *simresult = 0;
+
+                if (findCombination(*frame, i, mSimulationOption,
+                                    &conditions, &key, &err)) {
+                    continue;
+                }
+
+                if (not err.code) {
+                    Admitted admitted(admission);
+
+                    simresult = simulate(
+                        *sim, *frame->vpz, frame->expgen->replication(),
+                        frame->expgen->streams(), conditions, i,
+                        getExperimentName(vpzname, i), mSimulationOption,
+                        modulemgr, &err);
+                }
+
+                endCombination(*frame, i, budget, key, &err, simresult,
+                               &source, result);
+            }
+        }
+    };
+
+    value::Matrix * runManagerThread(vpz::Vpz              *vpz,
+                                     utils::ModuleManager&  modulemgr,
+                                     uint32_t               threads,
+                                     uint32_t               rank,
+                                     uint32_t               world,
+                                     Error                 *error)
+    {
+        ExperimentGenerator expgen(*vpz, rank, world);
+        Scheduler scheduler(expgen.min(), expgen.max(), threads);
+        Results values(mSimulationOption, mQuantiles, expgen.min(),
+                       expgen.size());
+        std::vector < Frame > frames(1, Frame(vpz, &expgen, &values,
+                                              mJournal.get(), mCache.get(),
+                                              mFingerprint, 0));
+
+        runThreads(frames, modulemgr, threads, scheduler, error);
+
+        return values.release();
+    }
+
+    /**
+     * Run the combinations given by a @c Source with threads. The
+     * results are given to the @c Source.
+     */
+    void runManagerSource(vpz::Vpz              *vpz,
+                          utils::ModuleManager&  modulemgr,
+                          uint32_t               threads,
+                          Source                *source,
+                          Error                 *error)
+    {
+        ExperimentGenerator expgen(*vpz, 0, 1);
+        std::vector < Frame > frames(1, Frame(vpz, &expgen, 0, 0, 0,
+                                              std::string(), 0));
+
+        runThreads(frames, modulemgr, threads, *source, error);
+    }
+
+    /**
+     * Run the combinations of several experimental frames with the same
+     * threads. A frame which cannot be read or whose combinations
+     * cannot be computed is reported in its error and not simulated.
+     */
+    void runManagerFrames(const std::vector < vpz::Vpz* >& exps,
+                          utils::ModuleManager&            modulemgr,
+                          uint32_t                         threads,
+                          std::vector < value::Matrix* >  *matrices,
+                          std::vector < Error >           *errors)
+    {
+        std::vector < boost::shared_ptr < ExperimentGenerator > > generators;
+        std::vector < boost::shared_ptr < Results > > values;
+        std::vector < std::vector < Frame >::size_type > owners;
+        std::vector < Frame > frames;
+        std::vector < Error > frameErrors;
+        Cache *cache = (mSimulationOption & manager::SIMULATION_NO_RETURN) ?
+            0 : mCache.get();
+        uint64_t size = 0;
+
+        matrices->assign(exps.size(), static_cast < value::Matrix* >(0));
+        errors->assign(exps.size(), Error());
+
+        for (std::vector < vpz::Vpz* >::size_type i = 0; i < exps.size();
+             ++i) {
+            std::string fingerprint;
+
+            try {
+                generators.push_back(boost::shared_ptr < ExperimentGenerator >(
+                        new ExperimentGenerator(*exps[i], 0, 1)));
+
+                if (cache) {
+                    fingerprint = Cache::fingerprint(*exps[i]);
+                }
+            } catch (const std::exception& e) {
+                (*errors)[i].code = -1;
+                (*errors)[i].message = e.what();
+
+                delete exps[i]->project().model().model();
+                delete exps[i];
+                continue;
+            }
+
+            if (size + generators.back()->size() >
+                std::numeric_limits < uint32_t >::max()) {
+                uint64_t total = size + generators.back()->size();
+
+                for (std::vector < Frame >::size_type j = 0;
+                     j < frames.size(); ++j) {
+                    delete frames[j].vpz->project().model().model();
+                    delete frames[j].vpz;
+                }
+
+                for (std::vector < vpz::Vpz* >::size_type j = i;
+                     j < exps.size(); ++j) {
+                    delete exps[j]->project().model().model();
+                    delete exps[j];
+                }
+
+                throw utils::ArgError(
+                    fmt(_("Manager error: too many combinations (%1%)"))
+                    % total);
+            }
+
+            values.push_back(boost::shared_ptr < Results >(
+                    new Results(mSimulationOption, mQuantiles, 0,
+                                generators.back()->size())));
+            frames.push_back(Frame(exps[i], generators.back().get(),
+                                   values.back().get(), 0, cache,
+                                   fingerprint,
+                                   static_cast < uint32_t >(size)));
+            owners.push_back(i);
+            size += generators.back()->size();
+        }
+
+        if (frames.empty()) {
+            return;
+        }
+
+        Scheduler scheduler(0, static_cast < uint32_t >(size), threads);
+        frameErrors.resize(frames.size());
+
+        runThreads(frames, modulemgr, threads, scheduler, &frameErrors[0]);
+
+        for (std::vector < Frame >::size_type i = 0; i < frames.size(); ++i) {
+            (*matrices)[owners[i]] = values[i]->release();
+            (*errors)[owners[i]] = frameErrors[i];
+        }
+    }
+
+    /**
+     * Start the threads and wait for the end of the combinations of the
+     * @c Source.
+     */
+    void startThreads(const std::vector < Frame >& frames,
+                      utils::ModuleManager&        modulemgr,
+                      uint32_t                     threads,
+                      Source&                      source,
+                      bool                         budgeted,
+                      WorkerResult                *results)
+    {
+        boost::thread_group gp;
+
+        for (uint32_t i = 0; i < threads; ++i) {
+            gp.create_thread(worker(frames, modulemgr,
+                                    mLogOption, mSimulationOption,
+                                    i, source, budgeted, mAdmission.get(),
+                                    &results[i]));
+        }
+
+        gp.join_all();
+    }
+
+    /**
+     * Run the combinations of the frames with threads and free the
+     * experimental frames.
+     *
+     * @param[out] errors The error of each frame.
+     */
+    void runThreads(std::vector < Frame >& frames,
+                    utils::ModuleManager&  modulemgr,
+                    uint32_t               threads,
+                    Source&                source,
+                    Error                 *errors)
+    {
+        boost::scoped_array < WorkerResult > results(
+            new WorkerResult[threads]);
+
+        for (std::vector < Frame >::size_type i = 0; i < frames.size(); ++i) {
+            errors[i].code = 0;
+            errors[i].message.clear();
+        }
+
+        mAdmission.reset((mMemory and threads > 1) ?
+                         new Admission(mMemory, Admission::resident()) : 0);
+
+        startThreads(frames, modulemgr, threads, source, true,
+                     results.get());
+
+        /*
+         * The combinations interrupted by their budget and requeued are
+         * simulated again without budget when the source is empty.
+         */
+        std::vector < uint32_t > requeued;
+
+        for (uint32_t i = 0; i < threads; ++i) {
+            requeued.insert(requeued.end(), results[i].requeued.begin(),
+                            results[i].requeued.end());
+        }
+
+        if (not requeued.empty()) {
+            std::sort(requeued.begin(), requeued.end());
+
+            Queue queue(requeued, source);
+
+            startThreads(frames, modulemgr, threads, queue, false,
+                         results.get());
+        }
+
+        mAdmission.reset();
+
+        /*
+         * The errors of the threads are merged by the main thread and
+         * reported in the order of the combinations.
+         */
+        std::vector < std::pair < uint32_t, std::string > > merged;
+
+        for (uint32_t i = 0; i < threads; ++i) {
+            merged.insert(merged.end(), results[i].errors.begin(),
+                          results[i].errors.end());
+        }
+
+        std::sort(merged.begin(), merged.end());
+
+        for (std::vector < std::pair < uint32_t, std::string > >::iterator
+                 it = merged.begin(); it != merged.end(); ++it) {
+            Error *error = &errors[findFrame(frames, it->first)];
+
+            writeRunLog(it->second);
+
+            if (not error->code) {
+                error->code = -1;
+                error->message = _("Manager failure.");
+            }
+        }
+
+        for (std::vector < Frame >::iterator it = frames.begin();
+             it != frames.end(); ++it) {
+            delete it->vpz->project().model().model();
+            delete it->vpz;
+        }
+    }
+
+    /**
+     * Run the combinations of the experimental frame with a pool of
+     * worker processes. The experimental frame is written into a
+     * temporary file read by the workers. A combination is sent to an
+     * idle worker and the results are read when the outputs of the
+     * workers are ready (see @c utils::Spawn::poll). If a worker ends
+     * before sending the result of its combination, an error is
+     * reported for this combination and only this worker is restarted.
+     */
+    value::Matrix * runManagerProcess(vpz::Vpz             *vpz,
+                                      utils::ModuleManager &modulemgr,
+                                      uint32_t              processes,
+                                      uint32_t              rank,
+                                      uint32_t              world,
+                                      Error                *error)
+    {
+        (void)modulemgr;
+
+        ExperimentGenerator expgen(*vpz, rank, world);
+        boost::scoped_array < Process > pool(new Process[processes]);
+        Results values(mSimulationOption, mQuantiles, expgen.min(),
+                       expgen.size());
+        Frame frame(vpz, &expgen, &values, mJournal.get(), mCache.get(),
+                    mFingerprint, 0);
+        WorkerResult outcome;
+
+        error->code = 0;
+        error->message.clear();
+
+        /*
+         * The workers read a temporary copy of the experimental frame:
+         * the file of a table design is made absolute first.
+         */
+        if (not vpz->filename().empty()) {
+            Design::absolute(vpz->project().experiment().conditions(),
+                             utils::Path::dirname(vpz->filename()));
+        }
+
+        std::string filename;
+
+        try {
+            {
+                std::ofstream file;
+                filename = utils::Path::getTempFile("vle-manager-", &file);
+                vpz->write(file);
+            }
+
+            std::string exe = getWorkerProgram();
+            std::string workingdir = utils::Path::path().getCurrentDir();
+            std::vector < std::string > args;
+            args.push_back("--worker");
+            args.push_back(utils::to < int >(
+                               mSimulationOption &
+                               ~manager::SIMULATION_SPAWN_PROCESS));
+            args.push_back(filename);
+
+            /*
+             * The combinations interrupted by their budget and requeued are
+             * sent again without budget when all the others are sent.
+             */
+            std::vector < uint32_t >& requeued(outcome.requeued);
+            std::vector < uint32_t >::size_type pending = 0;
+            uint32_t next = expgen.min();
+            uint32_t done = 0;
+
+            while (done < expgen.size()) {
+                bool activity = false;
+
+                for (uint32_t i = 0; i < processes; ++i) {
+                    Process &process(pool[i]);
+
+                    if (process.started) {
+                        bool finished = process.spawn.isfinish();
+
+                        activity = readProcess(process, finished) or
+                            activity;
+
+                        uint32_t index;
+                        Error err;
+                        value::Value *simresult;
+
+                        while (extractFrame(&process.output, &index, &err,
+                                            &simresult)) {
+                            process.busy = false;
+                            activity = true;
+
+                            if (endCombination(frame, index,
+                                               expgen.budget(), process.key,
+                                               &err, simresult, 0,
+                                               &outcome)) {
+                                ++done;
+                            }
+                        }
+
+                        if (finished) {
+                            std::string message;
+                            bool success;
+
+                            process.spawn.status(&message, &success);
+                            process.started = false;
+
+                            if (process.busy) {
+                                Error err;
+
+                                err.code = -1;
+                                err.message = (fmt(_("Simulation %1% failed:"
+                                                     " %2%%3%"))
+                                               % process.index % message
+                                               % process.error).str();
+                                endCombination(frame, process.index, 0,
+                                               process.key, &err, 0, 0,
+                                               &outcome);
+
+                                process.busy = false;
+                                activity = true;
+                                ++done;
+                            }
+                        }
+                    }
+
+                    if (process.busy) {
+                        continue;
+                    }
+
+                    std::string key;
+
+                    for (; next < expgen.max(); ++next, ++done) {
+                        vpz::Conditions conditions;
+                        Error err;
+
+                        if (not findCombination(frame, next,
+                                                mSimulationOption,
+                                                &conditions, &key, &err)) {
+                            if (not err.code) {
+                                break;
+                            }
+
+                            endCombination(frame, next, 0, key, &err, 0, 0,
+                                           &outcome);
+                        }
+                    }
+
+                    uint32_t index;
+                    std::string line;
+
+                    if (next < expgen.max()) {
+                        index = next++;
+                        line = utils::to < uint32_t >(index) + "\n";
+                    } else if (pending < requeued.size()) {
+                        index = requeued[pending++];
+                        line = utils::to < uint32_t >(index) + " unlimited\n";
+
+                        if (mCache) {
+                            vpz::Conditions conditions;
+                            expgen.get(index, &conditions);
+                            key = getKey(mFingerprint, expgen, conditions,
+                                         index);
+                        }
+                    } else {
+                        continue;
+                    }
+
+                    if (not process.started) {
+                        process.output.clear();
+                        process.error.clear();
+
+                        if (not process.spawn.start(exe, workingdir, args,
+                                                    50000u, true)) {
+                            throw utils::InternalError(
+                                fmt(_("Manager: failed to start `%1%'")) % exe);
+                        }
+
+                        process.started = true;
+                    }
+
+                    /*
+                     * If the worker is dead, the put fails and the
+                     * combination is reported as failed by the next
+                     * isfinish().
+                     */
+                    process.spawn.put(line);
+                    process.index = index;
+                    process.key = key;
+                    process.busy = true;
+                    activity = true;
+                }
+
+                /*
+                 * Without activity, all the started workers simulate a
+                 * combination: wait for their outputs or their end.
+                 */
+                if (not activity) {
+                    std::vector < utils::Spawn* > spawns;
+
+                    for (uint32_t i = 0; i < processes; ++i) {
+                        if (pool[i].started) {
+                            spawns.push_back(&pool[i].spawn);
+                        }
+                    }
+
+                    utils::Spawn::poll(spawns, processPoll);
+                }
+            }
+
+            for (uint32_t i = 0; i < processes; ++i) {
+                if (pool[i].started) {
+                    pool[i].spawn.closeInput();
+                    pool[i].spawn.wait();
+                }
+            }
+        } catch (...) {
+            killProcesses(pool.get(), processes);
+
+            if (not filename.empty()) {
+                std::remove(filename.c_str());
+            }
 
+            delete vpz->project().model().model();
+            delete vpz;
+            throw;
+        }
 
-    destination->project().setInstance(number);
-    destination->project().experiment().setName(result);
-}
+        std::remove(filename.c_str());
 
-class Manager::Pimpl
-{
-public:
-    Pimpl(LogOptions            logoptions,
-          SimulationOptions     simulationoptions,
-          std::ostream         *output)
-        : mLogOption(logoptions),
-          mSimulationOption(simulationoptions),
-          mOutputStream(output)
-    {
-    }
+        reportErrors(&outcome.errors, error);
 
-    ~Pimpl()
-    {
+        delete vpz->project().model().model();
+        delete vpz;
+
+        return values.release();
     }
 
-    template <typename T >
-    void writeSummaryLog(const T& fmt)
+    /**
+     * Run the combinations of the experimental frame from a common
+     * beginning: the simulation of the first combination is run until
+     * the time of the branching, then a child process is forked for
+     * each combination (the memory is copied on write). A child applies
+     * the conditions of its combination to the models (see @c
+     * devs::Dynamics::branch), runs the end of the simulation and
+     * writes the result into a pipe. At most @e processes children run
+     * at the same time.
+     */
+    value::Matrix * runManagerBranch(vpz::Vpz             *vpz,
+                                     utils::ModuleManager &modulemgr,
+                                     uint32_t              processes,
+                                     uint32_t              rank,
+                                     uint32_t              world,
+                                     Error                *error)
     {
-        if (mLogOption & manager::LOG_SUMMARY) {
-            if (mOutputStream) {
-                *mOutputStream << fmt;
-            } else {
-                utils::Trace::send(fmt);
+#if defined _WIN32 || defined __CYGWIN__
+        (void)vpz;
+        (void)modulemgr;
+        (void)processes;
+        (void)rank;
+        (void)world;
+        (void)error;
+
+        throw utils::InternalError(
+            _("Manager: the branching is not available on this system"));
+#else
+        try {
+            checkBranchOutputs(*vpz);
+        } catch (...) {
+            delete vpz->project().model().model();
+            delete vpz;
+            throw;
+        }
+
+        ExperimentGenerator expgen(*vpz, rank, world);
+        boost::scoped_array < Branch > pool(new Branch[processes]);
+        Results values(mSimulationOption, mQuantiles, expgen.min(),
+                       expgen.size());
+        Frame frame(vpz, &expgen, &values, mJournal.get(), 0, std::string(),
+                    0);
+        WorkerResult outcome;
+        devs::RootCoordinator root(modulemgr);
+
+        error->code = 0;
+        error->message.clear();
+
+        if (expgen.replication() or
+            (expgen.streams() and expgen.streams()->group() > 1)) {
+            throw utils::ArgError(
+                _("Manager: the replicates of a combination can not be"
+                  " branched"));
+        }
+
+        uint32_t next = expgen.min();
+        uint32_t done = 0;
+
+        try {
+            if (next < expgen.max()) {
+                vpz::Conditions conditions;
+                expgen.get(next, &conditions);
+
+                if (expgen.streams()) {
+                    root.setSeed(expgen.streams()->seed(next, 0));
+                }
+
+                root.load(*vpz, conditions,
+                          vpz->project().experiment().name());
+                root.init();
+
+                while (root.run(mBranchTime)) {}
             }
+        } catch (const std::exception& e) {
+            writeRunLog(fmt(_("\n/!\\ vle error reported: %1%\n%2%"))
+                        % utils::demangle(typeid(e)) % e.what());
+
+            error->code = -1;
+            error->message = _("Manager failure.");
+            done = expgen.size();
         }
-    }
 
-    template <typename T >
-    void writeRunLog(const T& fmt)
-    {
-        if (mLogOption & manager::LOG_RUN) {
-            if (mOutputStream) {
-                *mOutputStream << fmt;
-            } else {
-                utils::Trace::send(fmt);
+        /*
+         * The results of the branches depend on the beginning of the
+         * simulation and on the time of the branching: the cache is not
+         * used, only the journal.
+         */
+        try {
+            while (done < expgen.size()) {
+                for (uint32_t i = 0; i < processes; ++i) {
+                    Branch &branch(pool[i]);
+
+                    if (branch.pid) {
+                        continue;
+                    }
+
+                    vpz::Conditions conditions;
+
+                    for (; next < expgen.max(); ++next, ++done) {
+                        std::string key;
+                        Error err;
+
+                        if (not findCombination(frame, next,
+                                                mSimulationOption,
+                                                &conditions, &key, &err)) {
+                            if (not err.code) {
+                                break;
+                            }
+
+                            endCombination(frame, next, 0, key, &err, 0, 0,
+                                           &outcome);
+                        }
+                    }
+
+                    if (next >= expgen.max()) {
+                        break;
+                    }
+
+                    int fds[2];
+
+                    if (::pipe(fds)) {
+                        throw utils::InternalError(
+                            _("Manager: failed to create a pipe"));
+                    }
+
+                    std::cout.flush();
+                    std::cerr.flush();
+                    std::fflush(0);
+
+                    pid_t pid = ::fork();
+
+                    if (pid < 0) {
+                        ::close(fds[0]);
+                        ::close(fds[1]);
+
+                        throw utils::InternalError(
+                            _("Manager: failed to fork the simulation"));
+                    } else if (pid == 0) {
+                        ::close(fds[0]);
+                        runBranch(root, mBranchTime, conditions, next,
+                                  mSimulationOption, expgen.budget(), fds[1]);
+                        ::_exit(0);
+                    }
+
+                    ::close(fds[1]);
+
+                    branch.pid = pid;
+                    branch.fd = fds[0];
+                    branch.output.clear();
+                    branch.index = next++;
+                    branch.received = false;
+                }
+
+                std::vector < struct pollfd > fds;
+                std::vector < uint32_t > children;
+
+                for (uint32_t i = 0; i < processes; ++i) {
+                    if (pool[i].pid) {
+                        struct pollfd fd;
+                        fd.fd = pool[i].fd;
+                        fd.events = POLLIN;
+                        fd.revents = 0;
+
+                        fds.push_back(fd);
+                        children.push_back(i);
+                    }
+                }
+
+                if (fds.empty()) {
+                    continue;
+                }
+
+                if (::poll(&fds[0], fds.size(), -1) < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    throw utils::InternalError(
+                        _("Manager: failed to wait the branches"));
+                }
+
+                for (std::vector < struct pollfd >::size_type j = 0;
+                     j < fds.size(); ++j) {
+                    if (not fds[j].revents) {
+                        continue;
+                    }
+
+                    Branch &branch(pool[children[j]]);
+                    char buffer[65536];
+                    ssize_t size = ::read(branch.fd, buffer, sizeof(buffer));
+
+                    if (size < 0 and errno == EINTR) {
+                        continue;
+                    }
+
+                    if (size > 0) {
+                        branch.output.append(buffer, size);
+
+                        uint32_t index;
+                        Error err;
+                        value::Value *simresult;
+
+                        while (extractFrame(&branch.output, &index, &err,
+                                            &simresult)) {
+                            endCombination(frame, index, 0, std::string(),
+                                           &err, simresult, 0, &outcome);
+                            branch.received = true;
+                        }
+
+                        continue;
+                    }
+
+                    int status = 0;
+
+                    ::close(branch.fd);
+                    ::waitpid(branch.pid, &status, 0);
+
+                    if (not branch.received) {
+                        std::string message;
+                        Error err;
+
+                        if (WIFSIGNALED(status)) {
+                            message = (fmt(_("killed by the signal %1%"))
+                                       % WTERMSIG(status)).str();
+                        } else {
+                            message = (fmt(_("exit status %1%"))
+                                       % WEXITSTATUS(status)).str();
+                        }
+
+                        err.code = -1;
+                        err.message = (fmt(_("Simulation %1% failed: %2%"))
+                                       % branch.index % message).str();
+                        endCombination(frame, branch.index, 0, std::string(),
+                                       &err, 0, 0, &outcome);
+                    }
+
+                    branch.pid = 0;
+                    branch.fd = -1;
+                    ++done;
+                }
             }
+        } catch (...) {
+            reapBranches(pool.get(), processes);
+            delete vpz->project().model().model();
+            delete vpz;
+            throw;
+        }
+
+        try {
+            root.finish();
+        } catch (const std::exception& e) {
+            writeRunLog(e.what());
         }
+
+        delete root.outputs();
+
+        reportErrors(&outcome.errors, error);
+
+        delete vpz->project().model().model();
+        delete vpz;
+
+        return values.release();
+#endif
     }
 
-    /**
-     * The @c worker is a boost thread functor to execute threaded
-     * source code.
-     *
-     */
-    struct worker
+    void runWorker(vpz::Vpz             *vpz,
+                   utils::ModuleManager &modulemgr,
+                   Error                *error)
     {
-        const vpz::Vpz       *vpz;
-        ExperimentGenerator  &expgen;
-        utils::ModuleManager &modulemgr;
-        LogOptions            mLogOption;
-        SimulationOptions     mSimulationOption;
-        uint32_t              index;
-        uint32_t              threads;
-        value::Matrix        *result;
-        Error                *error;
-
-        worker(const vpz::Vpz        *vpz,
-               ExperimentGenerator&   expgen,
-               utils::ModuleManager&  modulemgr,
-               LogOptions             logoptions,
-               SimulationOptions      simulationoptions,
-               uint32_t               index,
-               uint32_t               threads,
-               value::Matrix         *result,
-               Error                 *error)
-            : vpz(vpz), expgen(expgen), modulemgr(modulemgr),
-              mLogOption(logoptions), mSimulationOption(simulationoptions),
-              index(index), threads(threads), result(result), error(error)
-        {
-        }
+        ExperimentGenerator expgen(*vpz, 0, 1);
+        Frame combinations(vpz, &expgen, 0, 0, 0, std::string(), 0);
+        std::string vpzname(vpz->project().experiment().name());
+        std::string frame;
+        uint32_t index;
 
-        ~worker()
-        {
+        error->code = 0;
+        error->message.clear();
+
+        /*
+         * The results are written on a copy of the standard output,
+         * the standard output is redirected to the standard error to
+         * keep the plug-ins and the models from writing into the
+         * frames.
+         */
+        std::cout.flush();
+        std::fflush(stdout);
+
+        int fd = ::dup(::fileno(stdout));
+        ::dup2(::fileno(stderr), ::fileno(stdout));
+
+#if defined _WIN32 || defined __CYGWIN__
+        ::_setmode(fd, _O_BINARY);
+#endif
+
+        std::FILE *output = ::fdopen(fd, "wb");
+
+        if (not output) {
+            throw utils::InternalError(
+                _("Manager: failed to open the worker output"));
         }
 
-        void operator()()
-        {
-            std::string vpzname(vpz->project().experiment().name());
+        SimulationOptions options =
+            mSimulationOption & ~manager::SIMULATION_SPAWN_PROCESS;
+        boost::scoped_ptr < Simulation > sim(
+            makeSimulation(mLogOption, options, 0));
+        const Budget *budget = expgen.budget();
+        std::string line;
 
-            for (uint32_t i = expgen.min() + index; i < expgen.max();
-                 i += threads) {
-                Simulation sim(mLogOption, mSimulationOption, NULL);
-                Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
+        while (std::cin >> index) {
+            Error err;
+            value::Value *simresult = 0;
 
-                value::Map *simresult = sim.run(file, modulemgr, &err);
+            /*
+             * A combination requeued after the exhaustion of its budget
+             * is followed by "unlimited".
+             */
+            std::getline(std::cin, line);
 
-                if (err.code) {
-                    // writeRunLog(err.message);
+            if (budget and line.find("unlimited") == std::string::npos) {
+                sim->setBudget(budget->walltime(), budget->bags(),
+                               budget->stall());
+            } else {
+                sim->setBudget(0.0, 0, 0);
+            }
 
-                    if (not error->code) {
-                        error->code = -1;
-                        error->message = _("Manager failure.");
-                    }
-                } else {
-                    result->add(i, 0, simresult);
+            if (index < expgen.min() or index >= expgen.max()) {
+                err.code = -1;
+                err.message = (fmt(_("Manager: bad combination %1%"))
+                               % index).str();
+            } else {
+                vpz::Conditions conditions;
+                std::string key;
+
+                findCombination(combinations, index, options, &conditions,
+                                &key, &err);
+
+                if (not err.code) {
+                    simresult = simulate(*sim, *vpz, expgen.replication(),
+                                         expgen.streams(), conditions, index,
+                                         getExperimentName(vpzname, index),
+                                         options, modulemgr, &err);
                 }
             }
+
+            try {
+                buildFrame(index, err, simresult, &frame);
+            } catch (const std::exception &e) {
+                err.code = -1;
+                err.message = e.what();
+                buildFrame(index, err, 0, &frame);
+            }
+
+            delete simresult;
+
+            if (std::fwrite(frame.data(), 1, frame.size(), output) !=
+                frame.size() or std::fflush(output)) {
+                error->code = -1;
+                error->message = _("Manager: failed to write the results");
+                break;
+            }
         }
-    };
 
-    value::Matrix * runManagerThread(vpz::Vpz              *vpz,
-                                     utils::ModuleManager&  modulemgr,
-                                     uint32_t               threads,
-                                     uint32_t               rank,
-                                     uint32_t               world,
-                                     Error                 *error)
+        std::fclose(output);
+
+        delete vpz->project().model().model();
+        delete vpz;
+    }
+
+    /**
+     * Simulate a combination of the mono thread manager.
+     *
+     * @param budget The budget of the simulation (can be null).
+     * @param[out] outcome The errors and the requeued combinations.
+     */
+    void runCombination(Simulation&           sim,
+                        const Frame&          frame,
+                        const Budget         *budget,
+                        uint32_t              i,
+                        const std::string&    vpzname,
+                        utils::ModuleManager& modulemgr,
+                        WorkerResult         *outcome)
     {
-        ExperimentGenerator expgen(*vpz, rank, world);
-        std::string vpzname(vpz->project().experiment().name());
-        boost::thread_group gp;
-        value::Matrix *result = new value::Matrix(expgen.size(), 1, expgen.size(), 1);
+        Error err;
+        vpz::Conditions conditions;
+        std::string key;
+        value::Value *simresult = 0;
 
-        for (uint32_t i = 0; i < threads; ++i) {
-            gp.create_thread(worker(vpz, expgen, modulemgr,
-                                    mLogOption, mSimulationOption,
-                                    i, threads, result, error));
+        if (findCombination(frame, i, mSimulationOption, &conditions, &key,
+                            &err)) {
+            return;
         }
 
-        gp.join_all();
-
-         delete vpz->project().model().model();
-         delete vpz;
+        if (not err.code) {
+            simresult = simulate(
+                sim, *frame.vpz, frame.expgen->replication(),
+                frame.expgen->streams(), conditions, i,
+                getExperimentName(vpzname, i), mSimulationOption, modulemgr,
+                &err);
+        }
 
-         return result;
+        endCombination(frame, i, budget, key, &err, simresult, 0, outcome);
     }
 
     value::Matrix * runManagerMono(vpz::Vpz             *vpz,
@@ -201,69 +2165,73 @@ public:
                                    uint32_t              world,
                                    Error                *error)
     {
-        Simulation sim(mLogOption, mSimulationOption, NULL);
         ExperimentGenerator expgen(*vpz, rank, world);
         std::string vpzname(vpz->project().experiment().name());
-        value::Matrix *result = 0;
+        Results values(mSimulationOption, mQuantiles, expgen.min(),
+                       expgen.size());
+        Frame frame(vpz, &expgen, &values, mJournal.get(), mCache.get(),
+                    mFingerprint, 0);
+        WorkerResult outcome;
+        boost::scoped_ptr < Simulation > sim(
+            makeSimulation(mLogOption, mSimulationOption, expgen.budget()));
 
         error->code = 0;
         error->message.clear();
 
-        if (mSimulationOption == manager::SIMULATION_NO_RETURN) {
-            for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
-                Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
-
-                sim.run(file, modulemgr, &err);
-
-                if (err.code) {
-                    writeRunLog(err.message);
-
-                    if (not error->code) {
-                        error->code = -1;
-                        error->message = _("Manager failure.");
-                    }
-                }
-            }
-        } else {
-            result = new value::Matrix(expgen.size(), 1, expgen.size(), 1);
-
-            for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
-                Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
+        for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
+            runCombination(*sim, frame, expgen.budget(), i, vpzname,
+                           modulemgr, &outcome);
+        }
 
-                value::Map *simresult = sim.run(file, modulemgr, &err);
+        /*
+         * The combinations interrupted by their budget and requeued are
+         * simulated again without budget.
+         */
+        if (not outcome.requeued.empty()) {
+            std::vector < uint32_t > requeued;
 
-                if (err.code) {
-                    writeRunLog(err.message);
+            requeued.swap(outcome.requeued);
+            sim->setBudget(0.0, 0, 0);
 
-                    if (not error->code) {
-                        error->code = -1;
-                        error->message = _("Manager failure.");
-                    }
-                } else {
-                    result->add(i, 0, simresult);
-                }
+            for (std::vector < uint32_t >::const_iterator it =
+                     requeued.begin(); it != requeued.end(); ++it) {
+                runCombination(*sim, frame, 0, *it, vpzname, modulemgr,
+                               &outcome);
             }
         }
 
+        reportErrors(&outcome.errors, error);
+
         delete vpz->project().model().model();
         delete vpz;
 
-        return result;
+        return values.release();
     }
 
     LogOptions            mLogOption;
     SimulationOptions     mSimulationOption;
     std::ostream         *mOutputStream;
+    std::vector < double > mQuantiles;
+    std::string           mJournalFile;
+    bool                  mResume;
+    boost::scoped_ptr < Journal > mJournal;
+    std::string           mCacheDirectory;
+    uint64_t              mCacheCapacity;
+    boost::scoped_ptr < Cache > mCache;
+    std::string           mFingerprint;
+    bool                  mBranch;
+    double                mBranchTime;
+    uint64_t              mMemory;
+    boost::scoped_ptr < Admission > mAdmission;
     uint32_t              mCurrentTime;
     uint32_t              mduration;
 };
 
+void Source::result(uint32_t /*index*/, value::Value *result)
+{
+    delete result;
+}
+
 Manager::Manager(LogOptions            logoptions,
                  SimulationOptions     simulationoptions,
                  std::ostream         *output)
@@ -303,13 +2271,71 @@ value::Matrix * Manager::run(vpz::Vpz             *exp,
             % world);
     }
 
+    /*
+     * The results of the branches depend on the beginning shared by all
+     * the combinations: they cannot be read from or stored into the
+     * cache.
+     */
+    if (mPimpl->mBranch and not mPimpl->mCacheDirectory.empty()) {
+        delete exp->project().model().model();
+        delete exp;
+        throw vle::utils::ArgError(
+            _("Manager error: the branching cannot be used with the"
+              " cache"));
+    }
+
     mPimpl->writeSummaryLog(_("Manager started"));
 
-    if (thread > 1) {
-        result = mPimpl->runManagerThread(exp, modulemgr, thread, rank,
-                                          world, error);
-    } else {
-        result = mPimpl->runManagerMono(exp, modulemgr, rank, world, error);
+    if (not mPimpl->mJournalFile.empty()) {
+        mPimpl->mJournal.reset(new Journal(
+                mPimpl->mJournalFile, mPimpl->mResume,
+                not (mPimpl->mSimulationOption &
+                     manager::SIMULATION_NO_RETURN)));
+
+        if (mPimpl->mJournal->completed()) {
+            mPimpl->writeSummaryLog(
+                fmt(_("Manager resumed: %1% combinations already"
+                      " completed")) % mPimpl->mJournal->completed());
+        }
+    }
+
+    /*
+     * Without the results, the simulations are only run for their
+     * outputs (files etc.): the cache is not used.
+     */
+    if (not mPimpl->mCacheDirectory.empty() and
+        not (mPimpl->mSimulationOption & manager::SIMULATION_NO_RETURN)) {
+        if (not mPimpl->mCache) {
+            mPimpl->mCache.reset(new Cache(mPimpl->mCacheDirectory,
+                                           mPimpl->mCacheCapacity));
+        }
+
+        mPimpl->mFingerprint = Cache::fingerprint(*exp);
+    }
+
+    try {
+        if (mPimpl->mBranch) {
+            result = mPimpl->runManagerBranch(exp, modulemgr, thread, rank,
+                                              world, error);
+        } else if (mPimpl->mSimulationOption &
+                   manager::SIMULATION_SPAWN_PROCESS) {
+            result = mPimpl->runManagerProcess(exp, modulemgr, thread, rank,
+                                               world, error);
+        } else if (thread > 1) {
+            result = mPimpl->runManagerThread(exp, modulemgr, thread, rank,
+                                              world, error);
+        } else {
+            result = mPimpl->runManagerMono(exp, modulemgr, rank, world,
+                                            error);
+        }
+    } catch (...) {
+        mPimpl->mJournal.reset();
+        throw;
+    }
+
+    if (mPimpl->mJournal) {
+        mPimpl->mJournal->close();
+        mPimpl->mJournal.reset();
     }
 
     mPimpl->writeSummaryLog(_("Manager ended"));
@@ -317,4 +2343,99 @@ value::Matrix * Manager::run(vpz::Vpz             *exp,
     return result;
 }
 
+void Manager::run(vpz::Vpz             *exp,
+                  utils::ModuleManager &modulemgr,
+                  uint32_t              thread,
+                  Source               *source,
+                  Error                *error)
+{
+    if (thread <= 0) {
+        throw vle::utils::ArgError(
+            fmt(_("Manager error: thread must be superior to 0 (%1%)"))
+            % thread);
+    }
+
+    mPimpl->writeSummaryLog(_("Manager started"));
+    mPimpl->runManagerSource(exp, modulemgr, thread, source, error);
+    mPimpl->writeSummaryLog(_("Manager ended"));
+}
+
+void Manager::run(const std::vector < vpz::Vpz* >& exps,
+                  utils::ModuleManager            &modulemgr,
+                  uint32_t                         thread,
+                  std::vector < value::Matrix* >  *results,
+                  std::vector < Error >           *errors)
+{
+    if (thread <= 0) {
+        throw vle::utils::ArgError(
+            fmt(_("Manager error: thread must be superior to 0 (%1%)"))
+            % thread);
+    }
+
+    if (mPimpl->mBranch or not mPimpl->mJournalFile.empty() or
+        (mPimpl->mSimulationOption & manager::SIMULATION_SPAWN_PROCESS)) {
+        throw vle::utils::ArgError(
+            _("Manager error: the experimental frames cannot share the"
+              " threads with the worker processes, the journal or the"
+              " branching"));
+    }
+
+    mPimpl->writeSummaryLog(_("Manager started"));
+
+    if (not mPimpl->mCacheDirectory.empty() and
+        not (mPimpl->mSimulationOption & manager::SIMULATION_NO_RETURN) and
+        not mPimpl->mCache) {
+        mPimpl->mCache.reset(new Cache(mPimpl->mCacheDirectory,
+                                       mPimpl->mCacheCapacity));
+    }
+
+    mPimpl->runManagerFrames(exps, modulemgr, thread, results, errors);
+    mPimpl->writeSummaryLog(_("Manager ended"));
+}
+
+void Manager::runWorker(vpz::Vpz             *exp,
+                        utils::ModuleManager &modulemgr,
+                        Error                *error)
+{
+    mPimpl->runWorker(exp, modulemgr, error);
+}
+
+void Manager::setQuantiles(const std::vector < double >& probabilities)
+{
+    for (std::vector < double >::const_iterator it = probabilities.begin();
+         it != probabilities.end(); ++it) {
+        if (not (*it > 0.0 and *it < 1.0)) {
+            throw utils::ArgError(
+                fmt(_("Manager error: quantile probability must be in"
+                      " ]0, 1[ (%1%)")) % *it);
+        }
+    }
+
+    mPimpl->mQuantiles = probabilities;
+}
+
+void Manager::setJournal(const std::string& filename, bool resume)
+{
+    mPimpl->mJournalFile = filename;
+    mPimpl->mResume = resume;
+}
+
+void Manager::setCache(const std::string& directory, uint64_t capacity)
+{
+    mPimpl->mCacheDirectory = directory;
+    mPimpl->mCacheCapacity = capacity;
+    mPimpl->mCache.reset();
+}
+
+void Manager::setBranch(bool branch, double time)
+{
+    mPimpl->mBranch = branch;
+    mPimpl->mBranchTime = time;
+}
+
+void Manager::setMemory(uint64_t budget)
+{
+    mPimpl->mMemory = budget;
+}
+
 }} // namespace vle manager
@@ -32,12 +32,62 @@
 #include <vle/utils/ModuleManager.hpp>
 #include <vle/manager/Types.hpp>
 #include <vle/vpz/Vpz.hpp>
+#include <string>
+#include <vector>
 
 namespace vle { namespace manager {
 
+/**
+ * @c manager::Source gives the combinations to simulate to the threads
+ * of a @c manager::Manager. A source can compute the combinations
+ * locally or receive them from another process (see mvle).
+ */
+class VLE_API Source
+{
+public:
+    virtual ~Source()
+    {}
+
+    /**
+     * Get the next combination to simulate. This function is called
+     * concurrently by the threads of the @c manager::Manager and can
+     * block until a combination is available.
+     *
+     * @param thread The index of the thread.
+     * @param[out] index The combination to simulate.
+     *
+     * @return false if there is no more combination to simulate.
+     */
+    virtual bool next(uint32_t thread, uint32_t *index) = 0;
+
+    /**
+     * Receive the result of a combination. This function is called
+     * concurrently by the threads of the @c manager::Manager when a
+     * simulation returns a result (never with the @c
+     * SIMULATION_NO_RETURN option). The default implementation drops
+     * the result.
+     *
+     * @param index The combination.
+     * @param result The result of the simulation, or the @c value::Set
+     * of the results of its replicates, to freed.
+     */
+    virtual void result(uint32_t index, value::Value *result);
+};
+
 /**
  * @c manager::Manager permits to run experimental frames.
  *
+ * With the @c SIMULATION_SPAWN_PROCESS option, the simulations are
+ * run by a pool of worker processes (the vle program) instead of
+ * threads. Use this option when the dynamics libraries are not
+ * thread-safe. A worker that crashes reports an error for its
+ * combination and is restarted.
+ *
+ * With the @c SIMULATION_REUSE_MODELS option, each thread or worker
+ * process keeps the models of its last simulation and resets them for
+ * its next combination or replicate when all the models support it
+ * (see @c devs::Dynamics::reset).
+ *
  * The @c manager::Manager returns a @c value::Matrix. The lines are
  * replicas and the columns are combination index from the @c
  * manager::ExperimentGenerator. A cell of the @c value::Matrix is a
@@ -45,6 +95,32 @@ namespace vle { namespace manager {
  * value is a @c value::Matrix or NULL if the @c value::Matrix is
  * empty.
  *
+ * If the experiment has a condition @c manager::Replication::name(),
+ * the replicates of a combination are simulated one after the other
+ * until the confidence interval of the observed output is narrow
+ * enough (see @c manager::Replication): the number of lines is the
+ * largest number of replicates and the cells of the combinations with
+ * fewer replicates are NULL.
+ *
+ * If the experiment has a condition @c manager::Streams::name(), the
+ * seeds of the simulations are common to the combinations (common
+ * random numbers) and the replicates can be simulated by antithetic
+ * pairs (see @c manager::Streams). Without replication, a combination
+ * with antithetic pairs has two lines.
+ *
+ * If the experiment has a condition @c manager::Budget::name(), a
+ * simulation which exceeds its budget (wall-clock time, number of
+ * bags or bags without time progress) is interrupted. Its combination
+ * is either simulated again without budget after the others, or
+ * reported as failed with its partial result, which is not folded by
+ * the @c SIMULATION_REDUCE option. The branched simulations (see @c
+ * setBranch) are never simulated again.
+ *
+ * With the @c SIMULATION_REDUCE option, the results are folded into
+ * statistics as soon as a simulation ends (see @c
+ * manager::Reduction) and the @c value::Matrix has only one cell: the
+ * summary of the statistics of all the combinations.
+ *
  * @attention You are in charge to freed the manager result @c
  * value::Matrix.
  */
@@ -82,6 +158,157 @@ public:
                         uint32_t              world,
                         Error                *error);
 
+    /**
+     * Run the combinations given by a @c manager::Source with several
+     * threads until the source is empty. The results of the
+     * simulations are given to the @c manager::Source.
+     *
+     * @param exp The experimental frame to freed.
+     * @param modulemgr
+     * @param thread The number of threads.
+     * @param source The combinations to simulate.
+     * @param error
+     */
+    void run(vpz::Vpz             *exp,
+             utils::ModuleManager &modulemgr,
+             uint32_t              thread,
+             Source               *source,
+             Error                *error);
+
+    /**
+     * Run several experimental frames with the same threads: the
+     * combinations of all the experimental frames are distributed to
+     * the threads like the combinations of one experimental frame, so
+     * the threads are not idle at the end of each experimental frame.
+     * The results and the errors are reported by experimental frame.
+     *
+     * This function is not available with the @c
+     * SIMULATION_SPAWN_PROCESS option, the journal (see @c setJournal)
+     * and the branching (see @c setBranch).
+     *
+     * @param exps The experimental frames to freed.
+     * @param modulemgr
+     * @param thread The number of threads.
+     * @param[out] results The result of each experimental frame, a @c
+     * value::Matrix to freed (see @c run) or null if the experimental
+     * frame cannot be simulated.
+     * @param[out] errors The error of each experimental frame.
+     *
+     * @throw utils::ArgError if the options are not available or if
+     * the experimental frames have too many combinations (the
+     * experimental frames are freed).
+     */
+    void run(const std::vector < vpz::Vpz* >& exps,
+             utils::ModuleManager            &modulemgr,
+             uint32_t                         thread,
+             std::vector < value::Matrix* >  *results,
+             std::vector < Error >           *errors);
+
+    /**
+     * Run the simulations of a worker process of a @c
+     * manager::Manager started with the @c SIMULATION_SPAWN_PROCESS
+     * option.
+     *
+     * The worker reads the combination indices on the standard input
+     * and writes the results on the standard output with a binary
+     * format until the end of file. During the simulations, the
+     * standard output is redirected to the standard error.
+     *
+     * @param exp The experimental frame to freed.
+     * @param modulemgr
+     * @param error
+     */
+    void runWorker(vpz::Vpz             *exp,
+                   utils::ModuleManager &modulemgr,
+                   Error                *error);
+
+    /**
+     * Assign the probabilities of the quantiles computed with the @c
+     * SIMULATION_REDUCE option. The default probabilities are 0.05,
+     * 0.5 and 0.95.
+     *
+     * @param probabilities The probabilities in ]0, 1[.
+     * @throw utils::ArgError if a probability is not in ]0, 1[.
+     */
+    void setQuantiles(const std::vector < double >& probabilities);
+
+    /**
+     * Record the completed combinations of the next runs into a journal
+     * (see @c manager::Journal) to resume an interrupted experimental
+     * frame. With the @c resume option, the combinations completed
+     * with success by a previous run are not simulated again: their
+     * results are read from the result stores of the journal. The
+     * results are stored only if they are returned (without the @c
+     * SIMULATION_NO_RETURN option): when the results are returned, the
+     * combinations completed without stored result are simulated again.
+     *
+     * The journal is used by the @c run function with the rank and the
+     * world, the combinations given by a @c manager::Source are
+     * recorded by the source.
+     *
+     * @param filename The name of the journal or an empty string to
+     * disable the journal.
+     * @param resume If true, the journal is read and the new
+     * combinations are appended, otherwise the journal is truncated.
+     */
+    void setJournal(const std::string& filename, bool resume);
+
+    /**
+     * Store the results of the simulations into a cache (see @c
+     * manager::Cache): a combination with the same experimental frame,
+     * the same conditions, the same seeds and the same dynamics
+     * libraries as a cached one is not simulated again. The cache is
+     * used only if the results are returned (without the @c
+     * SIMULATION_NO_RETURN option).
+     *
+     * @param directory The directory of the cache or an empty string
+     * to disable the cache.
+     * @param capacity The maximum size of the cache in bytes.
+     */
+    void setCache(const std::string& directory, uint64_t capacity);
+
+    /**
+     * Run the common beginning of the simulations once (warm start):
+     * the simulation of the first combination is run until the time of
+     * the branching, then the simulation is forked into a child process
+     * for each combination. A child applies the conditions of its
+     * combination to the models with the @c devs::Dynamics::branch
+     * function and runs the end of the simulation. A model which uses a
+     * condition modified by the combination must implement this
+     * function, otherwise the combination fails. The number of threads
+     * given to the @c run function is the number of children running
+     * at the same time.
+     *
+     * The observations of the beginning are shared by all the results.
+     * The children inherit the output plug-ins opened by the parent, so
+     * only the synchronous outputs of the @c storage plug-in are
+     * accepted: the asynchronous outputs and the plug-ins which write
+     * into files are rejected. The results of the branches depend on
+     * the beginning, so the branching is rejected with a cache (see @c
+     * setCache). This mode is not available on Windows and with the
+     * replicates of @c manager::Replication.
+     *
+     * @param branch true to enable the branching.
+     * @param time The time of the branching.
+     */
+    void setBranch(bool branch, double time);
+
+    /**
+     * Limit the number of simulations running at the same time in the
+     * threads to keep the resident memory of the process under a
+     * budget (see @c manager::Admission). The memory of a simulation is
+     * estimated from the growth of the memory during the first
+     * simulation, which runs alone, and during the next ones; a thread
+     * starts a new simulation only while the estimated memory of the
+     * simulations in progress and of the new one fits into the budget.
+     * The worker processes of the @c SIMULATION_SPAWN_PROCESS option
+     * and the branches of @c setBranch are not limited.
+     *
+     * @param budget The memory budget in bytes or 0 to disable the
+     * limit.
+     */
+    void setMemory(uint64_t budget);
+
 private:
     Manager(const Manager& other);
     Manager& operator=(const Manager& other);
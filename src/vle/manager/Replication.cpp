@@ -0,0 +1,221 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Replication.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/details/Tools.hpp>
+#include <cmath>
+
+namespace vle { namespace manager {
+
+static double toReal(const vpz::Condition& condition,
+                     const std::string& port)
+{
+    const value::Value *value = utils::getPortValue(condition, port,
+                                                    "Replication");
+
+    if (value->isDouble()) {
+        return value->toDouble().value();
+    } else if (value->isInteger()) {
+        return value->toInteger().value();
+    }
+
+    throw utils::ArgError(
+        fmt(_("Replication: the port `%1%' must be a real")) % port);
+}
+
+static std::string toString(const vpz::Condition& condition,
+                            const std::string& port)
+{
+    const value::Value *value = utils::getPortValue(condition, port,
+                                                    "Replication");
+
+    if (not value->isString() or value->toString().value().empty()) {
+        throw utils::ArgError(
+            fmt(_("Replication: the port `%1%' must be a string")) % port);
+    }
+
+    return value->toString().value();
+}
+
+const std::string& Replication::name()
+{
+    static const std::string result("vle.replicate");
+
+    return result;
+}
+
+Replication::Replication(const vpz::Conditions& conditions)
+    : mWidth(-1.0), mConfidence(0.95), mMinimum(3), mMaximum(100), mSeed(0)
+{
+    const vpz::Condition& replication(conditions.get(name()));
+    const vpz::ConditionValues& ports(replication.conditionvalues());
+
+    for (vpz::ConditionValues::const_iterator it = ports.begin();
+         it != ports.end(); ++it) {
+        if (it->first == "view") {
+            mView = toString(replication, it->first);
+        } else if (it->first == "column") {
+            mColumn = toString(replication, it->first);
+        } else if (it->first == "width") {
+            mWidth = toReal(replication, it->first);
+        } else if (it->first == "confidence") {
+            mConfidence = toReal(replication, it->first);
+        } else if (it->first == "min") {
+            mMinimum = static_cast < uint32_t >(
+                utils::toPortUnsigned(replication, it->first, "Replication"));
+        } else if (it->first == "max") {
+            mMaximum = static_cast < uint32_t >(
+                utils::toPortUnsigned(replication, it->first, "Replication"));
+        } else if (it->first == "seed") {
+            mSeed = static_cast < uint32_t >(
+                utils::toPortUnsigned(replication, it->first, "Replication"));
+        } else if (it->first == "port") {
+            std::string port = toString(replication, it->first);
+            std::string::size_type dot = port.rfind('.');
+
+            if (dot == std::string::npos or dot == 0 or
+                dot + 1 == port.size()) {
+                throw utils::ArgError(
+                    fmt(_("Replication: the port `%1%' is not a"
+                          " `condition.port' name")) % port);
+            }
+
+            mCondition = port.substr(0, dot);
+            mPort = port.substr(dot + 1);
+
+            if (mCondition == name() or
+                not conditions.exist(mCondition) or
+                not conditions.get(mCondition).conditionvalues().count(
+                    mPort)) {
+                throw utils::ArgError(
+                    fmt(_("Replication: the port `%1%' is not a port of the"
+                          " conditions")) % port);
+            }
+        } else {
+            throw utils::ArgError(
+                fmt(_("Replication: unknown port `%1%'")) % it->first);
+        }
+    }
+
+    if (mView.empty() or mColumn.empty()) {
+        throw utils::ArgError(
+            _("Replication: the ports `view' and `column' are required"));
+    }
+
+    if (not (mWidth > 0.0)) {
+        throw utils::ArgError(
+            _("Replication: the port `width' must be a positive real"));
+    }
+
+    if (not (mConfidence > 0.0 and mConfidence < 1.0)) {
+        throw utils::ArgError(
+            fmt(_("Replication: the confidence %1% is not in ]0, 1["))
+            % mConfidence);
+    }
+
+    if (mMinimum < 2 or mMaximum < mMinimum) {
+        throw utils::ArgError(
+            fmt(_("Replication: the number of replicates must verify"
+                  " 2 <= min (%1%) <= max (%2%)")) % mMinimum % mMaximum);
+    }
+}
+
+uint32_t Replication::seed(uint32_t index, uint32_t replicate) const
+{
+    uint64_t x = utils::mix((static_cast < uint64_t >(mSeed) << 32) ^ index);
+
+    return static_cast < uint32_t >(utils::mix(x ^ replicate) >> 32);
+}
+
+void Replication::assign(uint32_t seed, vpz::Conditions *conditions) const
+{
+    if (not mPort.empty()) {
+        vpz::ConditionValueSet values(value::Set::create());
+        values->add(value::Integer::create(static_cast < int32_t >(seed)));
+
+        conditions->get(mCondition).setSetValues(mPort, values);
+    }
+}
+
+double Replication::observe(const value::Map *result) const
+{
+    const value::Matrix *matrix = 0;
+
+    if (result and result->exist(mView) and result->get(mView) and
+        result->get(mView)->isMatrix()) {
+        matrix = &result->getMatrix(mView);
+    }
+
+    if (matrix and matrix->rows() > 0) {
+        for (value::Matrix::size_type i = 0; i < matrix->columns(); ++i) {
+            const value::Value *header = matrix->get(i, 0);
+
+            if (not header or not header->isString() or
+                header->toString().value() != mColumn) {
+                continue;
+            }
+
+            for (value::Matrix::size_type j = matrix->rows(); j > 1; --j) {
+                const value::Value *cell = matrix->get(i, j - 1);
+
+                if (cell and cell->isDouble()) {
+                    return cell->toDouble().value();
+                } else if (cell and cell->isInteger()) {
+                    return cell->toInteger().value();
+                }
+            }
+        }
+    }
+
+    throw utils::ArgError(
+        fmt(_("Replication: no value of the column `%1%' in the view"
+              " `%2%'")) % mColumn % mView);
+}
+
+bool Replication::done(const Statistics& statistics) const
+{
+    if (statistics.count() >= mMaximum) {
+        return true;
+    }
+
+    if (statistics.count() < mMinimum) {
+        return false;
+    }
+
+    return statistics.variance() == 0.0 or
+        statistics.interval(mConfidence) <=
+        mWidth * std::abs(statistics.mean());
+}
+
+}} // namespace vle manager
@@ -0,0 +1,160 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_REPLICATION_HPP
+#define VLE_MANAGER_REPLICATION_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/manager/Statistics.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/vpz/Conditions.hpp>
+#include <string>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::Replication decides how many replicates of a combination
+ * are simulated: the replicates are simulated until the confidence
+ * interval of the mean of an output is narrow enough or until a
+ * maximum number of replicates. Each replicate has its own seed,
+ * computed from the combination and the replicate number.
+ *
+ * The replication is described by the condition @c Replication::name()
+ * of the experiment. Its ports are:
+ * - @c view and @c column: two @c value::String, the output observed.
+ *   The observation of a replicate is the last numeric value of the
+ *   column of the matrix of the view (the column is found by its
+ *   header, for example "top:model.port").
+ * - @c width: a @c value::Double, the target half width of the
+ *   confidence interval relative to the mean (0.05 for example).
+ * - @c confidence: a @c value::Double, the confidence level of the
+ *   interval (optional, 0.95 by default).
+ * - @c min: a @c value::Integer, the minimum number of replicates
+ *   (optional, 3 by default and at least 2).
+ * - @c max: a @c value::Integer, the maximum number of replicates
+ *   (optional, 100 by default and at least min).
+ * - @c seed: a @c value::Integer, the base of the seeds (optional).
+ * - @c port: a @c value::String @e condition.port, the port which
+ *   receives the seed of a replicate as a @c value::Integer (optional).
+ *   The seed is always assigned to the @c devs::RootCoordinator, which
+ *   seeds the random streams of the models from it (see @c
+ *   devs::RootCoordinator::setSeed).
+ *
+ * @code
+ * <condition name="vle.replicate">
+ *  <port name="view"><string>view</string></port>
+ *  <port name="column"><string>top:model.x</string></port>
+ *  <port name="width"><double>0.05</double></port>
+ *  <port name="max"><integer>100</integer></port>
+ *  <port name="port"><string>cond.seed</string></port>
+ * </condition>
+ * @endcode
+ */
+class VLE_API Replication
+{
+public:
+    /**
+     * Build the replication from its condition.
+     *
+     * @param conditions The conditions of the experiment. The
+     * condition @c Replication::name() describes the replication.
+     *
+     * @throw utils::ArgError if the description is not valid.
+     */
+    Replication(const vpz::Conditions& conditions);
+
+    /**
+     * Get the name of the condition which describes the replication.
+     *
+     * @return "vle.replicate".
+     */
+    static const std::string& name();
+
+    /**
+     * Compute the seed of a replicate of a combination.
+     *
+     * @param index The combination.
+     * @param replicate The replicate of the combination.
+     *
+     * @return The seed.
+     */
+    uint32_t seed(uint32_t index, uint32_t replicate) const;
+
+    /**
+     * Assign the seed of a replicate to the port of the conditions, if
+     * any.
+     *
+     * @param seed The seed of the replicate.
+     * @param[out] conditions The conditions to update. The port is
+     * replaced with a new @c value::Set.
+     */
+    void assign(uint32_t seed, vpz::Conditions *conditions) const;
+
+    /**
+     * Get the observation of a replicate.
+     *
+     * @param result The result of the simulation of the replicate.
+     *
+     * @return The last numeric value of the column of the view.
+     * @throw utils::ArgError if the result has no such value.
+     */
+    double observe(const value::Map *result) const;
+
+    /**
+     * Check if the replicates of a combination are enough.
+     *
+     * @param statistics The statistics of the observations of the
+     * replicates.
+     *
+     * @return true if the maximum number of replicates is reached or
+     * if, with at least the minimum number of replicates, the half
+     * width of the confidence interval is lower than the target.
+     */
+    bool done(const Statistics& statistics) const;
+
+    uint32_t minimum() const
+    { return mMinimum; }
+
+    uint32_t maximum() const
+    { return mMaximum; }
+
+private:
+    std::string mView;
+    std::string mColumn;
+    std::string mCondition;
+    std::string mPort;
+    double      mWidth;
+    double      mConfidence;
+    uint32_t    mMinimum;
+    uint32_t    mMaximum;
+    uint32_t    mSeed;
+};
+
+}} // namespace vle manager
+
+#endif
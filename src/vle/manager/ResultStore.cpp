@@ -0,0 +1,279 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/ResultStore.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace vle { namespace manager {
+
+/*
+ * The file is the header, the records [index][size][binary value], the
+ * index [0xffffffff][count][index, offset]... and the footer [offset of
+ * the index][footer magic]. The size of a record is 64 bits since the
+ * version 02 of the header.
+ */
+static const char resultHeader[8] = { 'V', 'L', 'E', 'R', 'E', 'S', '0', '2' };
+static const char resultFooter[8] = { 'V', 'L', 'E', 'I', 'D', 'X', '0', '1' };
+static const uint32_t resultIndexMark = 0xffffffff;
+static const uint64_t resultRecordHeader = sizeof(uint32_t) +
+    sizeof(uint64_t);
+
+template < typename T >
+static void put(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast < const char* >(&value), sizeof(T));
+}
+
+template < typename T >
+static bool get(std::istream& in, T *value)
+{
+    in.read(reinterpret_cast < char* >(value), sizeof(T));
+    return in.gcount() == sizeof(T);
+}
+
+ResultWriter::ResultWriter(const std::string& filename)
+    : mFilename(filename), mPosition(sizeof(resultHeader))
+{
+    mFile.open(filename.c_str(), std::ios::out | std::ios::binary |
+               std::ios::trunc);
+
+    if (not mFile.is_open()) {
+        throw utils::FileError(
+            fmt(_("Result store: cannot open `%1%'")) % filename);
+    }
+
+    mFile.write(resultHeader, sizeof(resultHeader));
+}
+
+ResultWriter::~ResultWriter()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void ResultWriter::write(uint32_t index, const value::Value *result)
+{
+    std::string binary;
+
+    value::writeBinary(result, &binary);
+    write(index, binary);
+}
+
+void ResultWriter::write(uint32_t index, const std::string& binary)
+{
+    if (not mFile.is_open()) {
+        throw utils::FileError(
+            fmt(_("Result store: `%1%' is closed")) % mFilename);
+    }
+
+    put < uint32_t >(mFile, index);
+    put < uint64_t >(mFile, binary.size());
+    mFile.write(binary.data(), binary.size());
+
+    if (not mFile.good()) {
+        throw utils::FileError(
+            fmt(_("Result store: cannot write into `%1%'")) % mFilename);
+    }
+
+    mOffsets.push_back(std::make_pair(index, mPosition));
+    mPosition += resultRecordHeader + binary.size();
+}
+
+void ResultWriter::flush()
+{
+    mFile.flush();
+
+    if (not mFile.good()) {
+        throw utils::FileError(
+            fmt(_("Result store: cannot write into `%1%'")) % mFilename);
+    }
+}
+
+void ResultWriter::close()
+{
+    if (not mFile.is_open()) {
+        return;
+    }
+
+    put < uint32_t >(mFile, resultIndexMark);
+    put < uint32_t >(mFile, mOffsets.size());
+
+    for (OffsetList::const_iterator it = mOffsets.begin();
+         it != mOffsets.end(); ++it) {
+        put < uint32_t >(mFile, it->first);
+        put < uint64_t >(mFile, it->second);
+    }
+
+    put < uint64_t >(mFile, mPosition);
+    mFile.write(resultFooter, sizeof(resultFooter));
+    mFile.close();
+
+    if (mFile.fail()) {
+        throw utils::FileError(
+            fmt(_("Result store: cannot write into `%1%'")) % mFilename);
+    }
+}
+
+ResultReader::ResultReader(const std::string& filename)
+    : mFilename(filename)
+{
+    mFile.open(filename.c_str(), std::ios::in | std::ios::binary);
+
+    char header[sizeof(resultHeader)];
+
+    if (not mFile.is_open() or
+        not mFile.read(header, sizeof(header)) or
+        std::memcmp(header, resultHeader, sizeof(header))) {
+        throw utils::FileError(
+            fmt(_("Result store: `%1%' is not a result file")) % filename);
+    }
+
+    if (not readIndex()) {
+        scan();
+    }
+}
+
+value::Value * ResultReader::read(uint32_t index)
+{
+    std::map < uint32_t, uint64_t >::const_iterator it = mOffsets.find(index);
+
+    if (it == mOffsets.end()) {
+        throw utils::ArgError(
+            fmt(_("Result store: no combination %1% in `%2%'")) % index
+            % mFilename);
+    }
+
+    uint32_t recordindex;
+    uint64_t size;
+
+    mFile.clear();
+    mFile.seekg(it->second);
+
+    if (not get(mFile, &recordindex) or not get(mFile, &size) or
+        recordindex != index or size > std::string().max_size()) {
+        throw utils::ArgError(
+            fmt(_("Result store: corrupted record %1% in `%2%'")) % index
+            % mFilename);
+    }
+
+    std::string binary(static_cast < std::string::size_type >(size), '\0');
+
+    if (size and not mFile.read(&binary[0], size)) {
+        throw utils::ArgError(
+            fmt(_("Result store: corrupted record %1% in `%2%'")) % index
+            % mFilename);
+    }
+
+    std::string::size_type position = 0;
+    return value::readBinary(binary, &position);
+}
+
+std::vector < uint32_t > ResultReader::indices() const
+{
+    std::vector < uint32_t > result;
+    result.reserve(mOffsets.size());
+
+    for (std::map < uint32_t, uint64_t >::const_iterator it =
+             mOffsets.begin(); it != mOffsets.end(); ++it) {
+        result.push_back(it->first);
+    }
+
+    return result;
+}
+
+bool ResultReader::readIndex()
+{
+    char footer[sizeof(resultFooter)];
+    uint64_t offset;
+    uint32_t mark, count;
+
+    mFile.clear();
+    mFile.seekg(-static_cast < std::streamoff >(sizeof(uint64_t) +
+                                                sizeof(footer)),
+                std::ios::end);
+
+    if (not get(mFile, &offset) or
+        not mFile.read(footer, sizeof(footer)) or
+        std::memcmp(footer, resultFooter, sizeof(footer))) {
+        return false;
+    }
+
+    mFile.seekg(offset);
+
+    if (not get(mFile, &mark) or mark != resultIndexMark or
+        not get(mFile, &count)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t index;
+        uint64_t position;
+
+        if (not get(mFile, &index) or not get(mFile, &position)) {
+            mOffsets.clear();
+            return false;
+        }
+
+        mOffsets[index] = position;
+    }
+
+    return true;
+}
+
+void ResultReader::scan()
+{
+    uint64_t position = sizeof(resultHeader);
+
+    mOffsets.clear();
+    mFile.clear();
+    mFile.seekg(0, std::ios::end);
+    uint64_t end = mFile.tellg();
+    mFile.seekg(position);
+
+    for (;;) {
+        uint32_t index;
+        uint64_t size;
+
+        if (not get(mFile, &index) or index == resultIndexMark or
+            not get(mFile, &size) or
+            size > end or position + resultRecordHeader + size > end) {
+            break;
+        }
+
+        mOffsets[index] = position;
+        position += resultRecordHeader + size;
+        mFile.seekg(position);
+    }
+}
+
+}} // namespace vle manager
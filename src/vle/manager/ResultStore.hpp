@@ -0,0 +1,198 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_RESULTSTORE_HPP
+#define VLE_MANAGER_RESULTSTORE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/value/Value.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::ResultWriter writes the results of the combinations of an
+ * experimental frame into one file. A record is the combination index
+ * followed by the binary representation of its result (see @c
+ * value::writeBinary). The records are written in the order of
+ * arrival and an index of the records is appended by @c close(): the
+ * @c manager::ResultReader reads a result without reading the whole
+ * file.
+ *
+ * The file uses the byte order of the host. The class is not thread
+ * safe.
+ *
+ * @code
+ * manager::ResultWriter writer("results.bin");
+ * writer.write(0, result0);
+ * writer.write(1, result1);
+ * writer.close();
+ * @endcode
+ */
+class VLE_API ResultWriter
+{
+public:
+    /**
+     * Create or truncate a result file.
+     *
+     * @param filename The name of the file.
+     * @throw utils::FileError if the file can not be created.
+     */
+    ResultWriter(const std::string& filename);
+
+    /**
+     * Close the file if @c close() was not called.
+     */
+    ~ResultWriter();
+
+    /**
+     * Write the result of a combination.
+     *
+     * @param index The combination.
+     * @param result The result of the combination (can be null).
+     * @throw utils::FileError if the write fails.
+     */
+    void write(uint32_t index, const value::Value *result);
+
+    /**
+     * Write the binary representation of the result of a combination
+     * (see @c value::writeBinary).
+     *
+     * @param index The combination.
+     * @param binary The binary representation of the result.
+     * @throw utils::FileError if the write fails.
+     */
+    void write(uint32_t index, const std::string& binary);
+
+    /**
+     * Flush the records written to the file.
+     *
+     * @throw utils::FileError if the write fails.
+     */
+    void flush();
+
+    /**
+     * Append the index of the records and close the file.
+     *
+     * @throw utils::FileError if the write fails.
+     */
+    void close();
+
+    /**
+     * Get the number of records written.
+     *
+     * @return The number of records.
+     */
+    uint32_t size() const
+    { return mOffsets.size(); }
+
+private:
+    ResultWriter(const ResultWriter& other);
+    ResultWriter& operator=(const ResultWriter& other);
+
+    typedef std::vector < std::pair < uint32_t, uint64_t > > OffsetList;
+
+    std::ofstream mFile;
+    std::string   mFilename;
+    OffsetList    mOffsets;
+    uint64_t      mPosition;
+};
+
+/**
+ * @c manager::ResultReader reads the results of a file written by the
+ * @c manager::ResultWriter. If the index of the records is missing
+ * (the writer was interrupted), the complete records are found by
+ * reading the file. If a combination is written several times, the
+ * last record is used.
+ */
+class VLE_API ResultReader
+{
+public:
+    /**
+     * Open a result file and read its index.
+     *
+     * @param filename The name of the file.
+     * @throw utils::FileError if the file can not be opened or is not
+     * a result file.
+     */
+    ResultReader(const std::string& filename);
+
+    /**
+     * Check if the result of a combination exists.
+     *
+     * @param index The combination.
+     *
+     * @return true if the file contains the combination.
+     */
+    bool exist(uint32_t index) const
+    { return mOffsets.find(index) != mOffsets.end(); }
+
+    /**
+     * Read the result of a combination.
+     *
+     * @param index The combination.
+     *
+     * @return A new allocated value or null.
+     * @throw utils::ArgError if the combination does not exist or if
+     * the record is corrupted.
+     */
+    value::Value * read(uint32_t index);
+
+    /**
+     * Get the combinations of the file.
+     *
+     * @return The sorted list of the combinations.
+     */
+    std::vector < uint32_t > indices() const;
+
+    /**
+     * Get the number of combinations of the file.
+     *
+     * @return The number of combinations.
+     */
+    uint32_t size() const
+    { return mOffsets.size(); }
+
+private:
+    ResultReader(const ResultReader& other);
+    ResultReader& operator=(const ResultReader& other);
+
+    bool readIndex();
+    void scan();
+
+    std::ifstream                   mFile;
+    std::string                     mFilename;
+    std::map < uint32_t, uint64_t > mOffsets;
+};
+
+}} // namespace vle manager
+
+#endif
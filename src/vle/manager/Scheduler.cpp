@@ -0,0 +1,107 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/manager/Scheduler.hpp>
+
+namespace vle { namespace manager {
+
+Scheduler::Scheduler(uint32_t min, uint32_t max, uint32_t threads)
+    : mRanges(new Range[threads]), mThreads(threads)
+{
+    uint32_t size = max - min;
+
+    for (uint32_t i = 0; i < threads; ++i) {
+        mRanges[i].begin = min + (uint32_t)(((uint64_t)size * i) /
+                                            threads);
+        mRanges[i].end = min + (uint32_t)(((uint64_t)size * (i + 1)) /
+                                          threads);
+    }
+}
+
+bool Scheduler::next(uint32_t thread, uint32_t *index)
+{
+    {
+        boost::mutex::scoped_lock lock(mRanges[thread].mutex);
+
+        if (mRanges[thread].begin < mRanges[thread].end) {
+            *index = mRanges[thread].begin++;
+            return true;
+        }
+    }
+
+    return steal(thread, index);
+}
+
+bool Scheduler::steal(uint32_t thread, uint32_t *index)
+{
+    for (;;) {
+        uint32_t victim = mThreads;
+        uint32_t size = 0;
+
+        for (uint32_t i = 1; i < mThreads; ++i) {
+            uint32_t j = (thread + i) % mThreads;
+            boost::mutex::scoped_lock lock(mRanges[j].mutex);
+
+            if (mRanges[j].end - mRanges[j].begin > size) {
+                size = mRanges[j].end - mRanges[j].begin;
+                victim = j;
+            }
+        }
+
+        if (victim == mThreads) {
+            return false;
+        }
+
+        uint32_t begin, end;
+
+        {
+            boost::mutex::scoped_lock lock(mRanges[victim].mutex);
+
+            if (mRanges[victim].begin >= mRanges[victim].end) {
+                continue;
+            }
+
+            end = mRanges[victim].end;
+            begin = mRanges[victim].begin +
+                (mRanges[victim].end - mRanges[victim].begin) / 2;
+            mRanges[victim].end = begin;
+        }
+
+        {
+            boost::mutex::scoped_lock lock(mRanges[thread].mutex);
+
+            *index = begin;
+            mRanges[thread].begin = begin + 1;
+            mRanges[thread].end = end;
+        }
+
+        return true;
+    }
+}
+
+}} // namespace vle manager
@@ -0,0 +1,95 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_MANAGER_SCHEDULER_HPP
+#define VLE_MANAGER_SCHEDULER_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/manager/Manager.hpp>
+#include <vle/utils/Types.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/scoped_array.hpp>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::Scheduler distributes the combinations of the
+ * experimental frame to the threads of the @c manager::Manager.
+ *
+ * The combinations are split into a contiguous range per thread. A
+ * thread takes the combinations from the front of its own range and,
+ * when its range is empty, steals the back half of the largest range
+ * of the other threads. Short and long simulations are then balanced
+ * without a global lock. Each combination is given once, even if there
+ * are more threads than combinations.
+ *
+ * The functions are thread safe.
+ */
+class VLE_API Scheduler : public Source
+{
+public:
+    /**
+     * Build the ranges of the threads.
+     *
+     * @param min The first combination.
+     * @param max The combination after the last one.
+     * @param threads The number of threads.
+     */
+    Scheduler(uint32_t min, uint32_t max, uint32_t threads);
+
+    /**
+     * Get the next combination of a thread.
+     *
+     * @param thread The index of the thread.
+     * @param[out] index The combination to simulate.
+     *
+     * @return false if all the combinations are simulated or in
+     * progress.
+     */
+    virtual bool next(uint32_t thread, uint32_t *index);
+
+private:
+    Scheduler(const Scheduler& other);
+    Scheduler& operator=(const Scheduler& other);
+
+    struct Range
+    {
+        boost::mutex mutex;
+        uint32_t     begin;
+        uint32_t     end;
+    };
+
+    bool steal(uint32_t thread, uint32_t *index);
+
+    boost::scoped_array < Range > mRanges;
+    uint32_t                      mThreads;
+};
+
+}} // namespace vle manager
+
+#endif
@@ -29,6 +29,7 @@
 #include <vle/utils/ModuleManager.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Trace.hpp>
+#include <vle/utils/Exception.hpp>
 #include <vle/devs/RootCoordinator.hpp>
 #include <vle/manager/Simulation.hpp>
 #include <boost/timer.hpp>
@@ -36,28 +37,163 @@
 
 namespace vle { namespace manager {
 
+/**
+ * The @c SimulationLoader loads the @c devs::RootCoordinator from an
+ * experiment owned by the @c Simulation (deleted after the loading) or
+ * from a shared experiment with a set of conditions.
+ */
+class SimulationLoader
+{
+public:
+    SimulationLoader(vpz::Vpz *vpz)
+        : mOwned(vpz), mShared(vpz), mConditions(0), mSeeded(false),
+        mSeed(0), mAntithetic(false), mThreads(1)
+    {
+    }
+
+    SimulationLoader(const vpz::Vpz        &vpz,
+                     const vpz::Conditions &conditions,
+                     const std::string     &name)
+        : mOwned(0), mShared(&vpz), mConditions(&conditions), mName(name),
+        mSeeded(false), mSeed(0), mAntithetic(false), mThreads(1)
+    {
+    }
+
+    ~SimulationLoader()
+    {
+        delete mOwned;
+    }
+
+    const vpz::Vpz& vpz() const
+    {
+        return *mShared;
+    }
+
+    void seed(uint32_t seed, bool antithetic)
+    {
+        mSeeded = true;
+        mSeed = seed;
+        mAntithetic = antithetic;
+    }
+
+    void threads(uint32_t threads)
+    {
+        mThreads = threads;
+    }
+
+    void load(devs::RootCoordinator& root)
+    {
+        if (mSeeded) {
+            root.setSeed(mSeed, mAntithetic);
+        }
+
+        root.setModelThreads(mThreads);
+
+        if (mOwned) {
+            root.load(*mOwned);
+        } else {
+            root.load(*mShared, *mConditions, mName);
+        }
+    }
+
+    void clear()
+    {
+        if (mOwned) {
+            mOwned->clear();
+            delete mOwned;
+            mOwned = 0;
+            mShared = 0;
+        }
+    }
+
+private:
+    vpz::Vpz              *mOwned;
+    const vpz::Vpz        *mShared;
+    const vpz::Conditions *mConditions;
+    std::string            mName;
+    bool                   mSeeded;
+    uint32_t               mSeed;
+    bool                   mAntithetic;
+    uint32_t               mThreads;
+};
+
 class Simulation::Pimpl
 {
 public:
     std::ostream      *m_out;
     LogOptions         m_logoptions;
     SimulationOptions  m_simulationoptions;
+    bool               m_seeded;
+    uint32_t           m_seed;
+    bool               m_antithetic;
+    bool               m_reuse;
+    uint32_t           m_modelthreads;
+    double             m_walltime;
+    uint64_t           m_bags;
+    uint64_t           m_stall;
+
+    /*
+     * The models kept between the simulations of the same experiment
+     * and whether they can be reset.
+     */
+    devs::RootCoordinator      *m_root;
+    const vpz::Vpz             *m_vpz;
+    const utils::ModuleManager *m_modulemgr;
+    bool                        m_resettable;
 
     Pimpl(LogOptions         logoptions,
           SimulationOptions  simulationoptionts,
           std::ostream      *output)
         : m_out(output),
           m_logoptions(logoptions),
-          m_simulationoptions(simulationoptionts)
+          m_simulationoptions(simulationoptionts),
+          m_seeded(false), m_seed(0), m_antithetic(false), m_reuse(false),
+          m_modelthreads(1), m_walltime(0.0), m_bags(0), m_stall(0),
+          m_root(0), m_vpz(0), m_modulemgr(0), m_resettable(true)
     {
         if (m_simulationoptions & manager::SIMULATION_SPAWN_PROCESS)
             TraceAlways(
-                _("Simulation: SIMULATION_SPAWN_PROCESS is not yet"
-                    " implemented"));
+                _("Simulation: SIMULATION_SPAWN_PROCESS is only"
+                    " available with the manager::Manager"));
     }
 
     ~Pimpl()
     {
+        release(true);
+    }
+
+    /**
+     * Delete the kept models.
+     *
+     * @param returned true if the results of the last simulation are
+     * owned by the caller of run.
+     */
+    void release(bool returned)
+    {
+        if (m_root) {
+            m_root->finish();
+
+            if (not returned) {
+                delete m_root->outputs();
+            }
+
+            delete m_root;
+            m_root = 0;
+            m_vpz = 0;
+            m_modulemgr = 0;
+        }
+    }
+
+    /**
+     * Report the interruption of a simulation by its budget.
+     */
+    void checkBudget(const devs::RootCoordinator& root, Error *error)
+    {
+        if (not root.interrupted().empty()) {
+            error->code    = manager::ERROR_BUDGET;
+            error->message = (fmt(_("Simulation interrupted: %1%"))
+                              % root.interrupted()).str();
+        }
     }
 
     template <typename T>
@@ -70,7 +206,7 @@ public:
         }
     }
 
-    value::Map * runVerboseRun(vpz::Vpz                   *vpz,
+    value::Map * runVerboseRun(SimulationLoader           &loader,
                                const utils::ModuleManager &modulemgr,
                                Error                      *error)
     {
@@ -80,19 +216,21 @@ public:
         try {
             devs::RootCoordinator root(modulemgr);
 
-            const double duration = vpz->project().experiment().duration();
-            const double begin    = vpz->project().experiment().begin();
+            const double duration =
+                loader.vpz().project().experiment().duration();
+            const double begin    =
+                loader.vpz().project().experiment().begin();
 
-            write(fmt(_("[%1%]\n")) % vpz->filename());
+            write(fmt(_("[%1%]\n")) % loader.vpz().filename());
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            loader.load(root);
+            root.setBudget(m_walltime, m_bags, m_stall);
 
             write(_("ok\n"));
 
             write(_(" - Clean project file ...........: "));
-            vpz->clear();
-            delete vpz;
+            loader.clear();
             write(_("ok\n"));
 
             write(_(" - Coordinator initializing .....: "));
@@ -124,6 +262,7 @@ public:
                   % timer.elapsed());
 
             error->code    = 0;
+            checkBudget(root, error);
         } catch(const std::exception& e) {
             error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%"))
                               % utils::demangle(typeid(e))
@@ -134,7 +273,7 @@ public:
         return result;
     }
 
-    value::Map * runVerboseSummary(vpz::Vpz                   *vpz,
+    value::Map * runVerboseSummary(SimulationLoader           &loader,
                                    const utils::ModuleManager &modulemgr,
                                    Error                      *error)
     {
@@ -144,16 +283,16 @@ public:
         try {
             devs::RootCoordinator root(modulemgr);
 
-            write(fmt(_("[%1%]\n")) % vpz->filename());
+            write(fmt(_("[%1%]\n")) % loader.vpz().filename());
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            loader.load(root);
+            root.setBudget(m_walltime, m_bags, m_stall);
 
             write(_("ok\n"));
 
             write(_(" - Clean project file ...........: "));
-            vpz->clear();
-            delete vpz;
+            loader.clear();
             write(_("ok\n"));
 
             write(_(" - Coordinator initializing .....: "));
@@ -175,6 +314,7 @@ public:
                   % timer.elapsed());
 
             error->code    = 0;
+            checkBudget(root, error);
         } catch(const std::exception& e) {
             error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%"))
                               % utils::demangle(typeid(e))
@@ -185,7 +325,7 @@ public:
         return result;
     }
 
-    value::Map * runQuiet(vpz::Vpz                   *vpz,
+    value::Map * runQuiet(SimulationLoader           &loader,
                           const utils::ModuleManager &modulemgr,
                           Error                      *error)
     {
@@ -193,16 +333,17 @@ public:
 
         try {
             devs::RootCoordinator root(modulemgr);
-            root.load(*vpz);
-            vpz->clear();
-            delete vpz;
+            loader.load(root);
+            loader.clear();
 
+            root.setBudget(m_walltime, m_bags, m_stall);
             root.init();
             while (root.run()) {}
             root.finish();
 
             error->code    = 0;
             result         = root.outputs();
+            checkBudget(root, error);
         } catch(const std::exception& e) {
             error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%"))
                               % utils::demangle(typeid(e))
@@ -213,6 +354,73 @@ public:
         return result;
     }
 
+    value::Map * runReused(const vpz::Vpz             &vpz,
+                           const vpz::Conditions      &conditions,
+                           const std::string          &name,
+                           const utils::ModuleManager &modulemgr,
+                           Error                      *error)
+    {
+        value::Map *result = 0;
+
+        if (m_root and (m_vpz != &vpz or m_modulemgr != &modulemgr)) {
+            release(true);
+        }
+
+        try {
+            if (m_root) {
+                /*
+                 * Like a new devs::RootCoordinator, the generator is
+                 * seeded with 0 by default.
+                 */
+                m_root->setSeed(m_seeded ? m_seed : 0, m_antithetic);
+
+                try {
+                    m_root->reset(conditions, name);
+                } catch (const std::exception& e) {
+                    TraceModel(fmt(_("Simulation: the models are rebuilt"
+                                     " for each simulation: %1%"))
+                               % e.what());
+                    release(false);
+                    m_resettable = false;
+                }
+            }
+
+            if (not m_root) {
+                m_root = new devs::RootCoordinator(modulemgr);
+                m_vpz = &vpz;
+                m_modulemgr = &modulemgr;
+
+                if (m_seeded) {
+                    m_root->setSeed(m_seed, m_antithetic);
+                }
+
+                m_root->setModelThreads(m_modelthreads);
+                m_root->load(vpz, conditions, name);
+            }
+
+            m_root->setBudget(m_walltime, m_bags, m_stall);
+            m_root->init();
+            while (m_root->run()) {}
+            m_root->close();
+
+            error->code    = 0;
+            result         = m_root->outputs();
+            checkBudget(*m_root, error);
+
+            if (not m_resettable) {
+                release(true);
+            }
+        } catch(const std::exception& e) {
+            release(false);
+            error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%"))
+                              % utils::demangle(typeid(e))
+                              % e.what()).str();
+            error->code    = -1;
+        }
+
+        return result;
+    }
+
 };
 
 Simulation::Simulation(LogOptions         logoptions,
@@ -230,19 +438,85 @@ Simulation::~Simulation()
 value::Map * Simulation::run(vpz::Vpz                   *vpz,
                              const utils::ModuleManager &modulemgr,
                              Error                      *error)
+{
+    SimulationLoader loader(vpz);
+
+    return run(loader, modulemgr, error);
+}
+
+value::Map * Simulation::run(const vpz::Vpz             &vpz,
+                             const vpz::Conditions      &conditions,
+                             const std::string          &name,
+                             const utils::ModuleManager &modulemgr,
+                             Error                      *error)
+{
+    if (mPimpl->m_reuse and mPimpl->m_logoptions == manager::LOG_NONE) {
+        value::Map *result = mPimpl->runReused(vpz, conditions, name,
+                                               modulemgr, error);
+
+        if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN) {
+            delete result;
+            return NULL;
+        }
+
+        return result;
+    }
+
+    SimulationLoader loader(vpz, conditions, name);
+
+    return run(loader, modulemgr, error);
+}
+
+void Simulation::setSeed(uint32_t seed, bool antithetic)
+{
+    mPimpl->m_seeded = true;
+    mPimpl->m_seed = seed;
+    mPimpl->m_antithetic = antithetic;
+}
+
+void Simulation::setBudget(double walltime, uint64_t bags, uint64_t stall)
+{
+    mPimpl->m_walltime = walltime;
+    mPimpl->m_bags = bags;
+    mPimpl->m_stall = stall;
+}
+
+void Simulation::setModelThreads(uint32_t threads)
+{
+    mPimpl->m_modelthreads = threads;
+}
+
+void Simulation::setReuse(bool reuse)
+{
+    mPimpl->m_reuse = reuse;
+
+    if (not reuse) {
+        mPimpl->release(true);
+    }
+}
+
+value::Map * Simulation::run(SimulationLoader           &loader,
+                             const utils::ModuleManager &modulemgr,
+                             Error                      *error)
 {
     error->code = 0;
     value::Map *result = NULL;
 
+    if (mPimpl->m_seeded) {
+        loader.seed(mPimpl->m_seed, mPimpl->m_antithetic);
+    }
+
+    loader.threads(mPimpl->m_modelthreads);
+
     if (mPimpl->m_logoptions != manager::LOG_NONE) {
         if (mPimpl->m_logoptions & manager::LOG_RUN and mPimpl->m_out) {
-            result = mPimpl->runVerboseRun(vpz, modulemgr, error);
+            result = mPimpl->runVerboseRun(loader, modulemgr, error);
         } else {
-            result = mPimpl->runVerboseSummary(vpz, modulemgr, error);
+            result = mPimpl->runVerboseSummary(loader, modulemgr, error);
         }
 
     } else {
-        result = mPimpl->runQuiet(vpz, modulemgr, error);
+        result = mPimpl->runQuiet(loader, modulemgr, error);
     }
 
     if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN) {
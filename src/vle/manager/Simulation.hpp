@@ -35,6 +35,8 @@
 
 namespace vle { namespace manager {
 
+class SimulationLoader;
+
 /**
  * @c manager::Simulation permits to run single simulation.
  *
@@ -58,10 +60,86 @@ public:
                      const utils::ModuleManager &modulemgr,
                      Error                      *error);
 
+    /**
+     * Run a simulation of a shared experiment.
+     *
+     * The @c vpz::Vpz is not modified and not deleted, it can be used
+     * by several simulations at the same time. The model hierarchy is
+     * shared (cloned only if an Executive can modify it) and the @c
+     * conditions replace the conditions of the experiment with the same
+     * name. When the models are reused, the @c vpz::Vpz must outlive the
+     * @c Simulation.
+     *
+     * @param vpz The experiment to simulate.
+     * @param conditions The conditions of this simulation.
+     * @param name The name of the experiment of this simulation.
+     * @param modulemgr The modules of the simulation.
+     * @param[out] error The error of the simulation.
+     *
+     * @return A @c value::Map to freed.
+     */
+    value::Map * run(const vpz::Vpz             &vpz,
+                     const vpz::Conditions      &conditions,
+                     const std::string          &name,
+                     const utils::ModuleManager &modulemgr,
+                     Error                      *error);
+
+    /**
+     * Assign the seed of the random number generator and of the random
+     * streams of the models of the @c devs::RootCoordinator of the next
+     * simulations (see @c devs::RootCoordinator::setSeed). By default,
+     * the generator is seeded with 0.
+     *
+     * @param seed The seed.
+     * @param antithetic true to simulate the antithetic replicate of
+     * the simulation with the same seed.
+     */
+    void setSeed(uint32_t seed, bool antithetic = false);
+
+    /**
+     * Assign the number of threads which build and initialize the atomic
+     * models of the next simulations (see @c
+     * devs::RootCoordinator::setModelThreads). By default, the models
+     * are built one at a time.
+     *
+     * @param threads The number of threads.
+     */
+    void setModelThreads(uint32_t threads);
+
+    /**
+     * Keep the models of the simulations of a shared experiment between
+     * the calls to run: the next simulation of the same experiment
+     * resets the models (see @c devs::Dynamics::reset) instead of
+     * rebuilding them. If a model cannot be reset, the models are
+     * rebuilt for each simulation. The models are only kept without
+     * log (@c manager::LOG_NONE).
+     *
+     * @param reuse true to keep the models.
+     */
+    void setReuse(bool reuse);
+
+    /**
+     * Assign the budget of the next simulations (see @c
+     * devs::RootCoordinator::setBudget). A simulation which reaches a
+     * limit is interrupted, its error code is @c manager::ERROR_BUDGET
+     * and its results are the partial results. A limit of zero is no
+     * limit.
+     *
+     * @param walltime The maximum wall-clock time in seconds.
+     * @param bags The maximum number of bags of events.
+     * @param stall The maximum number of successive bags at the same
+     * time.
+     */
+    void setBudget(double walltime, uint64_t bags, uint64_t stall);
+
 private:
     Simulation(const Simulation &other);
     Simulation& operator=(const Simulation &other);
 
+    value::Map * run(SimulationLoader           &loader,
+                     const utils::ModuleManager &modulemgr,
+                     Error                      *error);
+
     class Pimpl;
     Pimpl *mPimpl;
 };
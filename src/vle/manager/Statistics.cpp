@@ -0,0 +1,549 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Statistics.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+#include <cmath>
+
+namespace vle { namespace manager {
+
+/**
+ * Compute a quantile of a sorted sample with a linear interpolation
+ * between the closest ranks.
+ *
+ * @param sorted The sorted sample.
+ * @param size The size of the sample.
+ * @param probability The probability of the quantile.
+ *
+ * @return The quantile.
+ */
+static double exactQuantile(const double *sorted, uint32_t size,
+                            double probability)
+{
+    double position = probability * (size - 1);
+    uint32_t lower = static_cast < uint32_t >(position);
+
+    if (lower + 1 >= size) {
+        return sorted[size - 1];
+    }
+
+    return sorted[lower] + (position - lower) *
+        (sorted[lower + 1] - sorted[lower]);
+}
+
+/**
+ * Compute a quantile of the standard normal distribution (P. J.
+ * Acklam's rational approximation, relative error below 1.15e-9).
+ *
+ * @param p The probability in ]0, 1[.
+ *
+ * @return The quantile.
+ */
+static double normalQuantile(double p)
+{
+    static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02,
+                                -2.759285104469687e+02, 1.383577518672690e+02,
+                                -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02,
+                                -1.556989798598866e+02, 6.680131188771972e+01,
+                                -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01,
+                                -2.400758277161838e+00, -2.549732539343734e+00,
+                                4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01,
+                                2.445134137142996e+00, 3.754408661907416e+00 };
+
+    if (p < 0.02425) {
+        double q = std::sqrt(-2.0 * std::log(p));
+
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+                c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+
+    if (p > 1.0 - 0.02425) {
+        return -normalQuantile(1.0 - p);
+    }
+
+    double q = p - 0.5;
+    double r = q * q;
+
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r +
+            a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r +
+                          b[4]) * r + 1.0);
+}
+
+/**
+ * Compute a quantile of the Student's t distribution: exact with one
+ * and two degrees of freedom, the Cornish-Fisher expansion of the
+ * normal quantile otherwise (Abramowitz and Stegun 26.7.5).
+ *
+ * @param p The probability in ]0, 1[.
+ * @param n The degrees of freedom.
+ *
+ * @return The quantile.
+ */
+static double studentQuantile(double p, uint32_t n)
+{
+    if (n == 1) {
+        return std::tan(M_PI * (p - 0.5));
+    }
+
+    if (n == 2) {
+        return (2.0 * p - 1.0) / std::sqrt(2.0 * p * (1.0 - p));
+    }
+
+    double z = normalQuantile(p);
+    double z2 = z * z;
+    double v = n;
+
+    double g1 = (z2 + 1.0) * z / 4.0;
+    double g2 = ((5.0 * z2 + 16.0) * z2 + 3.0) * z / 96.0;
+    double g3 = (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) * z / 384.0;
+    double g4 = ((((79.0 * z2 + 776.0) * z2 + 1482.0) * z2 - 1920.0) * z2 -
+                 945.0) * z / 92160.0;
+
+    return z + g1 / v + g2 / (v * v) + g3 / (v * v * v) +
+        g4 / (v * v * v * v);
+}
+
+Quantile::Quantile(double probability)
+    : mProbability(probability), mCount(0)
+{
+    if (not (probability > 0.0 and probability < 1.0)) {
+        throw utils::ArgError(
+            fmt(_("Quantile: the probability %1% is not in ]0, 1[")) %
+            probability);
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        mHeights[i] = 0.0;
+        mPositions[i] = i + 1;
+    }
+
+    mDesired[0] = 1.0;
+    mDesired[1] = 1.0 + 2.0 * probability;
+    mDesired[2] = 1.0 + 4.0 * probability;
+    mDesired[3] = 3.0 + 2.0 * probability;
+    mDesired[4] = 5.0;
+}
+
+void Quantile::add(double x)
+{
+    if (mCount < 5) {
+        mHeights[mCount++] = x;
+
+        if (mCount == 5) {
+            std::sort(mHeights, mHeights + 5);
+        }
+
+        return;
+    }
+
+    ++mCount;
+
+    int k;
+    if (x < mHeights[0]) {
+        mHeights[0] = x;
+        k = 0;
+    } else if (x >= mHeights[4]) {
+        mHeights[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= mHeights[k + 1]) {
+            ++k;
+        }
+    }
+
+    for (int i = k + 1; i < 5; ++i) {
+        mPositions[i] += 1.0;
+    }
+
+    const double increment[5] = { 0.0, mProbability / 2.0, mProbability,
+                                  (1.0 + mProbability) / 2.0, 1.0 };
+
+    for (int i = 0; i < 5; ++i) {
+        mDesired[i] += increment[i];
+    }
+
+    for (int i = 1; i < 4; ++i) {
+        double d = mDesired[i] - mPositions[i];
+
+        if ((d >= 1.0 and mPositions[i + 1] - mPositions[i] > 1.0) or
+            (d <= -1.0 and mPositions[i - 1] - mPositions[i] < -1.0)) {
+            int sign = d >= 0.0 ? 1 : -1;
+            double height = parabolic(i, sign);
+
+            if (mHeights[i - 1] < height and height < mHeights[i + 1]) {
+                mHeights[i] = height;
+            } else {
+                mHeights[i] = linear(i, sign);
+            }
+
+            mPositions[i] += sign;
+        }
+    }
+}
+
+double Quantile::value() const
+{
+    if (mCount == 0) {
+        return 0.0;
+    }
+
+    if (mCount >= 5) {
+        return mHeights[2];
+    }
+
+    double sorted[5];
+    std::copy(mHeights, mHeights + mCount, sorted);
+    std::sort(sorted, sorted + mCount);
+
+    return exactQuantile(sorted, mCount, mProbability);
+}
+
+void Quantile::initialize(const std::vector < double >& sorted)
+{
+    assert(sorted.size() >= 5);
+
+    mCount = sorted.size();
+
+    const double n = mCount;
+    mDesired[0] = 1.0;
+    mDesired[1] = 1.0 + (n - 1.0) * mProbability / 2.0;
+    mDesired[2] = 1.0 + (n - 1.0) * mProbability;
+    mDesired[3] = 1.0 + (n - 1.0) * (1.0 + mProbability) / 2.0;
+    mDesired[4] = n;
+
+    /*
+     * The positions of the markers are the closest ranks of the desired
+     * positions, strictly increasing.
+     */
+    mPositions[0] = 1.0;
+    mPositions[4] = n;
+    for (int i = 1; i < 4; ++i) {
+        mPositions[i] = std::floor(mDesired[i] + 0.5);
+        mPositions[i] = std::max(mPositions[i], mPositions[i - 1] + 1.0);
+        mPositions[i] = std::min(mPositions[i], n - 4.0 + i);
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        mHeights[i] = sorted[static_cast < uint32_t >(mPositions[i]) - 1];
+    }
+}
+
+double Quantile::parabolic(int i, double d) const
+{
+    return mHeights[i] + d / (mPositions[i + 1] - mPositions[i - 1]) *
+        ((mPositions[i] - mPositions[i - 1] + d) *
+         (mHeights[i + 1] - mHeights[i]) /
+         (mPositions[i + 1] - mPositions[i]) +
+         (mPositions[i + 1] - mPositions[i] - d) *
+         (mHeights[i] - mHeights[i - 1]) /
+         (mPositions[i] - mPositions[i - 1]));
+}
+
+double Quantile::linear(int i, int d) const
+{
+    return mHeights[i] + d * (mHeights[i + d] - mHeights[i]) /
+        (mPositions[i + d] - mPositions[i]);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+Statistics::Statistics(const std::vector < double >& probabilities)
+    : mCount(0), mMean(0.0), mM2(0.0),
+      mMin(std::numeric_limits < double >::infinity()),
+      mMax(-std::numeric_limits < double >::infinity()),
+      mQuantiles(probabilities.begin(), probabilities.end())
+{
+}
+
+void Statistics::add(double x)
+{
+    ++mCount;
+
+    double delta = x - mMean;
+    mMean += delta / mCount;
+    mM2 += delta * (x - mMean);
+
+    mMin = std::min(mMin, x);
+    mMax = std::max(mMax, x);
+
+    if (mQuantiles.empty()) {
+        return;
+    }
+
+    if (mCount <= sample) {
+        mSample.push_back(x);
+        return;
+    }
+
+    if (not mSample.empty()) {
+        std::sort(mSample.begin(), mSample.end());
+
+        for (std::vector < Quantile >::iterator it = mQuantiles.begin();
+             it != mQuantiles.end(); ++it) {
+            it->initialize(mSample);
+        }
+
+        std::vector < double >().swap(mSample);
+    }
+
+    for (std::vector < Quantile >::iterator it = mQuantiles.begin();
+         it != mQuantiles.end(); ++it) {
+        it->add(x);
+    }
+}
+
+double Statistics::variance() const
+{
+    return mCount > 1 ? mM2 / (mCount - 1) : 0.0;
+}
+
+double Statistics::interval(double confidence) const
+{
+    if (not (confidence > 0.0 and confidence < 1.0)) {
+        throw utils::ArgError(
+            fmt(_("Statistics: the confidence %1% is not in ]0, 1[")) %
+            confidence);
+    }
+
+    if (mCount < 2) {
+        return std::numeric_limits < double >::infinity();
+    }
+
+    return studentQuantile(0.5 + confidence / 2.0, mCount - 1) *
+        std::sqrt(variance() / mCount);
+}
+
+double Statistics::quantile(std::vector < Quantile >::size_type i) const
+{
+    if (mCount == 0) {
+        return 0.0;
+    }
+
+    if (mCount <= sample) {
+        std::vector < double > sorted(mSample);
+        std::sort(sorted.begin(), sorted.end());
+
+        return exactQuantile(&sorted[0], sorted.size(),
+                             mQuantiles[i].probability());
+    }
+
+    return mQuantiles[i].value();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+Reduction::Reduction(const std::vector < double >& probabilities)
+    : mProbabilities(probabilities), mSize(0)
+{
+    for (std::vector < double >::const_iterator it = probabilities.begin();
+         it != probabilities.end(); ++it) {
+        Quantile check(*it);
+    }
+}
+
+Reduction::~Reduction()
+{
+    for (ViewList::iterator it = mViews.begin(); it != mViews.end(); ++it) {
+        View *view = it->second;
+
+        for (Statistics **jt = view->statistics.data();
+             jt != view->statistics.data() +
+                 view->statistics.num_elements(); ++jt) {
+            delete *jt;
+        }
+
+        for (value::Value **jt = view->labels.data();
+             jt != view->labels.data() + view->labels.num_elements(); ++jt) {
+            delete *jt;
+        }
+
+        delete view;
+    }
+}
+
+void Reduction::add(const value::Map& result)
+{
+    for (value::Map::const_iterator it = result.begin(); it != result.end();
+         ++it) {
+        if (not it->second or not it->second->isMatrix()) {
+            continue;
+        }
+
+        ViewList::iterator jt = mViews.find(it->first);
+
+        if (jt == mViews.end()) {
+            jt = mViews.insert(std::make_pair(it->first, new View())).first;
+        }
+
+        add(jt->second, it->second->toMatrix());
+    }
+
+    ++mSize;
+}
+
+void Reduction::add(View *view, const value::Matrix& matrix)
+{
+    typedef boost::multi_array < Statistics*, 2 >::size_type size_type;
+
+    size_type columns = std::max(view->statistics.shape()[0],
+                                 static_cast < size_type >(matrix.columns()));
+    size_type rows = std::max(view->statistics.shape()[1],
+                              static_cast < size_type >(matrix.rows()));
+
+    if (columns != view->statistics.shape()[0] or
+        rows != view->statistics.shape()[1]) {
+        view->statistics.resize(boost::extents[columns][rows]);
+        view->labels.resize(boost::extents[columns][rows]);
+    }
+
+    for (value::Matrix::size_type j = 0; j < matrix.rows(); ++j) {
+        for (value::Matrix::size_type i = 0; i < matrix.columns(); ++i) {
+            const value::Value *cell = matrix.matrix()[i][j];
+
+            if (not cell) {
+                continue;
+            }
+
+            if (cell->isDouble() or cell->isInteger()) {
+                Statistics *&stats = view->statistics[i][j];
+
+                if (not stats) {
+                    stats = new Statistics(mProbabilities);
+                }
+
+                stats->add(cell->isDouble() ?
+                           cell->toDouble().value() :
+                           static_cast < double >(
+                               cell->toInteger().value()));
+            } else if (not view->labels[i][j]) {
+                view->labels[i][j] = cell->clone();
+            }
+        }
+    }
+}
+
+value::Map * Reduction::summary() const
+{
+    value::Map *result = new value::Map();
+
+    for (ViewList::const_iterator it = mViews.begin(); it != mViews.end();
+         ++it) {
+        result->add(it->first, summary(*it->second));
+    }
+
+    return result;
+}
+
+value::Map * Reduction::summary(const View& view) const
+{
+    value::Matrix::size_type columns = view.statistics.shape()[0];
+    value::Matrix::size_type rows = view.statistics.shape()[1];
+
+    value::Matrix *count = new value::Matrix(columns, rows, 1, 1);
+    value::Matrix *mean = new value::Matrix(columns, rows, 1, 1);
+    value::Matrix *variance = new value::Matrix(columns, rows, 1, 1);
+    value::Matrix *min = new value::Matrix(columns, rows, 1, 1);
+    value::Matrix *max = new value::Matrix(columns, rows, 1, 1);
+    value::Set *quantiles = new value::Set();
+
+    std::vector < value::Matrix* > quantile(mProbabilities.size());
+    for (std::vector < value::Matrix* >::size_type q = 0;
+         q < quantile.size(); ++q) {
+        quantile[q] = new value::Matrix(columns, rows, 1, 1);
+        quantiles->add(quantile[q]);
+    }
+
+    for (value::Matrix::size_type j = 0; j < rows; ++j) {
+        for (value::Matrix::size_type i = 0; i < columns; ++i) {
+            const Statistics *stats = view.statistics[i][j];
+
+            if (stats) {
+                count->addInt(i, j, stats->count());
+                mean->addDouble(i, j, stats->mean());
+                variance->addDouble(i, j, stats->variance());
+                min->addDouble(i, j, stats->min());
+                max->addDouble(i, j, stats->max());
+
+                for (std::vector < value::Matrix* >::size_type q = 0;
+                     q < quantile.size(); ++q) {
+                    quantile[q]->addDouble(i, j, stats->quantile(q));
+                }
+            } else if (view.labels[i][j]) {
+                const value::Value& label = *view.labels[i][j];
+
+                count->add(i, j, label);
+                mean->add(i, j, label);
+                variance->add(i, j, label);
+                min->add(i, j, label);
+                max->add(i, j, label);
+
+                for (std::vector < value::Matrix* >::size_type q = 0;
+                     q < quantile.size(); ++q) {
+                    quantile[q]->add(i, j, label);
+                }
+            }
+        }
+    }
+
+    value::Map *result = new value::Map();
+    result->add("count", count);
+    result->add("mean", mean);
+    result->add("variance", variance);
+    result->add("min", min);
+    result->add("max", max);
+    result->add("quantiles", quantiles);
+
+    return result;
+}
+
+const Statistics * Reduction::get(const std::string& view,
+                                  value::Matrix::size_type column,
+                                  value::Matrix::size_type row) const
+{
+    ViewList::const_iterator it = mViews.find(view);
+
+    if (it == mViews.end() or
+        column >= it->second->statistics.shape()[0] or
+        row >= it->second->statistics.shape()[1]) {
+        return 0;
+    }
+
+    return it->second->statistics[column][row];
+}
+
+}} // namespace vle manager
@@ -0,0 +1,275 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_STATISTICS_HPP
+#define VLE_MANAGER_STATISTICS_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <boost/multi_array.hpp>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::Quantile estimates a quantile of a stream of reals with
+ * the P-square algorithm (R. Jain and I. Chlamtac, 1985): only five
+ * markers are stored whatever the number of observations.
+ */
+class VLE_API Quantile
+{
+public:
+    /**
+     * Build an estimator of a quantile.
+     *
+     * @param probability The probability of the quantile in ]0, 1[.
+     * @throw utils::ArgError if the probability is not in ]0, 1[.
+     */
+    Quantile(double probability);
+
+    /**
+     * Add an observation.
+     *
+     * @param x The observation.
+     */
+    void add(double x);
+
+    /**
+     * Replace the observations with a sample. The markers are
+     * initialized from the sample.
+     *
+     * @param sorted The sorted sample (at least five observations).
+     */
+    void initialize(const std::vector < double >& sorted);
+
+    /**
+     * Get the estimation of the quantile. The quantile is exact with
+     * less than six observations.
+     *
+     * @return The estimation of the quantile or 0 without observation.
+     */
+    double value() const;
+
+    double probability() const
+    { return mProbability; }
+
+    uint32_t count() const
+    { return mCount; }
+
+private:
+    double parabolic(int i, double d) const;
+    double linear(int i, int d) const;
+
+    double   mProbability;
+    uint32_t mCount;
+    double   mHeights[5];
+    double   mPositions[5];
+    double   mDesired[5];
+};
+
+/**
+ * @c manager::Statistics computes the count, the mean, the variance
+ * (Welford's algorithm), the minimum, the maximum and some quantiles
+ * of a stream of reals in constant memory. The quantiles are exact
+ * for the first @c Statistics::sample observations, then estimated
+ * with @c manager::Quantile.
+ */
+class VLE_API Statistics
+{
+public:
+    /** The number of observations stored to compute exact quantiles. */
+    static const uint32_t sample = 32;
+
+    /**
+     * Build an empty statistics.
+     *
+     * @param probabilities The probabilities of the quantiles.
+     */
+    Statistics(const std::vector < double >& probabilities =
+               std::vector < double >());
+
+    /**
+     * Add an observation.
+     *
+     * @param x The observation.
+     */
+    void add(double x);
+
+    uint32_t count() const
+    { return mCount; }
+
+    double mean() const
+    { return mMean; }
+
+    /**
+     * Get the unbiased variance of the observations.
+     *
+     * @return The variance or 0 with less than two observations.
+     */
+    double variance() const;
+
+    /**
+     * Get the half width of the confidence interval of the mean, with
+     * the Student's t distribution.
+     *
+     * @param confidence The confidence level in ]0, 1[ (0.95 for
+     * example).
+     *
+     * @return The half width or infinity with less than two
+     * observations.
+     * @throw utils::ArgError if the confidence is not in ]0, 1[.
+     */
+    double interval(double confidence) const;
+
+    double min() const
+    { return mMin; }
+
+    double max() const
+    { return mMax; }
+
+    /**
+     * Get the estimation of a quantile.
+     *
+     * @param i The index of the probability given to the constructor.
+     *
+     * @return The estimation of the quantile.
+     */
+    double quantile(std::vector < Quantile >::size_type i) const;
+
+private:
+    uint32_t                mCount;
+    double                  mMean;
+    double                  mM2;
+    double                  mMin;
+    double                  mMax;
+    std::vector < Quantile > mQuantiles;
+    std::vector < double >   mSample;
+};
+
+/**
+ * @c manager::Reduction folds the results of the simulations into
+ * statistics as soon as they are available, instead of storing all
+ * the results.
+ *
+ * For each view, the statistics are computed for each numeric cell
+ * (value::Double or value::Integer) of the result matrix: a cell is
+ * an observable at a time point. The other cells (the header of the
+ * matrix for example) are copied from the first result.
+ *
+ * The summary is a @c value::Map. The key is the name of the view and
+ * the value is a @c value::Map with the keys "count", "mean",
+ * "variance", "min", "max" and "quantiles". The "quantiles" is a @c
+ * value::Set of matrix, one by probability. The others are matrix with
+ * the shape of the largest result matrix of the view.
+ *
+ * @code
+ * std::vector < double > probabilities;
+ * probabilities.push_back(0.5);
+ *
+ * manager::Reduction reduction(probabilities);
+ * reduction.add(*result1);
+ * reduction.add(*result2);
+ *
+ * value::Map *summary = reduction.summary();
+ * @endcode
+ */
+class VLE_API Reduction
+{
+public:
+    /**
+     * Build an empty reduction.
+     *
+     * @param probabilities The probabilities of the quantiles.
+     */
+    Reduction(const std::vector < double >& probabilities =
+              std::vector < double >());
+
+    ~Reduction();
+
+    /**
+     * Fold the result of a simulation.
+     *
+     * @param result The result of a simulation (the views and their
+     * matrix).
+     */
+    void add(const value::Map& result);
+
+    /**
+     * Build the summary of the results.
+     *
+     * @return A new allocated @c value::Map.
+     */
+    value::Map * summary() const;
+
+    /**
+     * Get the number of results folded.
+     *
+     * @return The number of results.
+     */
+    uint32_t size() const
+    { return mSize; }
+
+    /**
+     * Get the statistics of a cell of a view.
+     *
+     * @param view The name of the view.
+     * @param column The column of the cell.
+     * @param row The row of the cell.
+     *
+     * @return The statistics or null if the cell does not exist.
+     */
+    const Statistics * get(const std::string& view,
+                           value::Matrix::size_type column,
+                           value::Matrix::size_type row) const;
+
+private:
+    Reduction(const Reduction& other);
+    Reduction& operator=(const Reduction& other);
+
+    struct View
+    {
+        boost::multi_array < Statistics*, 2 > statistics;
+        boost::multi_array < value::Value*, 2 > labels;
+    };
+
+    typedef std::map < std::string, View* > ViewList;
+
+    void add(View *view, const value::Matrix& matrix);
+    value::Map * summary(const View& view) const;
+
+    std::vector < double > mProbabilities;
+    ViewList               mViews;
+    uint32_t               mSize;
+};
+
+}} // namespace vle manager
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Streams.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/details/Tools.hpp>
+
+namespace vle { namespace manager {
+
+const std::string& Streams::name()
+{
+    static const std::string result("vle.random");
+
+    return result;
+}
+
+Streams::Streams(const vpz::Conditions& conditions)
+    : mSeed(0), mCommon(true), mAntithetic(false)
+{
+    const vpz::Condition& streams(conditions.get(name()));
+    const vpz::ConditionValues& ports(streams.conditionvalues());
+
+    for (vpz::ConditionValues::const_iterator it = ports.begin();
+         it != ports.end(); ++it) {
+        if (it->first == "seed") {
+            const value::Value *value = utils::getPortValue(
+                streams, it->first, "Streams");
+
+            if (not value->isInteger() or value->toInteger().value() < 0) {
+                throw utils::ArgError(
+                    _("Streams: the port `seed' must be a positive"
+                      " integer"));
+            }
+
+            mSeed = value->toInteger().value();
+        } else if (it->first == "common") {
+            mCommon = utils::toPortBoolean(streams, it->first, "Streams");
+        } else if (it->first == "antithetic") {
+            mAntithetic = utils::toPortBoolean(streams, it->first,
+                                               "Streams");
+        } else {
+            throw utils::ArgError(
+                fmt(_("Streams: unknown port `%1%'")) % it->first);
+        }
+    }
+}
+
+uint32_t Streams::seed(uint32_t index, uint32_t replicate) const
+{
+    uint64_t x = utils::mix(static_cast < uint64_t >(mSeed) << 32);
+
+    if (not mCommon) {
+        x = utils::mix(x ^ index);
+    }
+
+    return static_cast < uint32_t >(
+        utils::mix(x ^ (replicate / group())) >> 32);
+}
+
+}} // namespace vle manager
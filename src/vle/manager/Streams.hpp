@@ -0,0 +1,133 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_STREAMS_HPP
+#define VLE_MANAGER_STREAMS_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/vpz/Conditions.hpp>
+#include <string>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::Streams assigns the seeds of the simulations to reduce
+ * the variance of the comparison of the combinations. The seed of a
+ * simulation is given to the @c devs::RootCoordinator, which seeds the
+ * random stream of each model from this seed and the complete name of
+ * the model (see @c devs::Dynamics::rand): the stream of a model does
+ * not change when models are added or removed.
+ *
+ * With common random numbers (the default), the seed of a replicate
+ * does not depend on the combination: all the combinations are
+ * simulated with the same streams and their differences are not hidden
+ * by the noise of independent streams. With antithetic replicates, the
+ * replicates are simulated by pairs: the second replicate of a pair has
+ * the seed of the first one and antithetic streams (see @c
+ * utils::Rand::setAntithetic). Without @c manager::Replication, a
+ * combination is simulated once or, with antithetic replicates, once by
+ * pair.
+ *
+ * The streams are described by the condition @c Streams::name() of the
+ * experiment. Its ports are optional:
+ * - @c seed: a @c value::Integer, the base of the seeds.
+ * - @c common: a @c value::Boolean, true (the default) to use common
+ *   random numbers, false to use independent seeds for each
+ *   combination.
+ * - @c antithetic: a @c value::Boolean, true to simulate antithetic
+ *   pairs of replicates.
+ *
+ * @code
+ * <condition name="vle.random">
+ *  <port name="seed"><integer>123</integer></port>
+ *  <port name="antithetic"><boolean>true</boolean></port>
+ * </condition>
+ * @endcode
+ */
+class VLE_API Streams
+{
+public:
+    /**
+     * Build the streams from their condition.
+     *
+     * @param conditions The conditions of the experiment. The
+     * condition @c Streams::name() describes the streams.
+     *
+     * @throw utils::ArgError if the description is not valid.
+     */
+    Streams(const vpz::Conditions& conditions);
+
+    /**
+     * Get the name of the condition which describes the streams.
+     *
+     * @return "vle.random".
+     */
+    static const std::string& name();
+
+    /**
+     * Compute the seed of a replicate of a combination. The two
+     * replicates of an antithetic pair have the same seed.
+     *
+     * @param index The combination.
+     * @param replicate The replicate of the combination.
+     *
+     * @return The seed.
+     */
+    uint32_t seed(uint32_t index, uint32_t replicate) const;
+
+    /**
+     * Check if the streams of a replicate are antithetic.
+     *
+     * @param replicate The replicate of a combination.
+     *
+     * @return true for the second replicate of an antithetic pair.
+     */
+    bool antithetic(uint32_t replicate) const
+    { return mAntithetic and replicate % 2; }
+
+    /**
+     * Get the number of replicates simulated together: the statistics
+     * of the replicates are computed on the means of the groups.
+     *
+     * @return 2 with antithetic pairs, 1 otherwise.
+     */
+    uint32_t group() const
+    { return mAntithetic ? 2 : 1; }
+
+    bool common() const
+    { return mCommon; }
+
+private:
+    uint32_t mSeed;
+    bool     mCommon;
+    bool     mAntithetic;
+};
+
+}} // namespace vle manager
+
+#endif
@@ -0,0 +1,398 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/TableFile.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/String.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <fstream>
+#include <sstream>
+#include <locale>
+#include <memory>
+#include <limits>
+#include <cerrno>
+#include <cstring>
+
+#if not defined _WIN32 && not defined __CYGWIN__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace vle { namespace manager {
+
+/*
+ * The header of a binary table.
+ */
+static const char binaryMagic[] = { 'V', 'L', 'E', 'T', 'A', 'B', 'L', 'E' };
+
+static std::string trim(const std::string& str)
+{
+    std::string::size_type first = str.find_first_not_of(" \t");
+
+    if (first == std::string::npos) {
+        return std::string();
+    }
+
+    return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+}
+
+/*
+ * Read a number from a whole token. The numbers are read with the
+ * classic locale: the program locale (see vle::Init) may use another
+ * decimal separator.
+ */
+template < typename T >
+static bool parse(const std::string& token, T *result)
+{
+    std::istringstream in(token);
+
+    in.imbue(std::locale::classic());
+    in >> *result;
+
+    return in.eof() and not in.fail();
+}
+
+/*
+ * Convert a CSV value: an integer, a real or a string.
+ */
+static value::Value * toValue(const std::string& token, bool quoted)
+{
+    if (not quoted and not token.empty()) {
+        int32_t integer;
+        double real;
+
+        if (parse(token, &integer)) {
+            return value::Integer::create(integer);
+        }
+
+        if (parse(token, &real)) {
+            return value::Double::create(real);
+        }
+    }
+
+    return value::String::create(token);
+}
+
+TableFile::TableFile(const std::string& filename)
+    : mData(0), mSize(0), mFilename(filename), mValues(0), mRows(0),
+    mBinary(false)
+{
+    map(filename);
+
+    try {
+        if (mSize >= sizeof(binaryMagic) and
+            std::memcmp(mData, binaryMagic, sizeof(binaryMagic)) == 0) {
+            mBinary = true;
+            readBinary();
+        } else {
+            readCsv();
+        }
+    } catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+TableFile::~TableFile()
+{
+    unmap();
+}
+
+void TableFile::map(const std::string& filename)
+{
+#if defined _WIN32 || defined __CYGWIN__
+    std::ifstream file(filename.c_str(), std::ios::binary);
+
+    if (not file) {
+        throw utils::ArgError(
+            fmt(_("TableFile: cannot open `%1%'")) % filename);
+    }
+
+    mBuffer.assign(std::istreambuf_iterator < char >(file),
+                   std::istreambuf_iterator < char >());
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    struct stat st;
+
+    if (fd == -1 or ::fstat(fd, &st) == -1) {
+        if (fd != -1) {
+            ::close(fd);
+        }
+
+        throw utils::ArgError(
+            fmt(_("TableFile: cannot open `%1%': %2%")) % filename %
+            std::strerror(errno));
+    }
+
+    mSize = static_cast < std::size_t >(st.st_size);
+
+    if (mSize > 0) {
+        void *data = ::mmap(0, mSize, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (data == MAP_FAILED) {
+            int error = errno;
+
+            ::close(fd);
+            throw utils::ArgError(
+                fmt(_("TableFile: cannot map `%1%': %2%")) % filename %
+                std::strerror(error));
+        }
+
+        mData = static_cast < const char* >(data);
+    }
+
+    ::close(fd);
+#endif
+}
+
+void TableFile::unmap()
+{
+#if not defined _WIN32 && not defined __CYGWIN__
+    if (mData) {
+        ::munmap(const_cast < char* >(mData), mSize);
+    }
+#endif
+
+    mData = 0;
+    mSize = 0;
+    mBuffer.clear();
+}
+
+void TableFile::readBinary()
+{
+    std::size_t position = sizeof(binaryMagic);
+    uint32_t header[2];
+
+    if (mSize - position < sizeof(header)) {
+        throw utils::ArgError(
+            fmt(_("TableFile: `%1%' is truncated")) % mFilename);
+    }
+
+    std::memcpy(header, mData + position, sizeof(header));
+    position += sizeof(header);
+
+    for (uint32_t i = 0; i < header[0]; ++i) {
+        uint32_t size;
+
+        if (mSize - position < sizeof(size)) {
+            throw utils::ArgError(
+                fmt(_("TableFile: `%1%' is truncated")) % mFilename);
+        }
+
+        std::memcpy(&size, mData + position, sizeof(size));
+        position += sizeof(size);
+
+        if (mSize - position < size) {
+            throw utils::ArgError(
+                fmt(_("TableFile: `%1%' is truncated")) % mFilename);
+        }
+
+        mColumns.push_back(std::string(mData + position, size));
+        position += size;
+    }
+
+    mValues = position;
+    mRows = header[1];
+
+    if (mColumns.empty() or
+        (mSize - position) / sizeof(double) / mColumns.size() < mRows) {
+        throw utils::ArgError(
+            fmt(_("TableFile: `%1%' has no column or is truncated"))
+            % mFilename);
+    }
+}
+
+std::size_t TableFile::readCsvLine(std::size_t position,
+                                   std::vector < std::string > *fields,
+                                   std::vector < bool > *quoted) const
+{
+    std::string field;
+    bool isquoted = false;
+    bool inquotes = false;
+
+    fields->clear();
+    quoted->clear();
+
+    for (; position < mSize and mData[position] != '\n'; ++position) {
+        char c = mData[position];
+
+        if (inquotes) {
+            if (c != '"') {
+                field += c;
+            } else if (position + 1 < mSize and mData[position + 1] == '"') {
+                field += c;
+                ++position;
+            } else {
+                inquotes = false;
+            }
+        } else if (c == '"') {
+            inquotes = true;
+            isquoted = true;
+        } else if (c == ',') {
+            fields->push_back(isquoted ? field : trim(field));
+            quoted->push_back(isquoted);
+            field.clear();
+            isquoted = false;
+        } else if (c != '\r') {
+            field += c;
+        }
+    }
+
+    fields->push_back(isquoted ? field : trim(field));
+    quoted->push_back(isquoted);
+
+    return position < mSize ? position + 1 : position;
+}
+
+void TableFile::readCsv()
+{
+    std::vector < bool > quoted;
+    std::size_t position = readCsvLine(0, &mColumns, &quoted);
+
+    if (mSize == 0 or (mColumns.size() == 1 and mColumns[0].empty())) {
+        throw utils::ArgError(
+            fmt(_("TableFile: `%1%' has no column")) % mFilename);
+    }
+
+    /*
+     * Only the beginning of the rows is stored, the empty lines are
+     * skipped.
+     */
+    while (position < mSize) {
+        const char *end = static_cast < const char* >(
+            std::memchr(mData + position, '\n', mSize - position));
+        std::size_t next = end ? (end - mData) + 1 : mSize;
+        std::size_t last = end ? (end - mData) : mSize;
+
+        if (last > position and mData[last - 1] == '\r') {
+            --last;
+        }
+
+        if (last > position) {
+            mOffsets.push_back(position);
+        }
+
+        position = next;
+    }
+
+    if (mOffsets.size() > std::numeric_limits < uint32_t >::max()) {
+        throw utils::ArgError(
+            fmt(_("TableFile: too many rows in `%1%'")) % mFilename);
+    }
+
+    mRows = static_cast < uint32_t >(mOffsets.size());
+}
+
+value::Set * TableFile::row(uint32_t row) const
+{
+    if (row >= mRows) {
+        throw utils::ArgError(
+            fmt(_("TableFile: the row %1% is out of `%2%' (%3% rows)"))
+            % row % mFilename % mRows);
+    }
+
+    std::auto_ptr < value::Set > result(value::Set::create());
+
+    if (mBinary) {
+        const char *data = mData + mValues +
+            static_cast < std::size_t >(row) * mColumns.size() *
+            sizeof(double);
+
+        for (std::size_t i = 0; i < mColumns.size(); ++i) {
+            double real;
+
+            std::memcpy(&real, data + i * sizeof(double), sizeof(double));
+            result->add(value::Double::create(real));
+        }
+    } else {
+        std::vector < std::string > fields;
+        std::vector < bool > quoted;
+
+        readCsvLine(mOffsets[row], &fields, &quoted);
+
+        if (fields.size() != mColumns.size()) {
+            throw utils::ArgError(
+                fmt(_("TableFile: the row %1% of `%2%' has %3% values,"
+                      " %4% expected")) % row % mFilename % fields.size()
+                % mColumns.size());
+        }
+
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            result->add(toValue(fields[i], quoted[i]));
+        }
+    }
+
+    return result.release();
+}
+
+void TableFile::write(const std::string& filename,
+                      const std::vector < std::string >& columns,
+                      const std::vector < double >& values)
+{
+    if (columns.empty() or values.size() % columns.size() or
+        values.size() / columns.size() >
+        std::numeric_limits < uint32_t >::max()) {
+        throw utils::ArgError(
+            fmt(_("TableFile: %1% values can not fill the rows of %2%"
+                  " columns")) % values.size() % columns.size());
+    }
+
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    uint32_t header[2];
+
+    header[0] = static_cast < uint32_t >(columns.size());
+    header[1] = static_cast < uint32_t >(values.size() / columns.size());
+
+    file.write(binaryMagic, sizeof(binaryMagic));
+    file.write(reinterpret_cast < const char* >(header), sizeof(header));
+
+    for (std::vector < std::string >::const_iterator it = columns.begin();
+         it != columns.end(); ++it) {
+        uint32_t size = static_cast < uint32_t >(it->size());
+
+        file.write(reinterpret_cast < const char* >(&size), sizeof(size));
+        file.write(it->data(), it->size());
+    }
+
+    if (not values.empty()) {
+        file.write(reinterpret_cast < const char* >(&values[0]),
+                   values.size() * sizeof(double));
+    }
+
+    if (not file) {
+        throw utils::ArgError(
+            fmt(_("TableFile: cannot write `%1%'")) % filename);
+    }
+}
+
+}} // namespace vle manager
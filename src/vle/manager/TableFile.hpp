@@ -0,0 +1,136 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_TABLEFILE_HPP
+#define VLE_MANAGER_TABLEFILE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/value/Set.hpp>
+#include <string>
+#include <vector>
+
+namespace vle { namespace manager {
+
+/**
+ * @c manager::TableFile reads the rows of a large table of values from
+ * a file, one row at a time, without loading the table: the file is
+ * mapped into memory and shared by the threads (and, by the system, by
+ * the processes which read the same file). It is used by the @e table
+ * design of @c manager::Design.
+ *
+ * Two formats are accepted:
+ * - CSV: the first line gives the names of the columns, the next
+ *   lines the rows. The values are separated by commas and can be
+ *   quoted. A value is a @c value::Integer, a @c value::Double or,
+ *   otherwise or if it is quoted, a @c value::String. The offsets of
+ *   the rows are computed when the file is opened.
+ * - binary: the header "VLETABLE", the number of columns and the
+ *   number of rows (two uint32_t), the names of the columns (a
+ *   uint32_t size and the characters) and the reals of the rows
+ *   (doubles, row by row). The values are @c value::Double. Use @c
+ *   TableFile::write to build a binary table.
+ */
+class VLE_API TableFile
+{
+public:
+    /**
+     * Open a table. The format is detected from the beginning of the
+     * file.
+     *
+     * @param filename The name of the file.
+     *
+     * @throw utils::ArgError if the file cannot be read or if its
+     * format is not valid.
+     */
+    TableFile(const std::string& filename);
+
+    ~TableFile();
+
+    /**
+     * Build the values of a row.
+     *
+     * @param row The row in [0, rows()[.
+     *
+     * @return A new @c value::Set with a value by column.
+     * @throw utils::ArgError if the row does not exist or does not
+     * have a value by column.
+     */
+    value::Set * row(uint32_t row) const;
+
+    /**
+     * Write a binary table.
+     *
+     * @param filename The name of the file.
+     * @param columns The names of the columns.
+     * @param values The values of the rows, row by row.
+     *
+     * @throw utils::ArgError if the file cannot be written or if the
+     * number of values is not a multiple of the number of columns.
+     */
+    static void write(const std::string& filename,
+                      const std::vector < std::string >& columns,
+                      const std::vector < double >& values);
+
+    uint32_t rows() const
+    { return mRows; }
+
+    const std::vector < std::string >& columns() const
+    { return mColumns; }
+
+    bool isBinary() const
+    { return mBinary; }
+
+private:
+    TableFile(const TableFile& other);
+    TableFile& operator=(const TableFile& other);
+
+    void map(const std::string& filename);
+    void unmap();
+    void readBinary();
+    void readCsv();
+    std::size_t readCsvLine(std::size_t position,
+                            std::vector < std::string > *fields,
+                            std::vector < bool > *quoted) const;
+
+    const char                 *mData;
+    std::size_t                 mSize;
+    std::string                 mBuffer; /**< The content of the file
+                                          * where it cannot be mapped. */
+    std::string                 mFilename;
+    std::vector < std::string > mColumns;
+    std::vector < std::size_t > mOffsets; /**< The beginning of the CSV
+                                           * rows. */
+    std::size_t                 mValues; /**< The beginning of the
+                                          * binary rows. */
+    uint32_t                    mRows;
+    bool                        mBinary;
+};
+
+}} // namespace vle manager
+
+#endif
@@ -79,6 +79,17 @@ struct Error
     std::string message;
 };
 
+/**
+ * Defines the error codes of the simulations.
+ *
+ */
+enum ErrorCodes {
+    ERROR_FAILURE = -1, /**< The simulation failed. */
+    ERROR_BUDGET  = -2  /**< The simulation is interrupted by its
+                         * budget, the results are partial (see
+                         * manager::Budget). */
+};
+
 /**
  * Defines the type of log
  *
@@ -97,9 +108,22 @@ enum LogOptions {
  */
 enum SimulationOptions {
     SIMULATION_NONE          = 0, /**< Default option. */
-    SIMULATION_SPAWN_PROCESS = 1 << 0, /**< Launch the simulation in a
-                                        * subprocess.  */
-    SIMULATION_NO_RETURN     = 1 << 1 /**< The simulation result are empty. */
+    SIMULATION_SPAWN_PROCESS = 1 << 0, /**< Launch the simulations of
+                                        * the manager::Manager in
+                                        * worker processes. */
+    SIMULATION_NO_RETURN     = 1 << 1, /**< The simulation result are empty. */
+    SIMULATION_PIN_THREADS   = 1 << 2, /**< Pin the threads of the
+                                        * manager::Manager to the
+                                        * processors. */
+    SIMULATION_REDUCE        = 1 << 3, /**< Fold the results of the
+                                        * manager::Manager into
+                                        * statistics (see
+                                        * manager::Reduction). */
+    SIMULATION_REUSE_MODELS  = 1 << 4  /**< Reset the models of the
+                                        * manager::Manager between
+                                        * the combinations instead of
+                                        * rebuilding them (see
+                                        * manager::Simulation::setReuse). */
 };
 
 inline LogOptions operator|(LogOptions lhs, LogOptions rhs)
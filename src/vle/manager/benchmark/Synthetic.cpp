@@ -0,0 +1,120 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/utils/Rand.hpp>
+
+namespace vle { namespace benchmark {
+
+/**
+ * @c Synthetic is an atomic model with a tunable cost to benchmark the
+ * @c manager::Manager. Each internal transition (one by unit of time)
+ * runs @c cost iterations of a floating point loop. Its conditions are:
+ * - @c cost: a @c value::Double, the iterations of a transition (0 by
+ *   default).
+ * - @c cv: a @c value::Double, the coefficient of variation of the cost
+ *   between the combinations: the cost is multiplied by a log-normal
+ *   factor of mean 1 and standard deviation @c cv drawn from @c index
+ *   (0 by default).
+ * - @c index: a @c value::Integer, the combination.
+ * - @c reset: a @c value::Boolean, false to rebuild the model for each
+ *   simulation instead of resetting it (true by default).
+ */
+class Synthetic : public devs::Dynamics
+{
+public:
+    Synthetic(const devs::DynamicsInit& init,
+              const devs::InitEventList& events)
+        : devs::Dynamics(init, events), mIterations(0), mState(0.0),
+        mReset(true)
+    {
+        assign(events);
+    }
+
+    virtual ~Synthetic()
+    {
+    }
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    {
+        mState = 0.0;
+
+        return 1.0;
+    }
+
+    virtual devs::Time timeAdvance() const
+    {
+        return 1.0;
+    }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    {
+        for (uint64_t i = 0; i < mIterations; ++i) {
+            mState = mState * 0.999999 + 1e-6 * static_cast < double >(i);
+        }
+    }
+
+    virtual value::Value * observation(
+        const devs::ObservationEvent& /* event */) const
+    {
+        return value::Double::create(mState);
+    }
+
+    virtual bool reset(const devs::InitEventList& events)
+    {
+        assign(events);
+
+        return mReset;
+    }
+
+private:
+    void assign(const devs::InitEventList& events)
+    {
+        double cost = events.exist("cost") ? events.getDouble("cost") : 0.0;
+        double cv = events.exist("cv") ? events.getDouble("cv") : 0.0;
+
+        if (cv > 0.0) {
+            utils::Rand rand(events.exist("index") ?
+                             events.getInt("index") + 1 : 1);
+
+            cost *= rand.logNormal(1.0, cv);
+        }
+
+        mIterations = cost > 0.0 ? static_cast < uint64_t >(cost) : 0;
+        mReset = not events.exist("reset") or events.getBoolean("reset");
+    }
+
+    uint64_t mIterations;
+    double   mState;
+    bool     mReset;
+};
+
+}} // namespace vle benchmark
+
+DECLARE_DYNAMICS(vle::benchmark::Synthetic)
@@ -0,0 +1,337 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Manager.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/vle.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <cstdlib>
+
+/*
+ * The manager benchmark measures the throughput of the manager::Manager
+ * (combinations per second), the overhead of a combination (copy of the
+ * conditions, construction or reset of the models, scheduling) and the
+ * parallel efficiency of the threads and of the worker processes with
+ * the synthetic dynamics of Synthetic.cpp. The results are written as
+ * tab separated values to be tracked from one version to another.
+ */
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+namespace pt = boost::posix_time;
+
+using namespace vle;
+
+/*
+ * The synthetic dynamics are installed into the package
+ * `vle.benchmark' of a temporary VLE_HOME.
+ */
+static const char *package = "vle.benchmark";
+static const char *library = "synthetic";
+
+struct Options
+{
+    uint32_t    threads;
+    uint32_t    combinations;
+    uint32_t    models;
+    uint32_t    repeat;
+    double      duration;
+    double      cost;
+    double      cv;
+    bool        spawn;
+    std::string module;
+};
+
+/*
+ * Build the experimental frame: a coupled model of synthetic models and
+ * a combination by value of the port `index'.
+ */
+static vpz::Vpz * makeExperiment(const Options& opt, double cost, bool reset)
+{
+    vpz::Vpz *vpz = new vpz::Vpz();
+    vpz::Project& project(vpz->project());
+    vpz::Experiment& experiment(project.experiment());
+
+    experiment.setName("benchmark");
+    experiment.setDuration(opt.duration);
+
+    vpz::Dynamic dynamic("synthetic");
+    dynamic.setPackage(package);
+    dynamic.setLibrary(library);
+    project.dynamics().add(dynamic);
+
+    vpz::Condition condition("synthetic");
+    condition.addValueToPort("cost", value::Double::create(cost));
+    condition.addValueToPort("cv", value::Double::create(opt.cv));
+    condition.addValueToPort("reset", value::Boolean::create(reset));
+
+    for (uint32_t i = 0; i < opt.combinations; ++i) {
+        condition.addValueToPort("index", value::Integer::create(i));
+    }
+
+    experiment.conditions().add(condition);
+
+    vpz::CoupledModel *top = new vpz::CoupledModel("top", 0);
+
+    for (uint32_t i = 0; i < opt.models; ++i) {
+        vpz::AtomicModel *atom = top->addAtomicModel(
+            "m" + boost::lexical_cast < std::string >(i));
+
+        atom->setDynamics("synthetic");
+        atom->addCondition("synthetic");
+    }
+
+    project.model().setModel(top);
+
+    return vpz;
+}
+
+/*
+ * Run the experimental frame and return the best wall-clock time of the
+ * repetitions in seconds.
+ */
+static double measure(const Options&               opt,
+                      manager::SimulationOptions   options,
+                      uint32_t                     threads,
+                      double                       cost,
+                      bool                         reset,
+                      utils::ModuleManager&        modules)
+{
+    double best = std::numeric_limits < double >::infinity();
+
+    if (reset) {
+        options |= manager::SIMULATION_REUSE_MODELS;
+    }
+
+    for (uint32_t i = 0; i < opt.repeat; ++i) {
+        manager::Manager man(manager::LOG_NONE,
+                             options | manager::SIMULATION_NO_RETURN, 0);
+        manager::Error error;
+        pt::ptime start(pt::microsec_clock::universal_time());
+
+        delete man.run(makeExperiment(opt, cost, reset), modules, threads,
+                       0, 1, &error);
+
+        pt::time_duration elapsed(pt::microsec_clock::universal_time() -
+                                  start);
+
+        if (error.code) {
+            throw utils::InternalError(error.message);
+        }
+
+        best = std::min(best, elapsed.total_microseconds() * 1e-6);
+    }
+
+    return best;
+}
+
+static void report(const std::string& mode, uint32_t threads,
+                   uint32_t combinations, double seconds, double reference)
+{
+    double speedup = seconds > 0.0 ? reference / seconds : 0.0;
+
+    std::cout << mode << '\t' << threads << '\t' << combinations << '\t'
+              << std::fixed << std::setprecision(6) << seconds << '\t'
+              << std::setprecision(2) << combinations / seconds << '\t'
+              << std::setprecision(4) << 1000.0 * seconds / combinations
+              << '\t' << std::setprecision(3) << speedup << '\t'
+              << speedup / threads << std::endl;
+}
+
+static int benchmark(const Options& opt)
+{
+    utils::ModuleManager modules;
+    std::vector < uint32_t > threads;
+
+    for (uint32_t i = 1; i < opt.threads; i *= 2) {
+        threads.push_back(i);
+    }
+    threads.push_back(opt.threads);
+
+    std::cout << "# combinations " << opt.combinations << ", models "
+              << opt.models << ", duration " << opt.duration << ", cost "
+              << opt.cost << ", cv " << opt.cv << ", best of "
+              << opt.repeat << "\n"
+              << "mode\tthreads\tcombinations\tseconds\tper_second"
+              << "\tms_per_run\tspeedup\tefficiency" << std::endl;
+
+    /*
+     * The overhead of a combination without cost, when the models are
+     * reset and when they are rebuilt for each simulation.
+     */
+    double overhead = measure(opt, manager::SIMULATION_NONE, 1, 0.0, true,
+                              modules);
+    report("overhead", 1, opt.combinations, overhead, overhead);
+
+    double rebuild = measure(opt, manager::SIMULATION_NONE, 1, 0.0, false,
+                             modules);
+    report("overhead-rebuild", 1, opt.combinations, rebuild, rebuild);
+
+    /*
+     * The parallel efficiency of the threads is relative to the mono
+     * mode, the one of the worker processes to one worker.
+     */
+    double mono = measure(opt, manager::SIMULATION_NONE, 1, opt.cost, true,
+                          modules);
+    report("mono", 1, opt.combinations, mono, mono);
+
+    for (std::vector < uint32_t >::const_iterator it = threads.begin();
+         it != threads.end(); ++it) {
+        if (*it > 1) {
+            report("thread", *it, opt.combinations,
+                   measure(opt, manager::SIMULATION_NONE, *it, opt.cost,
+                           true, modules), mono);
+        }
+    }
+
+    if (opt.spawn) {
+        double reference = 0.0;
+
+        for (std::vector < uint32_t >::const_iterator it = threads.begin();
+             it != threads.end(); ++it) {
+            double seconds = measure(opt, manager::SIMULATION_SPAWN_PROCESS,
+                                     *it, opt.cost, true, modules);
+
+            if (it == threads.begin()) {
+                reference = seconds;
+            }
+
+            report("spawn", *it, opt.combinations, seconds, reference);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Install the synthetic dynamics into the package of the temporary
+ * VLE_HOME.
+ */
+static void install(const std::string& module)
+{
+    utils::Package pkg(package);
+    fs::path plugins(pkg.getPluginSimulatorDir(utils::PKG_BINARY));
+
+    fs::create_directories(plugins);
+
+#ifdef BOOST_WINDOWS
+    fs::copy_file(module, plugins / (std::string("lib") + library + ".dll"));
+#else
+    fs::copy_file(module, plugins / (std::string("lib") + library + ".so"));
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    Options opt;
+    po::options_description desc("Options");
+    po::variables_map vm;
+
+    desc.add_options()
+        ("help,h", "Produce help message")
+        ("threads,o", po::value < uint32_t >(&opt.threads)->default_value(
+            std::max(boost::thread::hardware_concurrency(), 1u)),
+         "Largest number of threads or worker processes")
+        ("combinations,c", po::value < uint32_t >(
+            &opt.combinations)->default_value(200),
+         "Number of combinations")
+        ("models,n", po::value < uint32_t >(&opt.models)->default_value(10),
+         "Number of atomic models")
+        ("duration,d", po::value < double >(&opt.duration)->default_value(
+            100.0), "Duration of the simulations (transitions by model)")
+        ("cost", po::value < double >(&opt.cost)->default_value(1000.0),
+         "Iterations of a transition")
+        ("cv", po::value < double >(&opt.cv)->default_value(0.5),
+         "Coefficient of variation of the cost between the combinations")
+        ("repeat,r", po::value < uint32_t >(&opt.repeat)->default_value(3),
+         "Repetitions of a measure, the best time is kept")
+        ("spawn", "Measure the worker processes (needs an installed vle)")
+        ("module", po::value < std::string >(&opt.module)->default_value(
+            VLE_BENCHMARK_MODULE), "The synthetic dynamics module");
+
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n" << desc << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (opt.threads == 0 or opt.combinations == 0 or opt.repeat == 0) {
+        std::cerr << "threads, combinations and repeat must be positive\n";
+        return EXIT_FAILURE;
+    }
+
+    opt.spawn = vm.count("spawn");
+
+    fs::path home(fs::temp_directory_path() /
+                  fs::unique_path("vle-benchmark-%%%%-%%%%-%%%%"));
+    fs::create_directories(home);
+
+#ifdef _WIN32
+    ::_putenv(("VLE_HOME=" + home.string()).c_str());
+#else
+    ::setenv("VLE_HOME", home.string().c_str(), 1);
+#endif
+
+    int result = EXIT_FAILURE;
+
+    try {
+        vle::Init app;
+
+        install(opt.module);
+        result = benchmark(opt);
+    } catch (const std::exception& e) {
+        std::cerr << "benchmark error: " << e.what() << std::endl;
+    }
+
+    boost::system::error_code ec;
+    fs::remove_all(home, ec);
+
+    return result;
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Map.hpp>
+
+namespace vle { namespace manager { namespace test {
+
+/**
+ * @c Counter is the atomic model of the simulations of the tests of the
+ * manager. Each unit of time, the counter adds its step and, if random is
+ * true, a number of [0, 1) drawn from its random stream. Its conditions
+ * are:
+ * - @c step: a @c value::Double, the step (1 by default).
+ * - @c random: a @c value::Boolean, true to add the random numbers (false
+ *   by default).
+ * - @c limit: a @c value::Double, the simulation ends when the counter
+ *   reaches the limit (no limit by default).
+ * - @c reset: a @c value::Boolean, false to refuse the reset of the
+ *   manager (true by default).
+ *
+ * The counter supports the branching and the reset of the manager.
+ */
+class Counter : public devs::Dynamics
+{
+public:
+    Counter(const devs::DynamicsInit& init,
+            const devs::InitEventList& events)
+        : devs::Dynamics(init, events), mValue(0.0), mStep(1.0),
+        mLimit(0.0), mRandom(false)
+    {
+        assign(events);
+    }
+
+    virtual ~Counter()
+    {
+    }
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    {
+        mValue = 0.0;
+
+        return 1.0;
+    }
+
+    virtual devs::Time timeAdvance() const
+    {
+        return 1.0;
+    }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    {
+        mValue += mStep;
+
+        if (mRandom) {
+            mValue += rand().getDouble();
+        }
+    }
+
+    virtual value::Value * observation(
+        const devs::ObservationEvent& /* event */) const
+    {
+        return value::Double::create(mValue);
+    }
+
+    virtual bool branch(const devs::Time& /* time */,
+                        const devs::InitEventList& events)
+    {
+        assign(events);
+
+        return true;
+    }
+
+    virtual bool reset(const devs::InitEventList& events)
+    {
+        if (events.exist("reset") and not events.getBoolean("reset")) {
+            return false;
+        }
+
+        assign(events);
+
+        return true;
+    }
+
+    virtual bool terminate(const devs::Time& /* time */) const
+    {
+        return mLimit > 0.0 and mValue >= mLimit;
+    }
+
+private:
+    void assign(const devs::InitEventList& events)
+    {
+        mStep = events.exist("step") ? events.getDouble("step") : 1.0;
+        mLimit = events.exist("limit") ? events.getDouble("limit") : 0.0;
+        mRandom = events.exist("random") and events.getBoolean("random");
+    }
+
+    double mValue;
+    double mStep;
+    double mLimit;
+    bool   mRandom;
+};
+
+}}} // namespace vle manager test
+
+DECLARE_DYNAMICS(vle::manager::test::Counter)
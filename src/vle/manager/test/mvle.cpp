@@ -0,0 +1,193 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE manager_mvle_test
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <cstdlib>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/manager/Journal.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/vle.hpp>
+
+namespace fs = boost::filesystem;
+
+/*
+ * The mvle program is run with three MPI nodes in a temporary VLE_HOME
+ * where the counter and the storage plug-ins of the tests of the manager
+ * are installed. The results of all the nodes are gathered by the node 0
+ * into the journal of the experimental frame.
+ */
+static std::string makeHome()
+{
+    fs::path home(fs::temp_directory_path() /
+                  fs::unique_path("vle-test-%%%%-%%%%-%%%%"));
+    fs::create_directories(home);
+
+    ::setenv("VLE_HOME", home.string().c_str(), 1);
+
+    return home.string();
+}
+
+static void install()
+{
+    vle::utils::Package pkg("vle.test");
+    fs::path simulator(pkg.getPluginSimulatorDir(vle::utils::PKG_BINARY));
+    fs::path output(pkg.getPluginOutputDir(vle::utils::PKG_BINARY));
+
+    fs::create_directories(simulator);
+    fs::create_directories(output);
+    fs::copy_file(VLE_TEST_COUNTER, simulator / "libcounter.so");
+    fs::copy_file(VLE_TEST_STORAGE, output / "libstorage.so");
+}
+
+struct F
+{
+    std::string home;
+    vle::Init a;
+
+    F() : home(makeHome()), a() { install(); }
+    ~F()
+    {
+        boost::system::error_code ec;
+        fs::remove_all(home, ec);
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(F)
+
+using namespace vle;
+
+/*
+ * Write an experimental frame of counters: one combination per step,
+ * the last observation of a combination is 5 times its step.
+ */
+static std::string writeCounter(const std::string& name, uint32_t size)
+{
+    vpz::Vpz vpz;
+    vpz::Project& project(vpz.project());
+    vpz::Experiment& experiment(project.experiment());
+
+    experiment.setName(name);
+    experiment.setDuration(5.0);
+
+    vpz::Dynamic dynamic("counter");
+    dynamic.setPackage("vle.test");
+    dynamic.setLibrary("counter");
+    project.dynamics().add(dynamic);
+
+    vpz::Condition condition("counter");
+    for (uint32_t i = 0; i < size; ++i) {
+        condition.addValueToPort("step", value::Double(i + 1.0));
+    }
+    experiment.conditions().add(condition);
+
+    vpz::Views& views(experiment.views());
+    views.addLocalStreamOutput("storage", "", "storage", "vle.test");
+    views.addTimedView("view", 1.0, "storage");
+
+    vpz::Observable observable("counter");
+    observable.add("value").add("view");
+    views.observables().add(observable);
+
+    vpz::CoupledModel *top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel *atom = top->addAtomicModel("counter");
+    atom->setDynamics("counter");
+    atom->addCondition("counter");
+    atom->setObservables("counter");
+    project.model().setModel(top);
+
+    fs::path filename(fs::path(std::getenv("VLE_HOME")) / (name + ".vpz"));
+    {
+        std::ofstream file(filename.string().c_str());
+        vpz.write(file);
+    }
+
+    delete top;
+
+    return filename.string();
+}
+
+/*
+ * Run mvle with three nodes of four threads and check the results of
+ * all the combinations gathered by the node 0.
+ */
+static void checkMvle(const std::string& name, uint32_t size, uint32_t chunk)
+{
+    std::string filename(writeCounter(name, size));
+    std::string result(std::getenv("VLE_HOME"));
+    std::string command(
+        std::string(VLE_TEST_MPIEXEC) + " " + VLE_TEST_MPIEXEC_NUMPROC_FLAG +
+        " 3 " + VLE_TEST_MVLE + " -o 4 -c " +
+        boost::lexical_cast < std::string >(chunk) + " -r " + result + " " +
+        filename);
+
+    BOOST_REQUIRE_EQUAL(std::system(command.c_str()), 0);
+
+    manager::Journal journal((fs::path(result) / (name + ".journal")).string(),
+                             true, false);
+    BOOST_REQUIRE_EQUAL(journal.completed(), size);
+
+    for (uint32_t i = 0; i < size; ++i) {
+        value::Value *simresult;
+
+        BOOST_REQUIRE(journal.find(i, &simresult));
+        BOOST_REQUIRE(simresult);
+
+        const value::Matrix& view(simresult->toMap().getMatrix("view"));
+        BOOST_REQUIRE(view.rows() > 0);
+        BOOST_CHECK_EQUAL(value::toDouble(view.get(1, view.rows() - 1)),
+                          5.0 * (i + 1));
+        delete simresult;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mvle_combined)
+{
+    checkMvle("combined", 9, 2);
+}
+
+BOOST_AUTO_TEST_CASE(mvle_more_workers)
+{
+    /*
+     * The node 0 has more simulation threads than combinations, the others
+     * nodes receive an empty chunk at once.
+     */
+    checkMvle("workers", 2, 1);
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/oov/RowPlugin.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Matrix.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace vle { namespace manager { namespace test {
+
+/**
+ * @c Storage is the output plug-in of the simulations of the tests of
+ * the manager. It keeps the observations of its view in memory: a row by
+ * observation, the time in the first column and the real values of the
+ * observables in the next columns (0 if the value is not a real).
+ */
+class Storage : public oov::RowPlugin
+{
+public:
+    Storage(const std::string& location)
+        : oov::RowPlugin(location)
+    {
+    }
+
+    virtual ~Storage()
+    {
+    }
+
+    virtual std::string name() const
+    {
+        return "storage";
+    }
+
+    virtual void onParameter(const std::string& /* plugin */,
+                             const std::string& /* location */,
+                             const std::string& /* file */,
+                             value::Value* parameters,
+                             const double& /* time */)
+    {
+        delete parameters;
+    }
+
+    virtual void onAddObservable(oov::ObservableId /* id */,
+                                 const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* port */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {
+    }
+
+    virtual void onRemoveObservable(oov::ObservableId /* id */,
+                                    const double& /* time */)
+    {
+    }
+
+    virtual void onRow(const std::string& /* view */,
+                       const double& time,
+                       const oov::ObservationRow& row)
+    {
+        std::vector < double > line(1, time);
+
+        for (oov::ObservationRow::const_iterator it = row.begin();
+             it != row.end(); ++it) {
+            line.push_back(*it and (*it)->isDouble() ?
+                           (*it)->toDouble().value() : 0.0);
+            delete *it;
+        }
+
+        mRows.push_back(line);
+    }
+
+    virtual value::Matrix * matrix() const
+    {
+        std::vector < double >::size_type columns = 1;
+
+        for (std::vector < std::vector < double > >::const_iterator it =
+                 mRows.begin(); it != mRows.end(); ++it) {
+            columns = std::max(columns, it->size());
+        }
+
+        value::Matrix *result = new value::Matrix(columns, mRows.size(),
+                                                  1, 1);
+
+        for (std::vector < double >::size_type i = 0; i < mRows.size();
+             ++i) {
+            for (std::vector < double >::size_type j = 0;
+                 j < mRows[i].size(); ++j) {
+                result->add(j, i, value::Double::create(mRows[i][j]));
+            }
+        }
+
+        return result;
+    }
+
+    virtual void close(const double& /* time */)
+    {
+    }
+
+private:
+    std::vector < std::vector < double > > mRows;
+};
+
+}}} // namespace vle manager test
+
+DECLARE_OOV_PLUGIN(vle::manager::test::Storage)
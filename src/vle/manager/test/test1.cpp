@@ -34,19 +34,106 @@
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 #include <stdexcept>
 #include <iostream>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/manager/Manager.hpp>
+#include <vle/manager/Admission.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/Cache.hpp>
+#include <vle/manager/Design.hpp>
+#include <vle/manager/Journal.hpp>
+#include <vle/manager/Replication.hpp>
+#include <vle/manager/Budget.hpp>
+#include <vle/manager/ResultStore.hpp>
+#include <vle/manager/Scheduler.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/manager/Statistics.hpp>
+#include <vle/manager/Streams.hpp>
+#include <vle/manager/TableFile.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/devs/RootCoordinator.hpp>
+#include <vle/devs/Termination.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/utils/Path.hpp>
 #include <vle/vle.hpp>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <clocale>
+#include <cmath>
+
+namespace fs = boost::filesystem;
+
+/*
+ * The counter model and the storage plug-in of the simulations are
+ * installed into the package `vle.test' of a temporary VLE_HOME.
+ */
+static std::string makeHome()
+{
+    fs::path home(fs::temp_directory_path() /
+                  fs::unique_path("vle-test-%%%%-%%%%-%%%%"));
+    fs::create_directories(home);
+
+#ifdef _WIN32
+    ::_putenv(("VLE_HOME=" + home.string()).c_str());
+#else
+    ::setenv("VLE_HOME", home.string().c_str(), 1);
+
+    /*
+     * The worker processes of the manager are the vle program of the
+     * build tree.
+     */
+    const char *path = ::getenv("PATH");
+    ::setenv("PATH", (std::string(VLE_TEST_PROGRAM) + ":" +
+                      (path ? path : "")).c_str(), 1);
+#endif
+
+    return home.string();
+}
+
+static void install()
+{
+    vle::utils::Package pkg("vle.test");
+    fs::path simulator(pkg.getPluginSimulatorDir(vle::utils::PKG_BINARY));
+    fs::path output(pkg.getPluginOutputDir(vle::utils::PKG_BINARY));
+
+    fs::create_directories(simulator);
+    fs::create_directories(output);
+
+#ifdef BOOST_WINDOWS
+    fs::copy_file(VLE_TEST_COUNTER, simulator / "libcounter.dll");
+    fs::copy_file(VLE_TEST_STORAGE, output / "libstorage.dll");
+#else
+    fs::copy_file(VLE_TEST_COUNTER, simulator / "libcounter.so");
+    fs::copy_file(VLE_TEST_STORAGE, output / "libstorage.so");
+#endif
+}
 
 struct F
 {
+    std::string home;
     vle::Init a;
 
-    F() : a() { }
-    ~F() { }
+    F() : home(makeHome()), a() { install(); }
+    ~F()
+    {
+        boost::system::error_code ec;
+        fs::remove_all(home, ec);
+    }
 };
 
 
@@ -224,3 +311,1559 @@ BOOST_AUTO_TEST_CASE(experimentgenerator_max_1_max_1)
     BOOST_CHECK_EQUAL(expgen1.max(), 7);
     BOOST_CHECK_EQUAL(expgen1.size(), 7);
 }
+
+static void prepareDesign(vpz::Vpz& vpz, const std::string& type,
+                          int size)
+{
+    vpz.parseMemory(xml);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    cnds.get("cond1").setValueToPort("init2", value::Double(0.0));
+    cnds.get("cond2").setValueToPort("init4", value::Double(0.0));
+
+    vpz::Condition design(manager::Design::name());
+    design.addValueToPort("type", value::String(type));
+    design.addValueToPort("size", value::Integer(size));
+    design.addValueToPort("seed", value::Integer(42));
+    cnds.add(design);
+}
+
+/*
+ * Build an experimental frame of a counter observed each unit of time by
+ * the storage plug-in, with a combination by step of the counter.
+ */
+static vpz::Vpz * makeCounter(double duration,
+                              const std::vector < double >& steps)
+{
+    vpz::Vpz *vpz = new vpz::Vpz();
+    vpz::Project& project(vpz->project());
+    vpz::Experiment& experiment(project.experiment());
+
+    experiment.setName("counter");
+    experiment.setDuration(duration);
+
+    vpz::Dynamic dynamic("counter");
+    dynamic.setPackage("vle.test");
+    dynamic.setLibrary("counter");
+    project.dynamics().add(dynamic);
+
+    vpz::Condition condition("counter");
+    for (std::vector < double >::const_iterator it = steps.begin();
+         it != steps.end(); ++it) {
+        condition.addValueToPort("step", value::Double(*it));
+    }
+    experiment.conditions().add(condition);
+
+    vpz::Views& views(experiment.views());
+    views.addLocalStreamOutput("storage", "", "storage", "vle.test");
+    views.addTimedView("view", 1.0, "storage");
+
+    vpz::Observable observable("counter");
+    observable.add("value").add("view");
+    views.observables().add(observable);
+
+    vpz::CoupledModel *top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel *atom = top->addAtomicModel("counter");
+    atom->setDynamics("counter");
+    atom->addCondition("counter");
+    atom->setObservables("counter");
+    project.model().setModel(top);
+
+    return vpz;
+}
+
+/*
+ * Get the observations of a combination in the result of the manager.
+ */
+static const value::Matrix& getView(const value::Matrix& result,
+                                    uint32_t index)
+{
+    BOOST_REQUIRE(result.get(index, 0));
+
+    return result.get(index, 0)->toMap().getMatrix("view");
+}
+
+/*
+ * Get the last observation of a counter.
+ */
+static double getLast(const value::Matrix& view)
+{
+    BOOST_REQUIRE(view.rows() > 0);
+
+    return value::toDouble(view.get(1, view.rows() - 1));
+}
+
+/*
+ * Check that two views have the same observations: the times and the
+ * values of all the columns.
+ */
+static void checkSameView(const value::Matrix& expected,
+                          const value::Matrix& view)
+{
+    BOOST_REQUIRE_EQUAL(view.columns(), expected.columns());
+    BOOST_REQUIRE_EQUAL(view.rows(), expected.rows());
+    for (value::Matrix::size_type j = 0; j < view.rows(); ++j) {
+        for (value::Matrix::size_type k = 0; k < view.columns(); ++k) {
+            BOOST_CHECK_EQUAL(value::toDouble(view.get(k, j)),
+                              value::toDouble(expected.get(k, j)));
+        }
+    }
+}
+
+/*
+ * Check that two results of the manager have the same observations for
+ * each combination.
+ */
+static void checkSameResults(const value::Matrix& expected,
+                             const value::Matrix& result)
+{
+    BOOST_REQUIRE_EQUAL(result.columns(), expected.columns());
+    for (uint32_t i = 0; i < result.columns(); ++i) {
+        checkSameView(getView(expected, i), getView(result, i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(design_factorial)
+{
+    vpz::Vpz vpz;
+    prepareDesign(vpz, "factorial", 0);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    vpz::Condition& design(cnds.get(manager::Design::name()));
+    for (int i = 1; i <= 3; ++i) {
+        design.addValueToPort("cond1.init1", value::Integer(i));
+    }
+    value::Tuple range;
+    range.add(0.0);
+    range.add(1.0);
+    range.add(2.0);
+    design.addValueToPort("cond2.init3", range);
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_REQUIRE_EQUAL(expgen.size(), 6u);
+
+    vpz::Conditions conditions;
+    expgen.get(0, &conditions);
+    BOOST_CHECK_EQUAL(value::toInteger(
+            conditions.get("cond1").firstValue("init1")), 1);
+    BOOST_CHECK_CLOSE(value::toDouble(
+            conditions.get("cond2").firstValue("init3")), 0.0, 1e-10);
+    BOOST_CHECK_CLOSE(value::toDouble(
+            conditions.get("cond1").firstValue("init2")), 0.0, 1e-10);
+    BOOST_CHECK(not conditions.exist(manager::Design::name()));
+
+    expgen.get(1, &conditions);
+    BOOST_CHECK_EQUAL(value::toInteger(
+            conditions.get("cond1").firstValue("init1")), 2);
+    BOOST_CHECK_CLOSE(value::toDouble(
+            conditions.get("cond2").firstValue("init3")), 0.0, 1e-10);
+
+    expgen.get(5, &conditions);
+    BOOST_CHECK_EQUAL(value::toInteger(
+            conditions.get("cond1").firstValue("init1")), 3);
+    BOOST_CHECK_CLOSE(value::toDouble(
+            conditions.get("cond2").firstValue("init3")), 1.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(design_lhs)
+{
+    vpz::Vpz vpz;
+    prepareDesign(vpz, "lhs", 100);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    cnds.get("cond1").setValueToPort("init1", value::Double(0.0));
+    value::Tuple range;
+    range.add(0.0);
+    range.add(1.0);
+    cnds.get(manager::Design::name()).addValueToPort("cond1.init1", range);
+
+    manager::ExperimentGenerator expgen1(vpz, 0, 2);
+    manager::ExperimentGenerator expgen2(vpz, 1, 2);
+    BOOST_REQUIRE_EQUAL(expgen1.size(), 200u);
+    BOOST_CHECK_EQUAL(expgen1.max(), expgen2.min());
+
+    std::vector < int > strata(100, 0);
+    for (uint32_t i = 0; i < 200; i += 2) {
+        vpz::Conditions conditions;
+        if (i < expgen1.max()) {
+            expgen1.get(i, &conditions);
+        } else {
+            expgen2.get(i, &conditions);
+        }
+
+        double x = value::toDouble(
+            conditions.get("cond1").firstValue("init1"));
+        BOOST_REQUIRE(x >= 0.0 and x < 1.0);
+        strata[static_cast < int >(x * 100)]++;
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(strata[i], 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(design_sobol)
+{
+    vpz::Vpz vpz;
+    prepareDesign(vpz, "sobol", 1000000);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    cnds.get("cond1").setValueToPort("init1", value::Double(0.0));
+    value::Tuple range;
+    range.add(0.0);
+    range.add(1.0);
+    cnds.get(manager::Design::name()).addValueToPort("cond1.init1", range);
+    cnds.get(manager::Design::name()).addValueToPort("cond2.init3", range);
+
+    manager::Design design(cnds);
+    BOOST_REQUIRE_EQUAL(design.size(), 1000000u);
+    BOOST_REQUIRE_EQUAL(design.factors(), 2u);
+    BOOST_CHECK_CLOSE(design.coordinate(0, 0), 0.5, 1e-10);
+    BOOST_CHECK_CLOSE(design.coordinate(0, 1), 0.5, 1e-10);
+    BOOST_CHECK_CLOSE(design.coordinate(1, 0), 0.75, 1e-10);
+    BOOST_CHECK_CLOSE(design.coordinate(1, 1), 0.25, 1e-10);
+    BOOST_CHECK_CLOSE(design.coordinate(2, 0), 0.25, 1e-10);
+    BOOST_CHECK_CLOSE(design.coordinate(2, 1), 0.75, 1e-10);
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_REQUIRE_EQUAL(expgen.size(), 1000000u);
+
+    vpz::Conditions conditions;
+    expgen.get(999999, &conditions);
+    double x = value::toDouble(conditions.get("cond2").firstValue("init3"));
+    BOOST_CHECK(x > 0.0 and x < 1.0);
+
+    cnds.get(manager::Design::name()).addValueToPort("unknown.port", range);
+    BOOST_CHECK_THROW(manager::Design tmp(cnds), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(design_table)
+{
+    std::string filename;
+    {
+        std::ofstream file;
+        filename = utils::Path::getTempFile("vle-table-", &file);
+        file << "cond1.init1, cond2.init3\n"
+             << "1,0.5\r\n"
+             << "\n"
+             << "2,\"a, \"\"b\"\"\"\n"
+             << "3,1e3";
+    }
+
+    vpz::Vpz vpz;
+    prepareDesign(vpz, "table", 0);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    cnds.get(manager::Design::name()).addValueToPort(
+        "file", value::String(filename));
+
+    {
+        manager::ExperimentGenerator expgen(vpz, 0, 1);
+        BOOST_REQUIRE_EQUAL(expgen.size(), 3u);
+
+        vpz::Conditions conditions;
+        expgen.get(0, &conditions);
+        BOOST_CHECK_EQUAL(value::toInteger(
+                conditions.get("cond1").firstValue("init1")), 1);
+        BOOST_CHECK_CLOSE(value::toDouble(
+                conditions.get("cond2").firstValue("init3")), 0.5, 1e-10);
+
+        expgen.get(1, &conditions);
+        BOOST_CHECK_EQUAL(value::toInteger(
+                conditions.get("cond1").firstValue("init1")), 2);
+        BOOST_CHECK_EQUAL(value::toString(
+                conditions.get("cond2").firstValue("init3")), "a, \"b\"");
+
+        expgen.get(2, &conditions);
+        BOOST_CHECK_CLOSE(value::toDouble(
+                conditions.get("cond2").firstValue("init3")), 1000.0, 1e-10);
+    }
+
+    /*
+     * The numbers are read with the classic locale, whatever the
+     * decimal separator of the locale of the program.
+     */
+    if (std::setlocale(LC_NUMERIC, "fr_FR.UTF-8") or
+        std::setlocale(LC_NUMERIC, "de_DE.UTF-8")) {
+        manager::ExperimentGenerator expgen(vpz, 0, 1);
+        vpz::Conditions conditions;
+        expgen.get(0, &conditions);
+        BOOST_CHECK_CLOSE(value::toDouble(
+                conditions.get("cond2").firstValue("init3")), 0.5, 1e-10);
+
+        std::setlocale(LC_NUMERIC, "");
+    }
+
+    /*
+     * The worker processes read a copy of the experimental frame: a
+     * relative file is made absolute before the copy.
+     */
+    {
+        vpz::Conditions copy(cnds);
+        copy.get(manager::Design::name()).setValueToPort(
+            "file", value::String("table.csv"));
+        manager::Design::absolute(copy, "/data");
+        BOOST_CHECK_EQUAL(value::toString(copy.get(
+                    manager::Design::name()).firstValue("file")),
+                          utils::Path::buildFilename("/data", "table.csv"));
+
+        manager::Design::absolute(copy, "/other");
+        BOOST_CHECK_EQUAL(value::toString(copy.get(
+                    manager::Design::name()).firstValue("file")),
+                          utils::Path::buildFilename("/data", "table.csv"));
+    }
+
+    cnds.get(manager::Design::name()).setValueToPort("size",
+                                                     value::Integer(2));
+    BOOST_CHECK_EQUAL(manager::Design(cnds).size(), 2u);
+
+    cnds.get(manager::Design::name()).addValueToPort(
+        "cond1.init2", value::Double(1.0));
+    BOOST_CHECK_THROW(manager::Design tmp(cnds), utils::ArgError);
+    cnds.get(manager::Design::name()).del("cond1.init2");
+
+    std::vector < std::string > columns;
+    columns.push_back("cond1.init1");
+    columns.push_back("cond2.init3");
+
+    std::vector < double > values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+        values.push_back(i * 0.5);
+    }
+
+    manager::TableFile::write(filename, columns, values);
+
+    {
+        manager::TableFile table(filename);
+        BOOST_CHECK(table.isBinary());
+        BOOST_REQUIRE_EQUAL(table.rows(), 1000u);
+        BOOST_REQUIRE_EQUAL(table.columns().size(), 2u);
+        BOOST_CHECK_EQUAL(table.columns()[1], "cond2.init3");
+        BOOST_CHECK_THROW(table.row(1000), utils::ArgError);
+
+        cnds.get(manager::Design::name()).setValueToPort("size",
+                                                         value::Integer(0));
+        manager::ExperimentGenerator expgen(vpz, 0, 1);
+        BOOST_REQUIRE_EQUAL(expgen.size(), 1000u);
+
+        vpz::Conditions conditions;
+        expgen.get(999, &conditions);
+        BOOST_CHECK_CLOSE(value::toDouble(
+                conditions.get("cond1").firstValue("init1")), 999.0, 1e-10);
+        BOOST_CHECK_CLOSE(value::toDouble(
+                conditions.get("cond2").firstValue("init3")), 499.5, 1e-10);
+    }
+
+    std::remove(filename.c_str());
+
+    BOOST_CHECK_THROW(manager::Design tmp(cnds), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(statistics_moments)
+{
+    std::vector < double > probabilities;
+    probabilities.push_back(0.5);
+
+    manager::Statistics stats(probabilities);
+
+    for (int i = 1; i <= 5; ++i) {
+        stats.add(i);
+    }
+
+    BOOST_CHECK_EQUAL(stats.count(), 5u);
+    BOOST_CHECK_CLOSE(stats.mean(), 3.0, 1e-10);
+    BOOST_CHECK_CLOSE(stats.variance(), 2.5, 1e-10);
+    BOOST_CHECK_CLOSE(stats.min(), 1.0, 1e-10);
+    BOOST_CHECK_CLOSE(stats.max(), 5.0, 1e-10);
+    BOOST_CHECK_CLOSE(stats.quantile(0), 3.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(statistics_quantiles)
+{
+    std::vector < double > probabilities;
+    probabilities.push_back(0.1);
+    probabilities.push_back(0.5);
+    probabilities.push_back(0.9);
+
+    manager::Statistics stats(probabilities);
+
+    for (int i = 0; i < 10000; ++i) {
+        stats.add((i * 7919) % 10000);
+    }
+
+    BOOST_CHECK_EQUAL(stats.count(), 10000u);
+    BOOST_CHECK_CLOSE(stats.mean(), 4999.5, 1e-6);
+    BOOST_CHECK_CLOSE(stats.quantile(0), 1000.0, 5.0);
+    BOOST_CHECK_CLOSE(stats.quantile(1), 5000.0, 5.0);
+    BOOST_CHECK_CLOSE(stats.quantile(2), 9000.0, 5.0);
+
+    BOOST_CHECK_THROW(manager::Quantile(1.0), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(statistics_interval)
+{
+    manager::Statistics stats;
+    stats.add(1.0);
+    BOOST_CHECK(stats.interval(0.95) > 1e300);
+
+    for (int i = 2; i <= 5; ++i) {
+        stats.add(i);
+    }
+
+    BOOST_CHECK_CLOSE(stats.interval(0.95), 2.776445 * std::sqrt(0.5), 0.1);
+    BOOST_CHECK_THROW(stats.interval(1.0), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(replication)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    uint32_t size = manager::ExperimentGenerator(vpz, 0, 1).size();
+
+    vpz::Condition replicate(manager::Replication::name());
+    replicate.addValueToPort("view", value::String("view"));
+    replicate.addValueToPort("column", value::String("x"));
+    replicate.addValueToPort("width", value::Double(0.01));
+    replicate.addValueToPort("max", value::Integer(10));
+    replicate.addValueToPort("port", value::String("cond1.init2"));
+    cnds.add(replicate);
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_CHECK_EQUAL(expgen.size(), size);
+    BOOST_REQUIRE(expgen.replication());
+
+    vpz::Conditions conditions;
+    expgen.get(0, &conditions);
+    BOOST_CHECK(not conditions.exist(manager::Replication::name()));
+
+    const manager::Replication& replication(*expgen.replication());
+    BOOST_CHECK_EQUAL(replication.seed(0, 1), replication.seed(0, 1));
+    BOOST_CHECK(replication.seed(0, 0) != replication.seed(0, 1));
+    BOOST_CHECK(replication.seed(0, 1) != replication.seed(1, 0));
+
+    replication.assign(replication.seed(2, 3), &conditions);
+    BOOST_CHECK_EQUAL(static_cast < uint32_t >(value::toInteger(
+                conditions.get("cond1").firstValue("init2"))),
+        replication.seed(2, 3));
+
+    value::Map result;
+    value::Matrix *view = new value::Matrix(2, 3, 2, 3);
+    view->add(0, 0, new value::String("time"));
+    view->add(1, 0, new value::String("x"));
+    view->add(1, 1, new value::Double(2.0));
+    view->add(1, 2, new value::Double(4.0));
+    result.add("view", view);
+    BOOST_CHECK_CLOSE(replication.observe(&result), 4.0, 1e-10);
+    BOOST_CHECK_THROW(replication.observe(0), utils::ArgError);
+
+    manager::Statistics stats;
+    stats.add(10.0);
+    stats.add(10.01);
+    BOOST_CHECK(not replication.done(stats));
+    stats.add(10.005);
+    BOOST_CHECK(replication.done(stats));
+
+    manager::Statistics wide;
+    for (int i = 0; i < 9; ++i) {
+        wide.add(i);
+        BOOST_CHECK(not replication.done(wide));
+    }
+    wide.add(0.0);
+    BOOST_CHECK(replication.done(wide));
+
+    /*
+     * Without the port max, at most 100 replicates are simulated.
+     */
+    cnds.get(manager::Replication::name()).del("max");
+    manager::Replication unbounded(cnds);
+    BOOST_CHECK_EQUAL(unbounded.minimum(), 3u);
+    BOOST_CHECK_EQUAL(unbounded.maximum(), 100u);
+
+    cnds.get(manager::Replication::name()).addValueToPort(
+        "min", value::Integer(200));
+    BOOST_CHECK_THROW(manager::Replication invalid(cnds), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(budget)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    uint32_t size = manager::ExperimentGenerator(vpz, 0, 1).size();
+    BOOST_CHECK(not manager::ExperimentGenerator(vpz, 0, 1).budget());
+
+    vpz::Condition limits(manager::Budget::name());
+    limits.addValueToPort("walltime", value::Integer(60));
+    limits.addValueToPort("stall", value::Integer(1000));
+    limits.addValueToPort("requeue", value::Boolean(true));
+    cnds.add(limits);
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_CHECK_EQUAL(expgen.size(), size);
+    BOOST_REQUIRE(expgen.budget());
+    BOOST_CHECK_CLOSE(expgen.budget()->walltime(), 60.0, 1e-10);
+    BOOST_CHECK_EQUAL(expgen.budget()->bags(), 0u);
+    BOOST_CHECK_EQUAL(expgen.budget()->stall(), 1000u);
+    BOOST_CHECK(expgen.budget()->requeue());
+
+    vpz::Conditions conditions;
+    expgen.get(0, &conditions);
+    BOOST_CHECK(not conditions.exist(manager::Budget::name()));
+
+    cnds.get(manager::Budget::name()).addValueToPort(
+        "bags", value::Integer(-1));
+    BOOST_CHECK_THROW(manager::Budget invalid(cnds), utils::ArgError);
+
+    cnds.del(manager::Budget::name());
+    vpz::Condition unknown(manager::Budget::name());
+    unknown.addValueToPort("events", value::Integer(10));
+    cnds.add(unknown);
+    BOOST_CHECK_THROW(manager::Budget invalid(cnds), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(streams)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    BOOST_CHECK(not manager::ExperimentGenerator(vpz, 0, 1).streams());
+
+    vpz::Condition random(manager::Streams::name());
+    random.addValueToPort("seed", value::Integer(123));
+    random.addValueToPort("antithetic", value::Boolean(true));
+    cnds.add(random);
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_REQUIRE(expgen.streams());
+
+    const manager::Streams& streams(*expgen.streams());
+    BOOST_CHECK(streams.common());
+    BOOST_CHECK_EQUAL(streams.group(), 2u);
+    BOOST_CHECK_EQUAL(streams.seed(0, 0), streams.seed(7, 0));
+    BOOST_CHECK_EQUAL(streams.seed(0, 0), streams.seed(0, 1));
+    BOOST_CHECK(streams.seed(0, 1) != streams.seed(0, 2));
+    BOOST_CHECK(not streams.antithetic(0));
+    BOOST_CHECK(streams.antithetic(1));
+
+    vpz::Conditions conditions;
+    expgen.get(0, &conditions);
+    BOOST_CHECK(not conditions.exist(manager::Streams::name()));
+
+    cnds.get(manager::Streams::name()).addValueToPort(
+        "common", value::Boolean(false));
+    manager::Streams independent(cnds);
+    BOOST_CHECK(not independent.common());
+    BOOST_CHECK(independent.seed(0, 0) != independent.seed(7, 0));
+
+    cnds.del(manager::Streams::name());
+    vpz::Condition unknown(manager::Streams::name());
+    unknown.addValueToPort("seeds", value::Integer(10));
+    cnds.add(unknown);
+    BOOST_CHECK_THROW(manager::Streams invalid(cnds), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(manager_frames)
+{
+    utils::ModuleManager modules;
+    std::vector < vpz::Vpz* > exps;
+    std::vector < value::Matrix* > results;
+    std::vector < manager::Error > errors;
+
+    for (int i = 0; i < 2; ++i) {
+        exps.push_back(new vpz::Vpz());
+        prepareDesign(*exps.back(), "table", 0);
+        exps.back()->project().experiment().conditions().get(
+            manager::Design::name()).addValueToPort(
+                "file", value::String("/nonexistent/vle-table.csv"));
+    }
+
+    manager::Manager spawn(manager::LOG_NONE,
+                           manager::SIMULATION_SPAWN_PROCESS, 0);
+    BOOST_CHECK_THROW(spawn.run(exps, modules, 2, &results, &errors),
+                      utils::ArgError);
+
+    manager::Manager man(manager::LOG_NONE, manager::SIMULATION_NONE, 0);
+    man.run(exps, modules, 2, &results, &errors);
+
+    BOOST_REQUIRE_EQUAL(results.size(), 2u);
+    BOOST_REQUIRE_EQUAL(errors.size(), 2u);
+    BOOST_CHECK(not results[0] and not results[1]);
+    BOOST_CHECK(errors[0].code and errors[1].code);
+
+    /*
+     * Two frames simulate their counters and the dynamics of the third
+     * frame cannot be loaded: the results and the errors are reported
+     * by frame.
+     */
+    std::vector < double > steps;
+    steps.push_back(1.0);
+    steps.push_back(2.0);
+
+    exps.clear();
+    exps.push_back(makeCounter(5.0, steps));
+    exps.push_back(makeCounter(5.0, std::vector < double >(1, 3.0)));
+    exps.push_back(makeCounter(5.0, std::vector < double >(1, 4.0)));
+    exps.back()->project().dynamics().get("counter").setLibrary("unknown");
+
+    man.run(exps, modules, 2, &results, &errors);
+
+    BOOST_REQUIRE_EQUAL(results.size(), 3u);
+    BOOST_REQUIRE_EQUAL(errors.size(), 3u);
+    BOOST_CHECK_EQUAL(errors[0].code, 0);
+    BOOST_CHECK_EQUAL(errors[1].code, 0);
+    BOOST_CHECK(errors[2].code);
+
+    BOOST_REQUIRE(results[0] and results[1]);
+    BOOST_REQUIRE_EQUAL(results[0]->columns(), 2u);
+    BOOST_REQUIRE_EQUAL(results[1]->columns(), 1u);
+    BOOST_CHECK_EQUAL(getLast(getView(*results[0], 0)), 5.0);
+    BOOST_CHECK_EQUAL(getLast(getView(*results[0], 1)), 10.0);
+    BOOST_CHECK_EQUAL(getLast(getView(*results[1], 0)), 15.0);
+
+    for (std::vector < value::Matrix* >::iterator it = results.begin();
+         it != results.end(); ++it) {
+        delete *it;
+    }
+}
+
+#if not defined _WIN32 && not defined __CYGWIN__
+BOOST_AUTO_TEST_CASE(manager_branch)
+{
+    utils::ModuleManager modules;
+    std::vector < double > steps;
+    steps.push_back(1.0);
+    steps.push_back(2.0);
+    steps.push_back(3.0);
+
+    /*
+     * The children inherit the output plug-ins of the parent: the
+     * asynchronous outputs and the outputs written into files are
+     * rejected.
+     */
+    {
+        manager::Manager man(manager::LOG_NONE, manager::SIMULATION_NONE, 0);
+        manager::Error error;
+        man.setBranch(true, 2.0);
+
+        vpz::Vpz *vpz = makeCounter(5.0, steps);
+        vpz->project().experiment().views().outputs().get(
+            "storage").setAsynchronous(true);
+        BOOST_CHECK_THROW(man.run(vpz, modules, 2, 0, 1, &error),
+                          utils::ArgError);
+
+        vpz = makeCounter(5.0, steps);
+        vpz->project().experiment().views().outputs().get(
+            "storage").setLocalStream("", "text", "vle.output");
+        BOOST_CHECK_THROW(man.run(vpz, modules, 2, 0, 1, &error),
+                          utils::ArgError);
+    }
+
+    std::string base;
+    {
+        std::ofstream file;
+        base = utils::Path::getTempFile("vle-branch-", &file);
+    }
+    std::string directory(base + ".d");
+
+    manager::Error error;
+    manager::Manager mono(manager::LOG_NONE, manager::SIMULATION_NONE, 0);
+    mono.setCache(directory, 1024 * 1024);
+    std::auto_ptr < value::Matrix > plain(
+        mono.run(makeCounter(5.0, steps), modules, 1, 0, 1, &error));
+    BOOST_REQUIRE_EQUAL(error.code, 0);
+    BOOST_REQUIRE(plain.get());
+
+    /*
+     * The results of the branches depend on the beginning: the cache
+     * is rejected.
+     */
+    manager::Manager man(manager::LOG_NONE, manager::SIMULATION_NONE, 0);
+    man.setCache(directory, 1024 * 1024);
+    man.setBranch(true, 2.0);
+    BOOST_CHECK_THROW(man.run(makeCounter(5.0, steps), modules, 2, 0, 1,
+                              &error), utils::ArgError);
+
+    /*
+     * Branched at 2, a counter adds the step of the first combination
+     * until 2 and its own step after 2.
+     */
+    man.setCache(std::string(), 0);
+    std::auto_ptr < value::Matrix > branched(
+        man.run(makeCounter(5.0, steps), modules, 2, 0, 1, &error));
+    BOOST_REQUIRE_EQUAL(error.code, 0);
+    BOOST_REQUIRE(branched.get());
+
+    const value::Matrix& first(getView(*branched, 0));
+    const value::Matrix& reference(getView(*plain, 0));
+    BOOST_REQUIRE_EQUAL(first.rows(), reference.rows());
+    for (value::Matrix::size_type i = 0; i < first.rows(); ++i) {
+        BOOST_CHECK_CLOSE(value::toDouble(first.get(1, i)),
+                          value::toDouble(reference.get(1, i)), 1e-9);
+    }
+
+    for (uint32_t i = 1; i < steps.size(); ++i) {
+        const value::Matrix& view(getView(*branched, i));
+        BOOST_CHECK_EQUAL(view.rows(), getView(*plain, i).rows());
+        BOOST_CHECK(getLast(view) > getLast(getView(*branched, i - 1)));
+        BOOST_CHECK(getLast(view) < getLast(getView(*plain, i)));
+    }
+
+    boost::filesystem::remove_all(directory);
+    std::remove(base.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(manager_process)
+{
+    utils::ModuleManager modules;
+    std::vector < double > steps;
+    for (int i = 1; i <= 5; ++i) {
+        steps.push_back(i);
+    }
+
+    manager::Error error;
+    manager::Manager mono(manager::LOG_NONE, manager::SIMULATION_NONE, 0);
+    std::auto_ptr < value::Matrix > reference(
+        mono.run(makeCounter(5.0, steps), modules, 1, 0, 1, &error));
+    BOOST_REQUIRE_EQUAL(error.code, 0);
+    BOOST_REQUIRE(reference.get());
+
+    /*
+     * Two worker processes simulate the five combinations: the results
+     * are read from their frames.
+     */
+    manager::Manager man(manager::LOG_NONE,
+                         manager::SIMULATION_SPAWN_PROCESS, 0);
+    std::auto_ptr < value::Matrix > result(
+        man.run(makeCounter(5.0, steps), modules, 2, 0, 1, &error));
+    BOOST_REQUIRE_EQUAL(error.code, 0);
+    BOOST_REQUIRE(result.get());
+    BOOST_REQUIRE_EQUAL(result->columns(), steps.size());
+    checkSameResults(*reference, *result);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(manager_reuse)
+{
+    utils::ModuleManager modules;
+    std::vector < double > steps;
+    steps.push_back(1.0);
+    steps.push_back(2.0);
+    steps.push_back(3.0);
+    steps.push_back(4.0);
+
+    /*
+     * The counters draw random numbers: the reset models must restore
+     * their state and their random streams like the rebuilt models.
+     */
+    value::Matrix *results[2];
+    manager::SimulationOptions options[2] = {
+        manager::SIMULATION_NONE, manager::SIMULATION_REUSE_MODELS };
+
+    for (int i = 0; i < 2; ++i) {
+        vpz::Vpz *vpz = makeCounter(10.0, steps);
+        vpz->project().experiment().conditions().get(
+            "counter").addValueToPort("random", value::Boolean(true));
+
+        manager::Manager man(manager::LOG_NONE, options[i], 0);
+        manager::Error error;
+        results[i] = man.run(vpz, modules, 1, 0, 1, &error);
+        BOOST_REQUIRE_EQUAL(error.code, 0);
+        BOOST_REQUIRE(results[i]);
+    }
+
+    std::auto_ptr < value::Matrix > fresh(results[0]);
+    std::auto_ptr < value::Matrix > reused(results[1]);
+
+    BOOST_REQUIRE_EQUAL(fresh->columns(), steps.size());
+    checkSameResults(*fresh, *reused);
+}
+
+/*
+ * Build the conditions of the counters which draw random numbers with
+ * the steps 2 and 3.
+ */
+static void makeRandomConditions(vpz::Conditions *conditions, bool reset)
+{
+    for (int i = 0; i < 2; ++i) {
+        vpz::Condition condition("counter");
+        condition.addValueToPort("step", value::Double(i + 2.0));
+        condition.addValueToPort("random", value::Boolean(true));
+        condition.addValueToPort("reset", value::Boolean(reset));
+        conditions[i].add(condition);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(root_reset)
+{
+    utils::ModuleManager modules;
+    vpz::Vpz *vpz = makeCounter(10.0, std::vector < double >(1, 1.0));
+    vpz::Conditions conditions[2];
+    makeRandomConditions(conditions, true);
+
+    std::auto_ptr < value::Map > expected;
+    std::auto_ptr < value::Map > other;
+    std::auto_ptr < value::Map > result;
+
+    {
+        devs::RootCoordinator root(modules);
+        root.load(*vpz, conditions[0], "exp-0");
+        root.init();
+        while (root.run()) {}
+        expected.reset(root.outputs());
+        root.finish();
+    }
+
+    /*
+     * A counter simulated with other conditions then reset restores its
+     * step and its random stream: its trajectory is the one of a new
+     * counter.
+     */
+    {
+        devs::RootCoordinator root(modules);
+        root.load(*vpz, conditions[1], "exp-1");
+        root.init();
+        while (root.run()) {}
+        root.close();
+        other.reset(root.outputs());
+
+        root.reset(conditions[0], "exp-0");
+        root.init();
+        while (root.run()) {}
+        result.reset(root.outputs());
+        root.finish();
+    }
+
+    BOOST_REQUIRE(expected.get() and other.get() and result.get());
+    checkSameView(expected->getMatrix("view"), result->getMatrix("view"));
+    BOOST_CHECK(getLast(other->getMatrix("view")) !=
+                getLast(result->getMatrix("view")));
+
+    delete vpz->project().model().model();
+    delete vpz;
+}
+
+BOOST_AUTO_TEST_CASE(root_reset_fallback)
+{
+    utils::ModuleManager modules;
+    vpz::Vpz *vpz = makeCounter(10.0, std::vector < double >(1, 1.0));
+    vpz::Conditions conditions[2];
+    makeRandomConditions(conditions, false);
+
+    /*
+     * The counters refuse the reset (Dynamics::reset returns false): the
+     * RootCoordinator can only be finished.
+     */
+    {
+        devs::RootCoordinator root(modules);
+        root.load(*vpz, conditions[1], "exp-1");
+        root.init();
+        while (root.run()) {}
+        root.close();
+        delete root.outputs();
+
+        BOOST_CHECK_THROW(root.reset(conditions[0], "exp-0"),
+                          utils::ModellingError);
+        root.finish();
+    }
+
+    /*
+     * A Simulation which reuses the models rebuilds them instead: the
+     * results are the ones of new models.
+     */
+    {
+        manager::Error error;
+        manager::Simulation fresh(manager::LOG_NONE,
+                                  manager::SIMULATION_NONE, 0);
+        manager::Simulation sim(manager::LOG_NONE,
+                                manager::SIMULATION_NONE, 0);
+        sim.setReuse(true);
+
+        std::auto_ptr < value::Map > expected[2];
+        for (int i = 0; i < 2; ++i) {
+            expected[i].reset(fresh.run(*vpz, conditions[i], "exp", modules,
+                                        &error));
+            BOOST_REQUIRE_EQUAL(error.code, 0);
+            BOOST_REQUIRE(expected[i].get());
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            std::auto_ptr < value::Map > result(
+                sim.run(*vpz, conditions[i % 2], "exp", modules, &error));
+            BOOST_REQUIRE_EQUAL(error.code, 0);
+            BOOST_REQUIRE(result.get());
+            checkSameView(expected[i % 2]->getMatrix("view"),
+                          result->getMatrix("view"));
+        }
+    }
+
+    delete vpz->project().model().model();
+    delete vpz;
+}
+
+BOOST_AUTO_TEST_CASE(manager_asynchronous)
+{
+    utils::ModuleManager modules;
+    std::vector < double > steps;
+    steps.push_back(1.0);
+    steps.push_back(2.0);
+    steps.push_back(3.0);
+
+    /*
+     * The observations of an asynchronous output are written by a thread
+     * of the view: the results are the same as the synchronous ones.
+     */
+    std::auto_ptr < value::Matrix > results[2];
+
+    for (int i = 0; i < 2; ++i) {
+        vpz::Vpz *vpz = makeCounter(20.0, steps);
+        vpz->project().experiment().views().outputs().get(
+            "storage").setAsynchronous(i == 1);
+
+        manager::Manager man(manager::LOG_NONE, manager::SIMULATION_NONE, 0);
+        manager::Error error;
+        results[i].reset(man.run(vpz, modules, 2, 0, 1, &error));
+        BOOST_REQUIRE_EQUAL(error.code, 0);
+        BOOST_REQUIRE(results[i].get());
+    }
+
+    BOOST_REQUIRE_EQUAL(results[0]->columns(), steps.size());
+    checkSameResults(*results[0], *results[1]);
+
+    /*
+     * The results read before the end of the simulation contain all the
+     * observations pushed into the queue of the asynchronous output.
+     */
+    value::Matrix::size_type rows[2];
+    double last[2];
+
+    for (int i = 0; i < 2; ++i) {
+        vpz::Vpz *vpz = makeCounter(20.0, std::vector < double >(1, 1.0));
+        vpz->project().experiment().views().outputs().get(
+            "storage").setAsynchronous(i == 1);
+
+        devs::RootCoordinator root(modules);
+        root.load(*vpz);
+        vpz->clear();
+        delete vpz;
+
+        root.init();
+        while (root.run()) {}
+
+        value::Map *outputs = root.outputs();
+        BOOST_REQUIRE(outputs);
+        rows[i] = outputs->getMatrix("view").rows();
+        last[i] = getLast(outputs->getMatrix("view"));
+
+        root.finish();
+        delete outputs;
+    }
+
+    BOOST_CHECK_EQUAL(rows[0], rows[1]);
+    BOOST_CHECK_EQUAL(last[0], last[1]);
+}
+
+BOOST_AUTO_TEST_CASE(simulation_termination)
+{
+    utils::ModuleManager modules;
+
+    /*
+     * The counter reaches its limit at time 5 and ends the simulation,
+     * observed by a view or not. Then the predicate on its observations
+     * ends the simulation at time 3.
+     */
+    for (int i = 0; i < 3; ++i) {
+        vpz::Vpz *vpz = makeCounter(20.0, std::vector < double >(1, 1.0));
+        vpz::Conditions& cnds(vpz->project().experiment().conditions());
+
+        if (i < 2) {
+            cnds.get("counter").addValueToPort("limit", value::Double(5.0));
+        } else {
+            vpz::Condition stop(devs::Termination::name());
+            stop.addValueToPort("counter.value", value::String(">= 3"));
+            cnds.add(stop);
+        }
+
+        if (i == 1) {
+            vpz->project().model().model()->toCoupled()->findModel(
+                "counter")->toAtomic()->setObservables("");
+        }
+
+        devs::RootCoordinator root(modules);
+        root.load(*vpz);
+        vpz->clear();
+        delete vpz;
+
+        root.init();
+        while (root.run()) {}
+
+        BOOST_CHECK(not root.terminated().empty());
+        BOOST_CHECK_EQUAL(root.getCurrentTime(), (i < 2) ? 5.0 : 3.0);
+
+        value::Map *outputs = root.outputs();
+        BOOST_REQUIRE(outputs);
+        if (i != 1) {
+            BOOST_CHECK_EQUAL(getLast(outputs->getMatrix("view")),
+                              (i < 2) ? 5.0 : 3.0);
+        }
+
+        root.finish();
+        delete outputs;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(simulation_model_threads)
+{
+    utils::ModuleManager modules;
+    std::vector < double > steps(1, 1.0);
+    std::auto_ptr < value::Map > results[2];
+
+    /*
+     * The four counters are built and initialized by one thread, then
+     * by four threads: the observations are the same.
+     */
+    for (int i = 0; i < 2; ++i) {
+        vpz::Vpz *vpz = makeCounter(5.0, steps);
+        vpz::CoupledModel *top = vpz->project().model().model()->toCoupled();
+
+        for (int j = 1; j < 4; ++j) {
+            vpz::AtomicModel *atom = top->addAtomicModel(
+                "counter" + boost::lexical_cast < std::string >(j));
+            atom->setDynamics("counter");
+            atom->addCondition("counter");
+            atom->setObservables("counter");
+        }
+
+        manager::Simulation sim(manager::LOG_NONE, manager::SIMULATION_NONE,
+                                0);
+        manager::Error error;
+        sim.setModelThreads(i == 0 ? 1 : 4);
+        results[i].reset(sim.run(vpz, modules, &error));
+        BOOST_REQUIRE_EQUAL(error.code, 0);
+        BOOST_REQUIRE(results[i].get());
+    }
+
+    BOOST_REQUIRE_EQUAL(results[0]->getMatrix("view").columns(), 5u);
+    checkSameView(results[0]->getMatrix("view"),
+                  results[1]->getMatrix("view"));
+}
+
+BOOST_AUTO_TEST_CASE(simulation_shared)
+{
+    utils::ModuleManager modules;
+    vpz::Vpz *vpz = makeCounter(5.0, std::vector < double >(1, 1.0));
+    vpz::BaseModel *top = vpz->project().model().model();
+
+    /*
+     * Three simulations are loaded from the same parsed experiment before
+     * they run, the second with another step: the first and the third
+     * give the same observations and the experiment is not modified.
+     */
+    vpz::Conditions conditions[2];
+    for (int i = 0; i < 2; ++i) {
+        vpz::Condition condition("counter");
+        condition.addValueToPort("step", value::Double(i + 1.0));
+        condition.addValueToPort("random", value::Boolean(true));
+        conditions[i].add(condition);
+    }
+
+    boost::scoped_ptr < devs::RootCoordinator > roots[3];
+    std::auto_ptr < value::Map > results[3];
+
+    for (int i = 0; i < 3; ++i) {
+        roots[i].reset(new devs::RootCoordinator(modules));
+        roots[i]->load(*vpz, conditions[i == 1],
+                       "exp-" + boost::lexical_cast < std::string >(i));
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        roots[i]->init();
+        while (roots[i]->run()) {}
+
+        results[i].reset(roots[i]->outputs());
+        BOOST_REQUIRE(results[i].get());
+        roots[i]->finish();
+    }
+
+    const value::Matrix& view(results[2]->getMatrix("view"));
+
+    checkSameView(results[0]->getMatrix("view"), view);
+    BOOST_CHECK(getLast(results[1]->getMatrix("view")) != getLast(view));
+
+    BOOST_CHECK_EQUAL(vpz->project().model().model(), top);
+    BOOST_CHECK_EQUAL(vpz->project().experiment().name(), "counter");
+    BOOST_CHECK_EQUAL(value::toDouble(vpz->project().experiment().conditions()
+                                      .get("counter").firstValue("step")),
+                      1.0);
+    std::list < std::string > ports;
+    vpz->project().experiment().conditions().get("counter").portnames(ports);
+    BOOST_CHECK_EQUAL(ports.size(), 1u);
+
+    delete vpz->project().model().model();
+    delete vpz;
+}
+
+BOOST_AUTO_TEST_CASE(admission)
+{
+    manager::Admission admission(1000, 100);
+
+    BOOST_CHECK(admission.tryAcquire());
+    BOOST_CHECK(not admission.tryAcquire());
+
+    admission.release(100, 400);
+    BOOST_CHECK_EQUAL(admission.estimate(), 300u);
+
+    BOOST_CHECK(admission.tryAcquire());
+    BOOST_CHECK(admission.tryAcquire());
+    BOOST_CHECK(admission.tryAcquire());
+    BOOST_CHECK(not admission.tryAcquire());
+
+    /*
+     * Three simulations grow the memory together: a sample is the
+     * growth divided by the simulations in progress.
+     */
+    admission.release(400, 1000);
+    BOOST_CHECK_EQUAL(admission.estimate(), 275u);
+    BOOST_CHECK(admission.tryAcquire());
+    BOOST_CHECK(not admission.tryAcquire());
+
+    /*
+     * The resident memory stays high while the simulations end (the
+     * allocator keeps the memory freed): the estimation does not grow
+     * when fewer simulations are in progress.
+     */
+    admission.release(1000, 1000);
+    BOOST_CHECK_EQUAL(admission.estimate(), 206u);
+    admission.release(1000, 1000);
+    BOOST_CHECK_EQUAL(admission.estimate(), 154u);
+    admission.release(1000, 1000);
+    BOOST_CHECK_EQUAL(admission.estimate(), 115u);
+
+    for (int i = 0; i < 7; ++i) {
+        BOOST_CHECK(admission.tryAcquire());
+    }
+    BOOST_CHECK(not admission.tryAcquire());
+
+    manager::Admission tiny(10, 0);
+    BOOST_CHECK(tiny.tryAcquire());
+    tiny.release(0, 100);
+    BOOST_CHECK(tiny.tryAcquire());
+    BOOST_CHECK(not tiny.tryAcquire());
+}
+
+/*
+ * Take the combinations of a thread from the Scheduler until the end.
+ */
+static void takeAll(manager::Scheduler *scheduler, uint32_t thread,
+                    std::vector < uint32_t > *taken)
+{
+    uint32_t index;
+
+    while (scheduler->next(thread, &index)) {
+        taken->push_back(index);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(scheduler)
+{
+    /*
+     * With more threads than combinations, or fewer, the threads which
+     * steal the combinations of the others take each combination once.
+     */
+    const uint32_t sizes[] = { 3, 1000 };
+    const uint32_t threads = 8;
+
+    for (int i = 0; i < 2; ++i) {
+        manager::Scheduler scheduler(10, 10 + sizes[i], threads);
+        std::vector < uint32_t > taken[threads];
+        boost::thread_group group;
+
+        for (uint32_t j = 0; j < threads; ++j) {
+            group.create_thread(boost::bind(&takeAll, &scheduler, j,
+                                            &taken[j]));
+        }
+        group.join_all();
+
+        std::vector < uint32_t > counts(sizes[i], 0);
+        for (uint32_t j = 0; j < threads; ++j) {
+            for (std::vector < uint32_t >::const_iterator it =
+                     taken[j].begin(); it != taken[j].end(); ++it) {
+                BOOST_REQUIRE(*it >= 10 and *it < 10 + sizes[i]);
+                counts[*it - 10]++;
+            }
+        }
+
+        BOOST_CHECK_EQUAL(std::count(counts.begin(), counts.end(), 1u),
+                          static_cast < std::ptrdiff_t >(sizes[i]));
+    }
+
+    /*
+     * A thread without combination steals from the others, then all the
+     * threads see the end.
+     */
+    manager::Scheduler scheduler(0, 2, 4);
+    uint32_t index;
+    BOOST_REQUIRE(scheduler.next(0, &index));
+    BOOST_CHECK(scheduler.next(0, &index));
+    BOOST_CHECK(not scheduler.next(0, &index));
+    for (uint32_t j = 0; j < 4; ++j) {
+        BOOST_CHECK(not scheduler.next(j, &index));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reduction_summary)
+{
+    std::vector < double > probabilities;
+    probabilities.push_back(0.5);
+
+    manager::Reduction reduction(probabilities);
+
+    for (int i = 0; i < 4; ++i) {
+        value::Map result;
+        value::Matrix *view = new value::Matrix(2, 2, 2, 2);
+        view->add(0, 0, new value::String("time"));
+        view->add(1, 0, new value::String("x"));
+        view->add(0, 1, new value::Double(0.0));
+        view->add(1, 1, new value::Double(i));
+        result.add("view", view);
+
+        reduction.add(result);
+    }
+
+    BOOST_CHECK_EQUAL(reduction.size(), 4u);
+    BOOST_REQUIRE(reduction.get("view", 1, 1));
+    BOOST_CHECK_CLOSE(reduction.get("view", 1, 1)->mean(), 1.5, 1e-10);
+    BOOST_CHECK(not reduction.get("view", 1, 0));
+    BOOST_CHECK(not reduction.get("unknown", 0, 0));
+
+    value::Map *summary = reduction.summary();
+    const value::Map& view(summary->getMap("view"));
+    const value::Matrix& mean(view.getMatrix("mean"));
+    BOOST_CHECK_EQUAL(mean.get(1, 0)->toString().value(), "x");
+    BOOST_CHECK_CLOSE(mean.get(1, 1)->toDouble().value(), 1.5, 1e-10);
+    BOOST_CHECK_CLOSE(view.getMatrix("max").get(1, 1)->toDouble().value(),
+                      3.0, 1e-10);
+    BOOST_CHECK_EQUAL(view.getSet("quantiles").size(), 1u);
+    BOOST_CHECK_CLOSE(view.getSet("quantiles").getMatrix(0).get(1, 1)->
+                      toDouble().value(), 1.5, 1e-10);
+    delete summary;
+}
+
+BOOST_AUTO_TEST_CASE(result_store)
+{
+    std::string filename;
+    {
+        std::ofstream file;
+        filename = utils::Path::getTempFile("vle-result-", &file);
+    }
+
+    {
+        manager::ResultWriter writer(filename);
+
+        for (int i = 9; i >= 0; --i) {
+            value::Map result;
+            result.addInt("index", i);
+            writer.write(i, &result);
+        }
+        writer.write(10, (const value::Value*)0);
+        BOOST_CHECK_EQUAL(writer.size(), 11u);
+    }
+
+    {
+        manager::ResultReader reader(filename);
+        BOOST_REQUIRE_EQUAL(reader.size(), 11u);
+        BOOST_CHECK_EQUAL(reader.indices().front(), 0u);
+        BOOST_CHECK(not reader.exist(11));
+
+        value::Value *result = reader.read(7);
+        BOOST_REQUIRE(result);
+        BOOST_CHECK_EQUAL(result->toMap().getInt("index"), 7);
+        delete result;
+
+        BOOST_CHECK(not reader.read(10));
+        BOOST_CHECK_THROW(reader.read(11), utils::ArgError);
+    }
+
+    /*
+     * Without the index (an interrupted writer), the complete records
+     * are read.
+     */
+    {
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        std::string content((std::istreambuf_iterator < char >(in)),
+                            std::istreambuf_iterator < char >());
+        in.close();
+
+        std::string::size_type end = content.size() - 8 - 8 -
+            (4 + 4 + 11 * (4 + 8));
+        std::ofstream out(filename.c_str(), std::ios::binary |
+                          std::ios::trunc);
+        out.write(content.data(), end - 3);
+    }
+
+    {
+        manager::ResultReader reader(filename);
+        BOOST_REQUIRE_EQUAL(reader.size(), 10u);
+        BOOST_CHECK(not reader.exist(10));
+
+        value::Value *result = reader.read(0);
+        BOOST_CHECK_EQUAL(result->toMap().getInt("index"), 0);
+        delete result;
+    }
+
+    /*
+     * The records of the version 01 have a 32 bits size: the files are
+     * rejected.
+     */
+    {
+        std::ofstream out(filename.c_str(), std::ios::binary |
+                          std::ios::trunc);
+        out.write("VLERES01", 8);
+    }
+
+    BOOST_CHECK_THROW(manager::ResultReader reader(filename),
+                      utils::FileError);
+
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(journal_resume)
+{
+    std::string base;
+    {
+        std::ofstream file;
+        base = utils::Path::getTempFile("vle-journal-", &file);
+    }
+
+    std::string filename(base + ".journal");
+
+    {
+        manager::Journal journal(filename, false, true);
+
+        for (int i = 0; i < 3; ++i) {
+            value::Map result;
+            result.addInt("index", i);
+
+            if (i == 1) {
+                journal.failure(i);
+            } else {
+                journal.success(i, &result);
+            }
+        }
+    }
+
+    /*
+     * The last line of an interrupted journal is ignored.
+     */
+    {
+        std::ofstream out(filename.c_str(), std::ios::app);
+        out << "3\tsucc";
+    }
+
+    {
+        manager::Journal journal(filename, true, true);
+        BOOST_CHECK_EQUAL(journal.completed(), 2u);
+        BOOST_CHECK(not journal.find(1, 0));
+        BOOST_CHECK(not journal.find(3, 0));
+
+        value::Value *result;
+        BOOST_REQUIRE(journal.find(2, &result));
+        BOOST_REQUIRE(result);
+        BOOST_CHECK_EQUAL(result->toMap().getInt("index"), 2);
+        delete result;
+
+        value::Map one;
+        one.addInt("index", 1);
+        journal.success(1, &one);
+    }
+
+    {
+        manager::Journal journal(filename, true, false);
+        BOOST_CHECK_EQUAL(journal.completed(), 3u);
+
+        value::Value *result;
+        BOOST_REQUIRE(journal.find(1, &result));
+        BOOST_REQUIRE(result);
+        BOOST_CHECK_EQUAL(result->toMap().getInt("index"), 1);
+        delete result;
+
+        BOOST_REQUIRE(journal.find(0, &result));
+        BOOST_REQUIRE(result);
+        BOOST_CHECK_EQUAL(result->toMap().getInt("index"), 0);
+        delete result;
+
+        value::Map four;
+        four.addInt("index", 4);
+        journal.success(4, &four);
+    }
+
+    /*
+     * The result of the combination 4 is not stored: it is completed,
+     * but not found when its result is requested.
+     */
+    {
+        manager::Journal journal(filename, true, true);
+        BOOST_CHECK_EQUAL(journal.completed(), 4u);
+        BOOST_CHECK(journal.find(4, 0));
+
+        value::Value *result;
+        BOOST_CHECK(not journal.find(4, &result));
+        BOOST_CHECK(not result);
+    }
+
+    /*
+     * A crashed run leaves a missing or truncated result store: its
+     * combinations are not found and they are simulated again.
+     */
+    std::remove((base + ".res").c_str());
+    {
+        std::string store(base + ".1.res");
+        std::ifstream in(store.c_str(), std::ios::binary);
+        std::string header(12, '\0');
+        in.read(&header[0], header.size());
+        header.resize(in.gcount());
+        in.close();
+
+        std::ofstream out(store.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(header.data(), header.size());
+    }
+
+    {
+        manager::Journal journal(filename, true, false);
+        BOOST_CHECK_EQUAL(journal.completed(), 4u);
+
+        value::Value *result;
+        BOOST_CHECK(not journal.find(0, &result));
+        BOOST_CHECK(not result);
+        BOOST_CHECK(not journal.find(1, &result));
+        BOOST_CHECK(not result);
+        BOOST_CHECK(journal.find(2, 0));
+    }
+
+    std::remove(filename.c_str());
+    std::remove((base + ".res").c_str());
+    std::remove((base + ".1.res").c_str());
+    std::remove((base + ".2.res").c_str());
+    std::remove(base.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(cache_results)
+{
+    std::string base;
+    {
+        std::ofstream file;
+        base = utils::Path::getTempFile("vle-cache-", &file);
+    }
+
+    std::string directory(base + ".d");
+
+    vpz::Conditions conditions;
+    vpz::Condition cond("cond");
+    cond.addValueToPort("seed", value::Integer(1));
+    conditions.add(cond);
+
+    std::string key1 = manager::Cache::key("fingerprint", conditions);
+    BOOST_CHECK_EQUAL(key1, manager::Cache::key("fingerprint", conditions));
+    BOOST_CHECK(key1 != manager::Cache::key("other", conditions));
+
+    conditions.get("cond").setValueToPort("seed", value::Integer(2));
+    std::string key2 = manager::Cache::key("fingerprint", conditions);
+    BOOST_CHECK(key1 != key2);
+
+    {
+        manager::Cache cache(directory, 1024 * 1024);
+        value::Value *result;
+
+        BOOST_CHECK(not cache.get(key1, &result));
+
+        value::Map map;
+        map.addInt("seed", 1);
+        cache.put(key1, &map);
+        BOOST_CHECK_EQUAL(cache.entries(), 1u);
+
+        BOOST_REQUIRE(cache.get(key1, &result));
+        BOOST_REQUIRE(result);
+        BOOST_CHECK_EQUAL(result->toMap().getInt("seed"), 1);
+        delete result;
+    }
+
+    /*
+     * The cache is persistent and bounded: with a capacity of one
+     * result, the least recently used result is removed.
+     */
+    {
+        manager::Cache cache(directory, 1024 * 1024);
+        BOOST_CHECK_EQUAL(cache.entries(), 1u);
+        uint64_t size = cache.size();
+
+        manager::Cache bounded(directory, size);
+        value::Map map;
+        map.addInt("seed", 2);
+        bounded.put(key2, &map);
+        BOOST_CHECK_EQUAL(bounded.entries(), 1u);
+
+        value::Value *result;
+        BOOST_CHECK(not bounded.get(key1, &result));
+        BOOST_REQUIRE(bounded.get(key2, &result));
+        BOOST_CHECK_EQUAL(result->toMap().getInt("seed"), 2);
+        delete result;
+
+        bounded.clear();
+        BOOST_CHECK_EQUAL(bounded.entries(), 0u);
+        BOOST_CHECK_EQUAL(bounded.size(), 0u);
+    }
+
+    boost::filesystem::remove_all(directory);
+    std::remove(base.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(cache_conditions)
+{
+    utils::ModuleManager modules;
+    std::string base;
+    {
+        std::ofstream file;
+        base = utils::Path::getTempFile("vle-cache-", &file);
+    }
+
+    std::string directory(base + ".d");
+    std::vector < double > steps;
+    steps.push_back(1.0);
+    steps.push_back(2.0);
+    steps.push_back(3.0);
+
+    /*
+     * The fingerprint does not depend on the values of the conditions:
+     * after the change of one step, the results of the two other
+     * combinations are read from the cache.
+     */
+    vpz::Vpz *first = makeCounter(5.0, steps);
+    steps[2] = 4.0;
+    vpz::Vpz *second = makeCounter(5.0, steps);
+
+    BOOST_CHECK_EQUAL(manager::Cache::fingerprint(*first),
+                      manager::Cache::fingerprint(*second));
+
+    manager::Error error;
+    manager::Manager man(manager::LOG_NONE, manager::SIMULATION_NONE, 0);
+    man.setCache(directory, 1024 * 1024);
+
+    std::auto_ptr < value::Matrix > result(
+        man.run(first, modules, 1, 0, 1, &error));
+    BOOST_REQUIRE_EQUAL(error.code, 0);
+    BOOST_CHECK_EQUAL(manager::Cache(directory, 1024 * 1024).entries(), 3u);
+
+    result.reset(man.run(second, modules, 1, 0, 1, &error));
+    BOOST_REQUIRE_EQUAL(error.code, 0);
+    BOOST_REQUIRE(result.get());
+    BOOST_CHECK_EQUAL(manager::Cache(directory, 1024 * 1024).entries(), 4u);
+    BOOST_CHECK_EQUAL(getLast(getView(*result, 1)), 10.0);
+    BOOST_CHECK_EQUAL(getLast(getView(*result, 2)), 20.0);
+
+    boost::filesystem::remove_all(directory);
+    std::remove(base.c_str());
+}
@@ -26,9 +26,178 @@
 
 
 #include <vle/oov/CairoPlugin.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <deque>
+#include <cmath>
 
 namespace vle { namespace oov {
 
+/**
+ * @brief A pool of threads to encode the copies of the stored
+ * ImageSurface into PNG files. The number of frames waiting for encoding
+ * is bounded, so writeStored waits when the encoders are too slow. The
+ * reference count of a Cairo::RefPtr is not atomic: the frames are
+ * swapped into and out of the queue under the lock, a RefPtr is never
+ * copied between the threads.
+ */
+class CairoPlugin::Encoder
+{
+public:
+    Encoder(unsigned int threads)
+        : m_capacity(2 * threads), m_pending(0), m_stop(false)
+    {
+        for (unsigned int i = 0; i < threads; ++i) {
+            m_threads.create_thread(boost::bind(&Encoder::run, this));
+        }
+    }
+
+    ~Encoder()
+    {
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_stop = true;
+            m_notEmpty.notify_all();
+        }
+
+        m_threads.join_all();
+    }
+
+    /**
+     * @brief Queue a frame.
+     * @param img the image to encode, empty on return.
+     * @param file the name of the PNG file.
+     */
+    void push(Cairo::RefPtr < Cairo::ImageSurface >& img,
+              const std::string& file)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        while (m_queue.size() >= m_capacity and m_error.empty()) {
+            m_notFull.wait(lock);
+        }
+
+        if (not m_error.empty()) {
+            throw utils::InternalError(
+                fmt(_("oov: cannot write image '%1%'")) % m_error);
+        }
+
+        m_queue.push_back(Frame());
+        m_queue.back().first.swap(img);
+        m_queue.back().second = file;
+        m_pending++;
+        m_notEmpty.notify_one();
+    }
+
+    void flush()
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        while (m_pending > 0) {
+            m_notFull.wait(lock);
+        }
+
+        if (not m_error.empty()) {
+            throw utils::InternalError(
+                fmt(_("oov: cannot write image '%1%'")) % m_error);
+        }
+    }
+
+private:
+    typedef std::pair < Cairo::RefPtr < Cairo::ImageSurface >,
+                        std::string > Frame;
+
+    void run()
+    {
+        for (;;) {
+            Frame frame;
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+
+                while (m_queue.empty() and not m_stop) {
+                    m_notEmpty.wait(lock);
+                }
+
+                if (m_queue.empty()) {
+                    return;
+                }
+
+                frame.first.swap(m_queue.front().first);
+                frame.second.swap(m_queue.front().second);
+                m_queue.pop_front();
+                m_notFull.notify_all();
+            }
+
+            bool success = true;
+
+            try {
+                frame.first->write_to_png(frame.second);
+            } catch (const std::exception& /*e*/) {
+                success = false;
+            }
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+
+                if (not success and m_error.empty()) {
+                    m_error = frame.second;
+                }
+
+                m_pending--;
+                m_notFull.notify_all();
+            }
+        }
+    }
+
+    std::size_t               m_capacity;
+    std::size_t               m_pending;
+    bool                      m_stop;
+    std::string               m_error; ///< The first file not written.
+    std::deque < Frame >      m_queue;
+    boost::mutex              m_mutex;
+    boost::condition_variable m_notEmpty;
+    boost::condition_variable m_notFull;
+    boost::thread_group       m_threads;
+};
+
+/**
+ * @brief Get a numerical parameter from a value::Map.
+ * @param map the parameters.
+ * @param name the name of the parameter.
+ * @param value the default value, replaced by the parameter if it exists.
+ * @throw utils::ArgError if the parameter is not an integer or a double.
+ */
+static void getFrameParameter(const value::Map& map, const std::string& name,
+                              double& value)
+{
+    if (map.exist(name)) {
+        const value::Value* result = map.get(name);
+
+        if (result and result->isInteger()) {
+            value = result->toInteger().value();
+        } else if (result and result->isDouble()) {
+            value = result->toDouble().value();
+        } else {
+            throw utils::ArgError(
+                fmt(_("CairoPlugin: parameter '%1%' is not a number")) %
+                name);
+        }
+    }
+}
+
+CairoPlugin::~CairoPlugin()
+{
+    delete m_encoder;
+}
+
 void CairoPlugin::init()
 {
     int height, width;
@@ -78,4 +247,102 @@ void CairoPlugin::copy()
     }
 }
 
+void CairoPlugin::needCopy(const double& time)
+{
+    m_copydone = false;
+
+    if (m_framecount++ % m_framestep != 0) {
+        return;
+    }
+
+    if (m_lastframe and time < m_lastframetime + m_frametimestep) {
+        return;
+    }
+
+    m_need = true;
+    m_lastframe = true;
+    m_lastframetime = time;
+}
+
+void CairoPlugin::setFrameParameters(const value::Value* parameters)
+{
+    if (not parameters or not parameters->isMap()) {
+        return;
+    }
+
+    const value::Map& map = parameters->toMap();
+    double step = m_framestep;
+    double threads = m_framethreads;
+
+    getFrameParameter(map, "frame-step", step);
+    getFrameParameter(map, "frame-time-step", m_frametimestep);
+    getFrameParameter(map, "frame-scale", m_framescale);
+    getFrameParameter(map, "frame-threads", threads);
+
+    if (step < 1.0) {
+        throw utils::ArgError(
+            fmt(_("CairoPlugin: frame-step must be greater than 0 (%1%)")) %
+            step);
+    }
+
+    if (m_frametimestep < 0.0) {
+        throw utils::ArgError(
+            fmt(_("CairoPlugin: frame-time-step must be positive (%1%)")) %
+            m_frametimestep);
+    }
+
+    if (m_framescale <= 0.0 or m_framescale > 1.0) {
+        throw utils::ArgError(
+            fmt(_("CairoPlugin: frame-scale must be in ]0, 1] (%1%)")) %
+            m_framescale);
+    }
+
+    if (threads < 1.0) {
+        throw utils::ArgError(
+            fmt(_("CairoPlugin: frame-threads must be greater than 0 (%1%)"))
+            % threads);
+    }
+
+    m_framestep = static_cast < unsigned int >(step);
+    m_framethreads = static_cast < unsigned int >(threads);
+}
+
+void CairoPlugin::writeStored(const std::string& file)
+{
+    int width = std::max(1, static_cast < int >(
+            std::floor(m_store->get_width() * m_framescale)));
+    int height = std::max(1, static_cast < int >(
+            std::floor(m_store->get_height() * m_framescale)));
+
+    /*
+     * The encoder threads work on a copy of the stored ImageSurface, the
+     * plug-in can draw the next frames during the encoding.
+     */
+    Cairo::RefPtr < Cairo::ImageSurface > img =
+        Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, width, height);
+    Cairo::RefPtr < Cairo::Context > ctx = Cairo::Context::create(img);
+
+    ctx->save();
+    if (m_framescale != 1.0) {
+        ctx->scale(m_framescale, m_framescale);
+    }
+    ctx->set_source(m_store, 0.0, 0.0);
+    ctx->set_operator(Cairo::OPERATOR_SOURCE);
+    ctx->paint();
+    ctx->restore();
+
+    if (not m_encoder) {
+        m_encoder = new Encoder(m_framethreads);
+    }
+
+    m_encoder->push(img, file);
+}
+
+void CairoPlugin::flushStored()
+{
+    if (m_encoder) {
+        m_encoder->flush();
+    }
+}
+
 }} // namespace vle oov
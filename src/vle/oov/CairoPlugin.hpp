@@ -42,6 +42,16 @@ namespace vle { namespace oov {
  * @code
  * DECLARE_OOV_PLUGIN(Gnuplot);
  * @endcode
+ *
+ * The frames are written into PNG files by background encoder threads. The
+ * following parameters of the output (a value::Map) control the frames:
+ * - frame-step: an integer, only one frame over frame-step is written
+ *   (default 1).
+ * - frame-time-step: a double, the minimal simulated time between two
+ *   written frames (default 0).
+ * - frame-scale: a double in ]0, 1], the scale factor of the written
+ *   images (default 1).
+ * - frame-threads: an integer, the number of encoder threads (default 1).
  */
 class VLE_API CairoPlugin : public Plugin
 {
@@ -54,14 +64,15 @@ public:
      */
     CairoPlugin(const std::string& location)
         : Plugin(location), m_framenumber(0), m_need(false),
-        m_init(true), m_copydone(false)
+        m_init(true), m_copydone(false), m_framestep(1), m_framecount(0),
+        m_frametimestep(0.0), m_lastframetime(0.0), m_lastframe(false),
+        m_framescale(1.0), m_framethreads(1), m_encoder(0)
     {}
 
     /**
-     * @brief Nothing to delete.
+     * @brief Wait for the encoder threads.
      */
-    virtual ~CairoPlugin()
-    {}
+    virtual ~CairoPlugin();
 
     /**
      * @brief Build the Cairo::Context and the Cairo::ImageSurface. The size
@@ -122,6 +133,14 @@ public:
     void needCopy()
     { m_need = true; m_copydone = false; }
 
+    /**
+     * @brief Call this function to append an order to build new stored
+     * image at the specified date. The order is ignored if the frame is
+     * throttled by the frame-step or frame-time-step parameters.
+     * @param time the date of the frame.
+     */
+    void needCopy(const double& time);
+
     void needInit()
     { m_init = true; m_copydone = false; }
 
@@ -159,6 +178,30 @@ public:
      */
     void copy();
 
+    /**
+     * @brief Read the frame-step, frame-time-step, frame-scale and
+     * frame-threads parameters. Nothing to do if parameters is not a
+     * value::Map.
+     * @param parameters the parameters of the output.
+     * @throw utils::ArgError if a parameter is not valid.
+     */
+    void setFrameParameters(const value::Value* parameters);
+
+    /**
+     * @brief Copy the stored ImageSurface, scaled by the frame-scale
+     * parameter, and send it to the encoder threads. This function waits
+     * if too many frames are waiting for encoding.
+     * @param file the name of the PNG file.
+     * @throw utils::InternalError if a previous frame was not written.
+     */
+    void writeStored(const std::string& file);
+
+    /**
+     * @brief Wait until all the frames sent by writeStored are written.
+     * @throw utils::InternalError if a frame was not written.
+     */
+    void flushStored();
+
 protected:
     /**
      * @brief Context to draw onto the m_img ImageSurface.
@@ -196,6 +239,17 @@ private:
      * can be get with stored() function.
      */
     bool m_copydone;
+
+    unsigned int m_framestep; ///< Write one frame over m_framestep.
+    unsigned int m_framecount; ///< Number of frames asked by needCopy.
+    double m_frametimestep; ///< Minimal date between two frames.
+    double m_lastframetime; ///< Date of the latest written frame.
+    bool m_lastframe; ///< True if a frame was already written.
+    double m_framescale; ///< Scale factor of the written images.
+    unsigned int m_framethreads; ///< Number of encoder threads.
+
+    class Encoder; /**< The PNG encoder threads. */
+    Encoder* m_encoder;
 };
 
 /**
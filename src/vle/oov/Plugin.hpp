@@ -73,6 +73,9 @@ namespace vle { namespace oov {
  *
  * DECLARE_OOV_PLUGIN(Csv);
  * @endcode
+ *
+ * A plug-in which receives all the values of an observation in one call
+ * derives from \c RowPlugin.
  */
 class VLE_API Plugin
 {
@@ -0,0 +1,171 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_OOV_ROW_PLUGIN_HPP
+#define VLE_OOV_ROW_PLUGIN_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+namespace vle { namespace oov {
+
+/**
+ * Identifier of an observable (a \c devs::Simulator and a port name)
+ * in a view. The identifiers are small integers assigned by the \c
+ * devs::StreamWriter when the observable is attached to the view.
+ * The identifier of a removed observable can be reused.
+ */
+typedef uint32_t ObservableId;
+
+/**
+ * A row of observations: the values of all the observables of a view
+ * at the same date, indexed by \c ObservableId. The slot of an unused
+ * identifier is NULL.
+ */
+typedef std::vector < value::Value* > ObservationRow;
+
+/**
+ * \c vle::oov::RowPlugin is a \c Plugin which registers the observables
+ * with an \c ObservableId (\c onAddObservable, \c onRemoveObservable) and
+ * receives a complete row of values per observation (\c onRow), so the
+ * names of the simulator and of its parent are not sent with each value.
+ * @code
+ * class Csv : public RowPlugin
+ * {
+ *   //
+ *   // fill the virtual functions of the row interface.
+ *   //
+ * };
+ *
+ * DECLARE_OOV_PLUGIN(Csv);
+ * @endcode
+ *
+ * The \c devs::StreamWriter does not call the \c onNewObservable, \c
+ * onDelObservable and \c onValue functions of a \c RowPlugin. For the
+ * other plug-ins, it sends the values of a row to \c onValue in the
+ * order of the observation of the view.
+ */
+class VLE_API RowPlugin : public Plugin
+{
+public:
+    /**
+     * Default constructor of the RowPlugin.
+     *
+     * @param location this string represents the name of the default
+     * directory for a \c devs::LocalStreamWriter or a
+     * host:port:directory for a \c devs::DistantStreamWriter.
+     */
+    RowPlugin(const std::string& location)
+        : Plugin(location)
+    {
+    }
+
+    /**
+     * Nothing to delete.
+     */
+    virtual ~RowPlugin()
+    {
+    }
+
+    /**
+     * Call when a new observable is attached to the view. The
+     * observable is identified by @e id in the next calls to \c onRow
+     * and \c onRemoveObservable.
+     */
+    virtual void onAddObservable(ObservableId id,
+                                 const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time) = 0;
+
+    /**
+     * Call when the observable @e id is removed from the view.
+     */
+    virtual void onRemoveObservable(ObservableId id,
+                                    const double& time) = 0;
+
+    /**
+     * Call when the view is observed. The @e row stores the values of
+     * each observable at the date @e time. The plug-in takes the
+     * ownership of the values of the row. If the view does not have
+     * observable, the row stores only NULL values.
+     */
+    virtual void onRow(const std::string& view,
+                       const double& time,
+                       const ObservationRow& row) = 0;
+
+    /**
+     * Not used by the \c devs::StreamWriter.
+     */
+    virtual void onNewObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time);
+
+    /**
+     * Not used by the \c devs::StreamWriter.
+     */
+    virtual void onDelObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time);
+
+    /**
+     * Not used by the \c devs::StreamWriter, the value is deleted.
+     */
+    virtual void onValue(const std::string& simulator,
+                         const std::string& parent,
+                         const std::string& port,
+                         const std::string& view,
+                         const double& time,
+                         value::Value* value);
+};
+
+/**
+ * This typedef is used by the \c devs::StreamWriter to call the row
+ * interface of a plug-in.
+ */
+typedef boost::shared_ptr < RowPlugin > RowPluginPtr;
+
+/**
+ * Convert a PluginPtr reference to a RowPluginPtr reference.
+ * @param plg The PluginPtr to convert.
+ * @return The reference to the RowPluginPtr or 0 if convert failed.
+ */
+inline RowPluginPtr toRowPlugin(const PluginPtr& plg)
+{ return boost::dynamic_pointer_cast < RowPlugin >(plg); }
+
+}} // namespace vle oov
+
+#endif
@@ -80,6 +80,39 @@ namespace vle { namespace utils {
     public:
         typedef boost::mt19937::result_type result_type;
 
+        /**
+         * @brief The engine of the distributions: the numbers of the
+         * Mersenne Twister or, for an antithetic generator, their
+         * complement.
+         */
+        class Engine
+        {
+        public:
+            typedef boost::mt19937::result_type result_type;
+
+            BOOST_STATIC_CONSTANT(bool, has_fixed_range = false);
+
+            Engine() : antithetic(false) {}
+
+            explicit Engine(result_type seed) : mt(seed), antithetic(false) {}
+
+            static result_type min BOOST_PREVENT_MACRO_SUBSTITUTION ()
+            { return (boost::mt19937::min)(); }
+
+            static result_type max BOOST_PREVENT_MACRO_SUBSTITUTION ()
+            { return (boost::mt19937::max)(); }
+
+            result_type operator()()
+            {
+                result_type x = mt();
+
+                return antithetic ? (max)() - x + (min)() : x;
+            }
+
+            boost::mt19937 mt;
+            bool           antithetic;
+        };
+
         /**
          * @brief Create a new PRNG mersene twister initializecd with a seed
          * equal to 5489.
@@ -100,7 +133,28 @@ namespace vle { namespace utils {
          * @param seed a value to reinitialize the random number generator.
          */
         void seed(result_type seed)
-        { m_rand.seed(seed); }
+        { m_rand.mt.seed(seed); }
+
+        /**
+         * @brief Make the generator antithetic: each number x of the
+         * Mersenne Twister is replaced with its complement (max - x), so
+         * getDouble returns about 1 - u where a generator with the same seed
+         * returns u. The draws computed from one uniform number (getBool,
+         * getInt, getDouble, weibull) by two generators with the same seed,
+         * one antithetic, are negatively correlated: their mean has a lower
+         * variance than the mean of two independent draws. The other
+         * distributions are only computed from the complemented numbers.
+         * @param antithetic true to complement the numbers.
+         */
+        void setAntithetic(bool antithetic)
+        { m_rand.antithetic = antithetic; }
+
+        /**
+         * @brief Check if the generator is antithetic.
+         * @return true if the numbers are complemented.
+         */
+        bool antithetic() const
+        { return m_rand.antithetic; }
 
         /**
          * @brief Generate a boolean value [true, false] using the Bernoulli
@@ -110,7 +164,7 @@ namespace vle { namespace utils {
         inline bool getBool()
         {
             boost::bernoulli_distribution < > distrib(0.5);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::bernoulli_distribution < > >gen(m_rand, distrib);
 
             return gen();
@@ -134,7 +188,7 @@ namespace vle { namespace utils {
         inline int getInt(int begin, int end)
         {
             boost::uniform_int < > distrib(begin, end);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::uniform_int < > > gen(m_rand, distrib);
 
             return gen();
@@ -147,7 +201,7 @@ namespace vle { namespace utils {
         inline double getDouble()
         {
             boost::uniform_real < > distrib(0.0, 1.0);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::uniform_real < > > gen(m_rand, distrib);
 
             return gen();
@@ -162,7 +216,7 @@ namespace vle { namespace utils {
         inline double getDouble(double begin, double end)
         {
             boost::uniform_real < > distrib(begin, end);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::uniform_real < > > gen(m_rand, distrib);
 
             return gen();
@@ -184,7 +238,7 @@ namespace vle { namespace utils {
         double normal(double mean, double sigma)
         {
             boost::normal_distribution < > distrib(mean, sigma);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::normal_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -199,7 +253,7 @@ namespace vle { namespace utils {
         double logNormal(double mean, double sigma)
         {
             boost::lognormal_distribution < > distrib(mean, sigma);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::lognormal_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -213,7 +267,7 @@ namespace vle { namespace utils {
         double exponential(double rate)
         {
             boost::exponential_distribution < > distrib(rate);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::exponential_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -243,7 +297,7 @@ namespace vle { namespace utils {
         double poisson(double mean)
         {
             boost::poisson_distribution < > distrib(mean);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::poisson_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -257,7 +311,7 @@ namespace vle { namespace utils {
         double gamma(double alpha)
         {
             boost::gamma_distribution < > distrib(alpha);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::gamma_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -272,7 +326,7 @@ namespace vle { namespace utils {
         double binomial(int t, double p)
         {
             boost::binomial_distribution < > distrib(t, p);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::binomial_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -286,7 +340,7 @@ namespace vle { namespace utils {
         double geometric(double p)
         {
             boost::geometric_distribution < > distrib(p);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::geometric_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -301,7 +355,7 @@ namespace vle { namespace utils {
         double cauchy(double median, double sigma)
         {
             boost::cauchy_distribution < > distrib(median, sigma);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::cauchy_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -317,7 +371,7 @@ namespace vle { namespace utils {
         double triangle(double a, double b, double c)
         {
             boost::triangle_distribution < > distrib(a, b, c);
-            boost::variate_generator < boost::mt19937&,
+            boost::variate_generator < Engine&,
                 boost::triangle_distribution < > > gen(m_rand, distrib);
 
             return gen();
@@ -352,7 +406,8 @@ namespace vle { namespace utils {
         double weibull3(const double a, const double b, const double c);
 
         /**
-         * @brief Get a reference to the Mersenne Twister PRNG.
+         * @brief Get a reference to the Mersenne Twister PRNG. Its numbers
+         * are not complemented by an antithetic generator.
          * @code
          * vle::utils::Rand r(123456789);
          * boost::uniform_real < > d(0., 100.); // [0., 100.)
@@ -365,10 +420,10 @@ namespace vle { namespace utils {
          * @endcode
          * @return A reference to the PRNG.
          */
-        boost::mt19937& gen() { return m_rand; }
+        boost::mt19937& gen() { return m_rand.mt; }
 
     private:
-        boost::mt19937  m_rand;
+        Engine          m_rand;
     };
 
 }} // namespace vle utils
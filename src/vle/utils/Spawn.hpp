@@ -91,13 +91,17 @@ public:
      * @param args The arguments of the command.
      * @param waitchildtimeout The timeout while VLE wait for
      * subprocess [0,1000000] .
+     * @param input If true, the standard input of the command is a
+     * pipe filled by the @e put() function, otherwise the command
+     * inherits the standard input of VLE.
      *
      * @return
      */
     bool start(const std::string& exe,
                const std::string& workingdir,
                const std::vector < std::string > &args,
-               unsigned int waitchildtimeout = 50000u);
+               unsigned int waitchildtimeout = 50000u,
+               bool input = false);
 
     /**
      * Wait the process.
@@ -125,7 +129,9 @@ public:
     bool isfinish();
 
     /**
-     * Get the current buffer from pipe.
+     * Get the current buffer from pipe. The buffers written by the
+     * process before its end can be read after @e isfinish() returns
+     * true, until @e output and @e error are empty.
      *
      * @param [out] output
      * @param [out] error
@@ -134,6 +140,43 @@ public:
      */
     bool get(std::string *output, std::string *error);
 
+    /**
+     * Write a buffer to the standard input of the process. The
+     * process must be started with the @e input parameter.
+     *
+     * @attention On Unix, the SIGPIPE signal is blocked in the calling
+     * thread during the write to detect the end of the process with the
+     * return of @e put(), the handler of the signal is not modified.
+     *
+     * @param input The buffer to write.
+     *
+     * @return true if success, false otherwise.
+     */
+    bool put(const std::string& input);
+
+    /**
+     * Close the standard input of the process. The process reads the
+     * end of file.
+     */
+    void closeInput();
+
+    /**
+     * Kill the process if it is running and wait for its end.
+     */
+    void kill();
+
+    /**
+     * Block the calling thread until one of the processes writes into
+     * its standard or error output (or ends) or until the timeout
+     * expires. The outputs are read with @e get(). On Win32, the pipes
+     * cannot be waited and the function sleeps one millisecond.
+     *
+     * @param spawns The processes to wait.
+     * @param milliseconds The timeout.
+     */
+    static void poll(const std::vector < Spawn* >& spawns,
+                     unsigned int milliseconds);
+
     /**
      * Retrieves the status of the ended sub-process. @e status()
      * returns SPAWN_ERROR_NOT_STARTED, SPAWN_ERROR_CHILD or 0 if
@@ -28,6 +28,10 @@
 #include <vle/utils/i18n.hpp>
 #include <sys/wait.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <csignal>
 #include <cerrno>
 #include <cassert>
 #include <cstdio>
@@ -128,31 +132,130 @@ static int input_timeout(int fd, unsigned int microseconds)
     return result;
 }
 
+/**
+ * @e SigpipeBlocker blocks the SIGPIPE signal in the calling thread
+ * while it writes into the pipe of a process which can be ended: the
+ * write fails with EPIPE instead of killing VLE. The SIGPIPE raised by
+ * the write is consumed before the mask of the thread is restored, the
+ * handler of the signal and the other threads are not modified.
+ */
+class SigpipeBlocker
+{
+public:
+    SigpipeBlocker()
+    {
+        sigset_t pending;
+
+        sigemptyset(&m_set);
+        sigaddset(&m_set, SIGPIPE);
+        sigpending(&pending);
+        m_pending = sigismember(&pending, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &m_set, &m_old);
+    }
+
+    ~SigpipeBlocker()
+    {
+        sigset_t pending;
+        int signal;
+
+        sigpending(&pending);
+        if (not m_pending and sigismember(&pending, SIGPIPE)) {
+            sigwait(&m_set, &signal);
+        }
+
+        pthread_sigmask(SIG_SETMASK, &m_old, 0);
+    }
+
+private:
+    sigset_t m_set;
+    sigset_t m_old;
+    bool m_pending;
+};
+
 class Spawn::Pimpl
 {
 public:
     pid_t m_pid;
     unsigned int m_waitchildtimeout;
+    int m_pipein[2];
     int m_pipeout[2];
     int m_pipeerr[2];
     int m_status;
     bool m_finish;
+    bool m_input;
     std::string m_msg;
     std::string m_command;
 
-    Pimpl(unsigned int waitchildtimeout)
+    Pimpl(unsigned int waitchildtimeout, bool input)
         : m_pid(-1), m_waitchildtimeout(waitchildtimeout / 1000.0),
-          m_status(0), m_finish(false)
+          m_status(0), m_finish(false), m_input(input)
     {
+        m_pipein[0] = -1;
+        m_pipein[1] = -1;
+        m_pipeout[0] = -1;
+        m_pipeerr[0] = -1;
     }
 
     ~Pimpl()
     {
+        closeInput();
+
+        if (m_pipeout[0] != -1) {
+            ::close(m_pipeout[0]);
+        }
+
+        if (m_pipeerr[0] != -1) {
+            ::close(m_pipeerr[0]);
+        }
+
         if (not m_finish) {
             wait();
         }
     }
 
+    bool put(const std::string& input)
+    {
+        if (m_pipein[1] == -1) {
+            return false;
+        }
+
+        SigpipeBlocker blocker;
+        std::string::size_type written = 0;
+
+        while (written < input.size()) {
+            ssize_t size = ::write(m_pipein[1], input.data() + written,
+                                   input.size() - written);
+
+            if (size == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return false;
+            }
+
+            written += size;
+        }
+
+        return true;
+    }
+
+    void closeInput()
+    {
+        if (m_pipein[1] != -1) {
+            ::close(m_pipein[1]);
+            m_pipein[1] = -1;
+        }
+    }
+
+    void kill()
+    {
+        if (not m_finish and m_pid > 0) {
+            ::kill(m_pid, SIGKILL);
+            wait();
+        }
+    }
+
     bool is_running()
     {
         assert(not m_finish);
@@ -175,12 +278,10 @@ public:
 
     bool get(std::string *output, std::string *error)
     {
-        if (m_finish) {
-            return false;
+        if (not m_finish) {
+            is_running();
         }
 
-        is_running();
-
         std::vector < char > buffer;
         buffer.reserve(BUFSIZ);
 
@@ -212,6 +313,12 @@ public:
     bool initchild(const std::string& exe,
                    std::vector < std::string > args)
     {
+        if (m_input) {
+            ::dup2(m_pipein[0], STDIN_FILENO);
+            ::close(m_pipein[0]);
+            ::close(m_pipein[1]);
+        }
+
         ::dup2(m_pipeout[1], STDOUT_FILENO);
         ::dup2(m_pipeerr[1], STDERR_FILENO);
 
@@ -235,6 +342,11 @@ public:
 
     bool initparent(pid_t localpid)
     {
+        if (m_input) {
+            ::close(m_pipein[0]);
+            m_pipein[0] = -1;
+        }
+
         ::close(m_pipeout[1]);
         ::close(m_pipeerr[1]);
         m_pid = localpid;
@@ -256,6 +368,18 @@ public:
         pid_t localpid;
         int err;
 
+        if (m_input) {
+            if (::pipe(m_pipein)) {
+                err = errno;
+                goto m_pipein_failed;
+            }
+
+            /* The other processes started by VLE must not inherit the
+               standard input of this process, otherwise, it never
+               reads the end of file. */
+            ::fcntl(m_pipein[1], F_SETFD, FD_CLOEXEC);
+        }
+
         if (::pipe(m_pipeout)) {
             err = errno;
             goto m_pipeout_failed;
@@ -286,10 +410,19 @@ public:
     chdir_failed:
         ::close(m_pipeerr[0]);
         ::close(m_pipeerr[1]);
+        m_pipeerr[0] = -1;
     m_pipeerr_failed:
         ::close(m_pipeout[0]);
         ::close(m_pipeout[1]);
+        m_pipeout[0] = -1;
     m_pipeout_failed:
+        if (m_input) {
+            ::close(m_pipein[0]);
+            ::close(m_pipein[1]);
+            m_pipein[0] = -1;
+            m_pipein[1] = -1;
+        }
+    m_pipein_failed:
         m_msg.assign(strerror(err));
 
         return false;
@@ -353,13 +486,14 @@ Spawn::~Spawn()
 bool Spawn::start(const std::string& exe,
                   const std::string& workingdir,
                   const std::vector < std::string > &args,
-                  unsigned int waitchildtimeout)
+                  unsigned int waitchildtimeout,
+                  bool input)
 {
     if (m_pimpl) {
         delete m_pimpl;
     }
 
-    m_pimpl = new Spawn::Pimpl(waitchildtimeout);
+    m_pimpl = new Spawn::Pimpl(waitchildtimeout, input);
 
     return m_pimpl->start(exe, workingdir, args);
 }
@@ -395,12 +529,66 @@ bool Spawn::isfinish()
 
 bool Spawn::get(std::string *output, std::string *error)
 {
-    if (not m_pimpl or m_pimpl->m_finish)
+    if (not m_pimpl)
         return false;
 
     return m_pimpl->get(output, error);
 }
 
+bool Spawn::put(const std::string& input)
+{
+    if (not m_pimpl or m_pimpl->m_finish)
+        return false;
+
+    return m_pimpl->put(input);
+}
+
+void Spawn::closeInput()
+{
+    if (m_pimpl)
+        m_pimpl->closeInput();
+}
+
+void Spawn::kill()
+{
+    if (m_pimpl)
+        m_pimpl->kill();
+}
+
+void Spawn::poll(const std::vector < Spawn* >& spawns,
+                 unsigned int milliseconds)
+{
+    std::vector < struct pollfd > fds;
+
+    for (std::vector < Spawn* >::const_iterator it = spawns.begin();
+         it != spawns.end(); ++it) {
+        if (not (*it)->m_pimpl) {
+            continue;
+        }
+
+        int pipes[2] = { (*it)->m_pimpl->m_pipeout[0],
+                         (*it)->m_pimpl->m_pipeerr[0] };
+
+        for (int i = 0; i < 2; ++i) {
+            if (pipes[i] != -1) {
+                struct pollfd fd;
+                fd.fd = pipes[i];
+                fd.events = POLLIN;
+                fd.revents = 0;
+                fds.push_back(fd);
+            }
+        }
+    }
+
+    if (fds.empty()) {
+        return;
+    }
+
+    while (::poll(&fds[0], fds.size(), milliseconds) == -1 and
+           errno == EINTR) {
+    }
+}
+
 bool Spawn::status(std::string *msg, bool *success)
 {
     if (not m_pimpl or not m_pimpl->m_finish)
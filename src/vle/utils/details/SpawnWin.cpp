@@ -326,6 +326,7 @@ static char * prepare_environment_variable(void)
 
 struct Spawn::Pimpl
 {
+    HANDLE hInputWrite;
     HANDLE hOutputRead;
     HANDLE hErrorRead;
 
@@ -334,21 +335,64 @@ struct Spawn::Pimpl
     std::string         m_msg;
     unsigned int        m_waitchildtimeout;
     bool                m_finish;
+    bool                m_input;
 
     std::ofstream out__, err__;
 
 
-    Pimpl(unsigned int waitchildtimeout)
-        : hOutputRead(INVALID_HANDLE_VALUE),
+    Pimpl(unsigned int waitchildtimeout, bool input)
+        : hInputWrite(INVALID_HANDLE_VALUE),
+          hOutputRead(INVALID_HANDLE_VALUE),
           hErrorRead(INVALID_HANDLE_VALUE),
           m_status(0), m_waitchildtimeout(waitchildtimeout),
-          m_finish(false), out__("c:/out.txt"), err__("c:/err.txt")
+          m_finish(false), m_input(input), out__("c:/out.txt"),
+          err__("c:/err.txt")
     {
     }
 
     ~Pimpl()
+    {
+        closeInput();
+
+        if (not m_finish) {
+            wait();
+        }
+    }
+
+    bool put(const std::string& input)
+    {
+        if (hInputWrite == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        std::string::size_type written = 0;
+
+        while (written < input.size()) {
+            DWORD size;
+
+            if (!WriteFile(hInputWrite, input.data() + written,
+                           input.size() - written, &size, NULL)) {
+                return false;
+            }
+
+            written += size;
+        }
+
+        return true;
+    }
+
+    void closeInput()
+    {
+        if (hInputWrite != INVALID_HANDLE_VALUE) {
+            CloseHandle(hInputWrite);
+            hInputWrite = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    void kill()
     {
         if (not m_finish) {
+            TerminateProcess(m_pi.hProcess, 1);
             wait();
         }
     }
@@ -371,11 +415,13 @@ struct Spawn::Pimpl
 
     bool get(std::string *output, std::string *error)
     {
-        if (m_finish) {
+        if (hOutputRead == INVALID_HANDLE_VALUE) {
             return false;
         }
 
-        is_running();
+        if (not m_finish) {
+            is_running();
+        }
 
         std::vector < char > buffer(4096, '\0');
         unsigned long bread;
@@ -480,6 +526,8 @@ struct Spawn::Pimpl
                const std::string& workingdir,
                const std::vector < std::string > &args)
     {
+        HANDLE hInputRead = INVALID_HANDLE_VALUE;
+        HANDLE hInputWriteTmp = INVALID_HANDLE_VALUE;
         HANDLE hOutputReadTmp = INVALID_HANDLE_VALUE;
         HANDLE hErrorReadTmp = INVALID_HANDLE_VALUE;
         HANDLE hOutputWrite = INVALID_HANDLE_VALUE;
@@ -498,6 +546,16 @@ struct Spawn::Pimpl
         securityatt.nLength = sizeof(SECURITY_ATTRIBUTES);
         securityatt.bInheritHandle = TRUE;
 
+        if (m_input) {
+            if (!CreatePipe(&hInputRead, &hInputWriteTmp, &securityatt, 0) ||
+                !DuplicateHandle(GetCurrentProcess(), hInputWriteTmp,
+                                 GetCurrentProcess(), &hInputWrite, 0,
+                                 FALSE, DUPLICATE_SAME_ACCESS))
+                goto pipe_in_failure;
+
+            CloseHandle(hInputWriteTmp);
+        }
+
         if (!CreatePipe(&hOutputReadTmp, &hOutputWrite, &securityatt, 0) ||
             !DuplicateHandle(GetCurrentProcess(), hOutputReadTmp,
                              GetCurrentProcess(), &hOutputRead, 0,
@@ -517,7 +575,8 @@ struct Spawn::Pimpl
         startupinfo.cb = sizeof(STARTUPINFO);
         startupinfo.dwFlags = STARTF_USESTDHANDLES | STARTF_USESHOWWINDOW;
         startupinfo.hStdOutput = hOutputWrite;
-        startupinfo.hStdInput  = GetStdHandle(STD_INPUT_HANDLE);
+        startupinfo.hStdInput  = m_input ? hInputRead :
+            GetStdHandle(STD_INPUT_HANDLE);
         startupinfo.hStdError = hErrorWrite;
         startupinfo.wShowWindow = SW_SHOWDEFAULT;
 
@@ -544,6 +603,10 @@ struct Spawn::Pimpl
         CloseHandle(hOutputWrite);
         CloseHandle(hErrorWrite);
 
+        if (m_input) {
+            CloseHandle(hInputRead);
+        }
+
         Sleep(25);
 
         out__ << "CreateProcess success\n";
@@ -565,6 +628,12 @@ struct Spawn::Pimpl
         CloseHandle(hOutputWrite);
 
     pipe_out_failure:
+        if (m_input) {
+            CloseHandle(hInputRead);
+            closeInput();
+        }
+
+    pipe_in_failure:
         return false;
     }
 
@@ -579,6 +648,8 @@ struct Spawn::Pimpl
 
                 CloseHandle(hErrorRead);
                 CloseHandle(hOutputRead);
+                hErrorRead = INVALID_HANDLE_VALUE;
+                hOutputRead = INVALID_HANDLE_VALUE;
 
                 CloseHandle(m_pi.hThread);
                 CloseHandle(m_pi.hProcess);
@@ -617,13 +688,14 @@ Spawn::~Spawn()
 bool Spawn::start(const std::string& exe,
                   const std::string& workingdir,
                   const std::vector < std::string > &args,
-                  unsigned int waitchildtimeout)
+                  unsigned int waitchildtimeout,
+                  bool input)
 {
     if (m_pimpl) {
         delete m_pimpl;
     }
 
-    m_pimpl = new Spawn::Pimpl(waitchildtimeout);
+    m_pimpl = new Spawn::Pimpl(waitchildtimeout, input);
 
     return m_pimpl->start(exe, workingdir, args);
 }
@@ -660,6 +732,35 @@ bool Spawn::get(std::string *output, std::string *error)
     return m_pimpl->get(output, error);
 }
 
+bool Spawn::put(const std::string& input)
+{
+    if (not m_pimpl or m_pimpl->m_finish)
+        return false;
+
+    return m_pimpl->put(input);
+}
+
+void Spawn::closeInput()
+{
+    if (m_pimpl)
+        m_pimpl->closeInput();
+}
+
+void Spawn::kill()
+{
+    if (m_pimpl)
+        m_pimpl->kill();
+}
+
+void Spawn::poll(const std::vector < Spawn* >& spawns,
+                 unsigned int milliseconds)
+{
+    /* The anonymous pipes cannot be waited, the function sleeps. */
+    if (not spawns.empty()) {
+        Sleep(std::min(milliseconds, 1u));
+    }
+}
+
 bool Spawn::status(std::string *msg, bool *success)
 {
     if (not m_pimpl or not m_pimpl->m_finish)
@@ -0,0 +1,140 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_UTILS_DETAILS_TOOLS_HPP
+#define VLE_UTILS_DETAILS_TOOLS_HPP
+
+#include <vle/vpz/Condition.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/Types.hpp>
+#include <string>
+
+/*
+ * The internal helpers shared by the random streams of the models, the
+ * designs of experiments and the experiment-level conditions of the
+ * manager. This header is not installed.
+ */
+
+namespace vle { namespace utils {
+
+/**
+ * The finalizer of SplitMix64: a counter based random number generator.
+ * The numbers are well spread, even for close inputs, and a number is
+ * computed without the previous ones.
+ *
+ * @param x The value to mix.
+ *
+ * @return The mixed value.
+ */
+inline uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Get the only value of a port of a condition.
+ *
+ * @param condition The condition.
+ * @param port The port.
+ * @param owner The name of the reader, used in the error messages.
+ *
+ * @return The value.
+ * @throw utils::ArgError if the port has no value or several values.
+ */
+inline const value::Value * getPortValue(const vpz::Condition& condition,
+                                         const std::string& port,
+                                         const std::string& owner)
+{
+    const value::Set& values(condition.getSetValues(port));
+
+    if (values.size() != 1 or not values.get(0)) {
+        throw utils::ArgError(
+            fmt(_("%1%: the port `%2%' must have one value")) % owner % port);
+    }
+
+    return values.get(0);
+}
+
+/**
+ * Get the only value of a port of a condition as a positive integer.
+ *
+ * @param condition The condition.
+ * @param port The port.
+ * @param owner The name of the reader, used in the error messages.
+ *
+ * @return The value.
+ * @throw utils::ArgError if the value is not a positive integer.
+ */
+inline uint64_t toPortUnsigned(const vpz::Condition& condition,
+                               const std::string& port,
+                               const std::string& owner)
+{
+    const value::Value *value = getPortValue(condition, port, owner);
+
+    if (not value->isInteger() or value->toInteger().value() < 0) {
+        throw utils::ArgError(
+            fmt(_("%1%: the port `%2%' must be a positive integer"))
+            % owner % port);
+    }
+
+    return value->toInteger().value();
+}
+
+/**
+ * Get the only value of a port of a condition as a boolean.
+ *
+ * @param condition The condition.
+ * @param port The port.
+ * @param owner The name of the reader, used in the error messages.
+ *
+ * @return The value.
+ * @throw utils::ArgError if the value is not a boolean.
+ */
+inline bool toPortBoolean(const vpz::Condition& condition,
+                          const std::string& port,
+                          const std::string& owner)
+{
+    const value::Value *value = getPortValue(condition, port, owner);
+
+    if (not value->isBoolean()) {
+        throw utils::ArgError(
+            fmt(_("%1%: the port `%2%' must be a boolean")) % owner % port);
+    }
+
+    return value->toBoolean().value();
+}
+
+}} // namespace vle utils
+
+#endif
@@ -248,6 +248,28 @@ BOOST_AUTO_TEST_CASE(test_normal)
                         (double)szmax, 1.0, 10);
 }
 
+BOOST_AUTO_TEST_CASE(test_antithetic)
+{
+    vle::utils::Rand r(123456789), a(123456789);
+
+    a.setAntithetic(true);
+    BOOST_REQUIRE(a.antithetic());
+    BOOST_REQUIRE(not r.antithetic());
+
+    for (int i = 0; i < 1000; ++i) {
+        BOOST_REQUIRE_SMALL(r.getDouble() + a.getDouble() - 1.0, 1e-9);
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        BOOST_REQUIRE_EQUAL(r.getInt(0, 9) + a.getInt(0, 9), 9);
+    }
+
+    a.seed(123456789);
+    a.setAntithetic(false);
+    r.seed(123456789);
+    BOOST_REQUIRE_EQUAL(r.getInt(), a.getInt());
+}
+
 BOOST_AUTO_TEST_CASE(date_time)
 {
     BOOST_REQUIRE_EQUAL(vle::utils::DateTime::year((2451545)),
@@ -0,0 +1,304 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/value/Binary.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/XML.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <memory>
+#include <cstring>
+
+namespace vle { namespace value {
+
+/*
+ * The tag of a null pointer. The other tags are the Value::type.
+ */
+static const unsigned char BINARY_NULL_POINTER = 0xff;
+
+template < typename T >
+static void put(const T& value, std::string *output)
+{
+    output->append(reinterpret_cast < const char* >(&value), sizeof(T));
+}
+
+static void putSize(std::string::size_type size, std::string *output)
+{
+    put < uint32_t >(static_cast < uint32_t >(size), output);
+}
+
+static void putString(const std::string& str, std::string *output)
+{
+    putSize(str.size(), output);
+    output->append(str);
+}
+
+static void putReals(const double *reals, std::string::size_type size,
+                     std::string *output)
+{
+    output->append(reinterpret_cast < const char* >(reals),
+                   size * sizeof(double));
+}
+
+static void require(const std::string& input, std::string::size_type position,
+                    std::string::size_type size)
+{
+    if (position > input.size() or input.size() - position < size) {
+        throw utils::ArgError(
+            fmt(_("Binary value: truncated buffer (%1% bytes needed at"
+                  " %2%, %3% available)")) % size % position % input.size());
+    }
+}
+
+template < typename T >
+static T get(const std::string& input, std::string::size_type *position)
+{
+    T value;
+
+    require(input, *position, sizeof(T));
+    std::memcpy(&value, input.data() + *position, sizeof(T));
+    *position += sizeof(T);
+
+    return value;
+}
+
+static uint32_t getSize(const std::string& input,
+                        std::string::size_type *position)
+{
+    return get < uint32_t >(input, position);
+}
+
+static std::string getString(const std::string& input,
+                             std::string::size_type *position)
+{
+    uint32_t size = getSize(input, position);
+
+    require(input, *position, size);
+    std::string result(input, *position, size);
+    *position += size;
+
+    return result;
+}
+
+static void getReals(const std::string& input,
+                     std::string::size_type *position,
+                     double *reals, std::string::size_type size)
+{
+    require(input, *position, size * sizeof(double));
+    std::memcpy(reals, input.data() + *position, size * sizeof(double));
+    *position += size * sizeof(double);
+}
+
+void writeBinary(const Value *value, std::string *output)
+{
+    if (not value) {
+        put < unsigned char >(BINARY_NULL_POINTER, output);
+        return;
+    }
+
+    put < unsigned char >(static_cast < unsigned char >(value->getType()),
+                          output);
+
+    switch (value->getType()) {
+    case Value::BOOLEAN:
+        put < unsigned char >(value->toBoolean().value() ? 1 : 0, output);
+        break;
+    case Value::INTEGER:
+        put < int32_t >(value->toInteger().value(), output);
+        break;
+    case Value::DOUBLE:
+        put < double >(value->toDouble().value(), output);
+        break;
+    case Value::STRING:
+        putString(value->toString().value(), output);
+        break;
+    case Value::XMLTYPE:
+        putString(value->toXml().value(), output);
+        break;
+    case Value::NIL:
+        break;
+    case Value::SET: {
+        const VectorValue& vec = value->toSet().value();
+
+        putSize(vec.size(), output);
+        for (VectorValue::const_iterator it = vec.begin(); it != vec.end();
+             ++it) {
+            writeBinary(*it, output);
+        }
+        break;
+    }
+    case Value::MAP: {
+        const MapValue& map = value->toMap().value();
+
+        putSize(map.size(), output);
+        for (MapValue::const_iterator it = map.begin(); it != map.end();
+             ++it) {
+            putString(it->first, output);
+            writeBinary(it->second, output);
+        }
+        break;
+    }
+    case Value::TUPLE: {
+        const TupleValue& tuple = value->toTuple().value();
+
+        putSize(tuple.size(), output);
+        if (not tuple.empty()) {
+            putReals(&tuple[0], tuple.size(), output);
+        }
+        break;
+    }
+    case Value::TABLE: {
+        const Table& table = value->toTable();
+
+        putSize(table.width(), output);
+        putSize(table.height(), output);
+        for (Table::index i = 0; i < table.width(); ++i) {
+            for (Table::index j = 0; j < table.height(); ++j) {
+                put < double >(table.get(i, j), output);
+            }
+        }
+        break;
+    }
+    case Value::MATRIX: {
+        const Matrix& matrix = value->toMatrix();
+
+        putSize(matrix.columns(), output);
+        putSize(matrix.rows(), output);
+        putSize(matrix.matrix().shape()[0], output);
+        putSize(matrix.matrix().shape()[1], output);
+        putSize(matrix.resizeColumn(), output);
+        putSize(matrix.resizeRow(), output);
+        for (Matrix::size_type j = 0; j < matrix.rows(); ++j) {
+            for (Matrix::size_type i = 0; i < matrix.columns(); ++i) {
+                writeBinary(matrix.matrix()[i][j], output);
+            }
+        }
+        break;
+    }
+    case Value::USER:
+    default:
+        throw utils::ArgError(
+            _("Binary value: the value::User can not be written"));
+    }
+}
+
+Value* readBinary(const std::string& input, std::string::size_type *position)
+{
+    unsigned char tag = get < unsigned char >(input, position);
+
+    if (tag == BINARY_NULL_POINTER) {
+        return 0;
+    }
+
+    switch (tag) {
+    case Value::BOOLEAN:
+        return Boolean::create(get < unsigned char >(input, position) != 0);
+    case Value::INTEGER:
+        return Integer::create(get < int32_t >(input, position));
+    case Value::DOUBLE:
+        return Double::create(get < double >(input, position));
+    case Value::STRING:
+        return String::create(getString(input, position));
+    case Value::XMLTYPE:
+        return Xml::create(getString(input, position));
+    case Value::NIL:
+        return Null::create();
+    case Value::SET: {
+        uint32_t size = getSize(input, position);
+        std::auto_ptr < Set > result(Set::create());
+
+        for (uint32_t i = 0; i < size; ++i) {
+            result->add(readBinary(input, position));
+        }
+        return result.release();
+    }
+    case Value::MAP: {
+        uint32_t size = getSize(input, position);
+        std::auto_ptr < Map > result(Map::create());
+
+        for (uint32_t i = 0; i < size; ++i) {
+            std::string name = getString(input, position);
+            result->add(name, readBinary(input, position));
+        }
+        return result.release();
+    }
+    case Value::TUPLE: {
+        uint32_t size = getSize(input, position);
+        std::auto_ptr < Tuple > result(new Tuple(size));
+
+        if (size) {
+            getReals(input, position, &result->value()[0], size);
+        }
+        return result.release();
+    }
+    case Value::TABLE: {
+        uint32_t width = getSize(input, position);
+        uint32_t height = getSize(input, position);
+        std::auto_ptr < Table > result(new Table(width, height));
+
+        for (uint32_t i = 0; i < width; ++i) {
+            for (uint32_t j = 0; j < height; ++j) {
+                result->get(i, j) = get < double >(input, position);
+            }
+        }
+        return result.release();
+    }
+    case Value::MATRIX: {
+        uint32_t columns = getSize(input, position);
+        uint32_t rows = getSize(input, position);
+        uint32_t columnmax = getSize(input, position);
+        uint32_t rowmax = getSize(input, position);
+        uint32_t stepcolumn = getSize(input, position);
+        uint32_t steprow = getSize(input, position);
+        std::auto_ptr < Matrix > result(
+            new Matrix(columns, rows, columnmax, rowmax, stepcolumn,
+                       steprow));
+
+        for (uint32_t j = 0; j < rows; ++j) {
+            for (uint32_t i = 0; i < columns; ++i) {
+                result->set(i, j, readBinary(input, position));
+            }
+        }
+        return result.release();
+    }
+    default:
+        throw utils::ArgError(
+            fmt(_("Binary value: unknown type %1% at %2%")) %
+            static_cast < unsigned int >(tag) % (*position - 1));
+    }
+}
+
+}} // namespace vle value
@@ -0,0 +1,75 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2014 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2014 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_VALUE_BINARY_HPP
+#define VLE_VALUE_BINARY_HPP 1
+
+#include <vle/value/Value.hpp>
+#include <vle/DllDefines.hpp>
+#include <string>
+
+namespace vle { namespace value {
+
+/**
+ * @brief Append the binary representation of a value to a buffer.
+ *
+ * The binary representation is compact and fast to read and write but,
+ * unlike the XML representation, it is not portable: integers and reals
+ * use the byte order of the host. It is intended to exchange values
+ * between processes of the same host. A null pointer is a valid value.
+ *
+ * @code
+ * std::string buffer;
+ * value::writeBinary(map, &buffer);
+ *
+ * std::string::size_type position = 0;
+ * value::Value *copy = value::readBinary(buffer, &position);
+ * @endcode
+ *
+ * @param value The value to write (can be null).
+ * @param[out] output The buffer to append the binary representation.
+ * @throw utils::ArgError if the value or one of its children is a
+ * value::User.
+ */
+VLE_API void writeBinary(const Value *value, std::string *output);
+
+/**
+ * @brief Build a value from its binary representation.
+ *
+ * @param input The buffer which contains the binary representation.
+ * @param[in,out] position The position of the value in the buffer,
+ * updated to the position of the next value.
+ *
+ * @return A new allocated value or null.
+ * @throw utils::ArgError if the buffer is truncated or corrupted.
+ */
+VLE_API Value* readBinary(const std::string &input,
+                          std::string::size_type *position);
+
+}} // namespace vle value
+
+#endif
@@ -37,8 +37,10 @@
 #include <stdexcept>
 #include <limits>
 #include <fstream>
+#include <sstream>
 #include <functional>
 #include <vle/value/Value.hpp>
+#include <vle/value/Binary.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
@@ -52,6 +54,7 @@
 #include <vle/value/User.hpp>
 #include <vle/value/Value.hpp>
 #include <vle/value/XML.hpp>
+#include <vle/utils/Exception.hpp>
 #include <vle/vle.hpp>
 
 struct F
@@ -332,3 +335,54 @@ BOOST_AUTO_TEST_CASE(test_user_value)
     delete data;
     delete cloned_data;
 }
+
+BOOST_AUTO_TEST_CASE(test_binary_value)
+{
+    value::Map map;
+    map.addBoolean("boolean", true);
+    map.addInt("integer", -12);
+    map.addDouble("double", 0.125);
+    map.addString("string", "vle");
+    map.add("null", value::Null::create());
+
+    value::Set *set = value::Set::create();
+    set->addInt(1);
+    set->addString("a");
+    map.add("set", set);
+
+    value::Tuple *tuple = value::Tuple::create(3, 1.5);
+    map.add("tuple", tuple);
+
+    value::Table *table = value::Table::create(2, 3);
+    table->get(1, 2) = 4.0;
+    map.add("table", table);
+
+    value::Matrix *matrix = value::Matrix::create(2, 2, 4, 4, 2, 2);
+    matrix->addDouble(0, 0, 1.0);
+    matrix->addString(1, 1, "x");
+    map.add("matrix", matrix);
+
+    std::string buffer;
+    value::writeBinary(&map, &buffer);
+    value::writeBinary(0, &buffer);
+
+    std::string::size_type position = 0;
+    value::Value *result = value::readBinary(buffer, &position);
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(not value::readBinary(buffer, &position));
+    BOOST_REQUIRE_EQUAL(position, buffer.size());
+
+    std::ostringstream expected, obtained;
+    map.writeXml(expected);
+    result->writeXml(obtained);
+    BOOST_REQUIRE_EQUAL(expected.str(), obtained.str());
+    delete result;
+
+    position = 0;
+    buffer.resize(buffer.size() / 2);
+    BOOST_REQUIRE_THROW(value::readBinary(buffer, &position),
+                        utils::ArgError);
+
+    test::MyData data(1., 2., 3., "test-vle");
+    BOOST_REQUIRE_THROW(value::writeBinary(&data, &buffer), utils::ArgError);
+}
@@ -41,20 +41,32 @@ Condition::Condition(const std::string& name) :
 
 Condition::Condition(const Condition& cnd) :
     Base(cnd),
+    m_list(cnd.m_list),
     m_name(cnd.m_name),
     m_last_port(cnd.m_last_port),
     m_ispermanent(cnd.m_ispermanent)
 {
-    for (ConditionValues::const_iterator it = cnd.m_list.begin();
-         it != cnd.m_list.end(); ++it) {
-        m_list[it->first] = dynamic_cast < value::Set*>(it->second->clone());
-    }
 }
 
 Condition::~Condition()
+{
+}
+
+value::Set& Condition::detach(iterator it)
+{
+    assert(it->second);
+
+    if (not it->second.unique()) {
+        it->second.reset(new value::Set(*it->second));
+    }
+
+    return *it->second;
+}
+
+void Condition::detach()
 {
     for (iterator it = m_list.begin(); it != m_list.end(); ++it) {
-        delete it->second;
+        detach(it);
     }
 }
 
@@ -90,7 +102,8 @@ void Condition::portnames(std::list < std::string >& lst) const
 
 void Condition::add(const std::string& portname)
 {
-    m_list.insert(value_type(portname, value::Set::create()));
+    m_list.insert(value_type(portname,
+                             ConditionValueSet(value::Set::create())));
     m_last_port.assign(portname);
 }
 
@@ -120,10 +133,10 @@ void Condition::addValueToPort(const std::string& portname,
         value::Set* newset = value::Set::create();
         newset->add(value);
 
-        m_list.insert(value_type(portname, newset));
+        m_list.insert(value_type(portname, ConditionValueSet(newset)));
         m_last_port.assign(portname);
     } else {
-        it->second->add(value);
+        detach(it).add(value);
     }
 }
 
@@ -136,10 +149,10 @@ void Condition::addValueToPort(const std::string& portname,
         value::Set* newset = value::Set::create();
         newset->add(value);
 
-        m_list.insert(value_type(portname, newset));
+        m_list.insert(value_type(portname, ConditionValueSet(newset)));
         m_last_port.assign(portname);
     } else {
-        it->second->add(value);
+        detach(it).add(value);
     }
 }
 
@@ -153,8 +166,9 @@ void Condition::setValueToPort(const std::string& portname,
                 _("Condition %1% have no port %2%")) % m_name % portname);
     }
 
-    it->second->clear();
-    it->second->add(value);
+    value::Set& values(detach(it));
+    values.clear();
+    values.add(value);
 }
 
 void Condition::clearValueOfPort(const std::string& portname)
@@ -166,7 +180,7 @@ void Condition::clearValueOfPort(const std::string& portname)
                 _("Condition %1% have no port %2%")) % m_name % portname);
     }
 
-    it->second->clear();
+    detach(it).clear();
 }
 
 void Condition::fillWithFirstValues(value::MapValue& mapToFill) const
@@ -203,8 +217,15 @@ value::Set& Condition::getSetValues(const std::string& portname)
                               % portname);
     }
 
-    assert(it->second);
-    return *it->second;
+    return detach(it);
+}
+
+void Condition::setSetValues(const std::string& portname,
+                             const ConditionValueSet& values)
+{
+    assert(values);
+
+    m_list[portname] = values;
 }
 
 const value::Value& Condition::firstValue(const std::string& portname) const
@@ -227,8 +248,7 @@ value::Set& Condition::lastAddedPort()
                               % m_last_port);
     }
 
-    assert(it->second);
-    return *it->second;
+    return detach(it);
 }
 
 
@@ -236,7 +256,11 @@ void Condition::deleteValueSet()
 {
     for (ConditionValues::iterator it = m_list.begin(); it != m_list.end();
          ++it) {
-        it->second->clear();
+        if (it->second.unique()) {
+            it->second->clear();
+        } else {
+            it->second.reset(value::Set::create());
+        }
     }
 }
 
@@ -32,20 +32,40 @@
 #include <vle/DllDefines.hpp>
 #include <vle/value/Map.hpp>
 #include <vle/value/Set.hpp>
+#include <boost/shared_ptr.hpp>
 #include <string>
 #include <map>
 #include <list>
 
 namespace vle { namespace vpz {
 
+    /**
+     * @brief Define the values of a port. The value::Set is shared by the
+     * copies of a Condition.
+     */
+    typedef boost::shared_ptr < value::Set > ConditionValueSet;
+
     /**
      * @brief Define the ConditionValues like a dictionnary, (portname, values).
      */
-    typedef std::map < std::string, value::Set* > ConditionValues;
+    typedef std::map < std::string, ConditionValueSet > ConditionValues;
 
     /**
      * @brief A condition define a couple model name, port name and a Value.
      * This class allow loading and writing a condition.
+     *
+     * The value::Set of the ports are shared between the copies of a
+     * Condition (copy-on-write): the copy of a Condition does not clone the
+     * values, a value::Set is cloned only by the non-constant functions,
+     * when it is shared. The references and the iterators to the values
+     * of a Condition are invalidated as follows:
+     * - after a copy of the Condition, a reference returned before by a
+     *   non-constant function (getSetValues, lastAddedPort,
+     *   conditionvalues, begin, end) modifies the values of the Condition
+     *   and of the copy. Get the reference again after the copy.
+     * - after a non-constant function, a reference returned before by a
+     *   constant function to a shared value::Set refers to the values of
+     *   the copies, not to the values of the Condition.
      */
     class VLE_API Condition : public Base
     {
@@ -62,13 +82,13 @@ namespace vle { namespace vpz {
         Condition(const std::string& name);
 
         /**
-         * @brief Copy constructor. All values are cloned.
+         * @brief Copy constructor. The values are shared, not cloned.
          * @param cnd The Condition to copy.
          */
         Condition(const Condition& cnd);
 
         /**
-         * @brief Delete all the values attached to this Conditon.
+         * @brief Release all the values attached to this Conditon.
          */
         virtual ~Condition();
 
@@ -178,13 +198,24 @@ namespace vle { namespace vpz {
         const value::Set& getSetValues(const std::string& portname) const;
 
         /**
-         * @brief Get the value::Set attached to a port.
+         * @brief Get the value::Set attached to a port. The value::Set is
+         * cloned if it is shared. The reference must not be used after a
+         * copy of the Condition.
          * @param portname The name of the port.
          * @return A reference to a value::Set.
          * @throw utils::ArgError if portname not exist.
          */
         value::Set& getSetValues(const std::string& portname);
 
+        /**
+         * @brief Assign the value::Set of a port. The value::Set is shared,
+         * not cloned. If the port does not exist, it is created.
+         * @param portname The name of the port.
+         * @param values The new values of the port.
+         */
+        void setSetValues(const std::string& portname,
+                          const ConditionValueSet& values);
+
         /**
          * @brief Return a reference to the first value::Value of the specified
          * port.
@@ -234,25 +265,28 @@ namespace vle { namespace vpz {
         { return m_list; }
 
         /**
-         * @brief Get a reference to the ConditionValues.
+         * @brief Get a reference to the ConditionValues. The shared
+         * value::Set are cloned.
          * @return A constant reference to the ConditionValues.
          */
         inline ConditionValues& conditionvalues()
-        { return m_list; }
+        { detach(); return m_list; }
 
         /**
-         * @brief Get a iterator the begin of the vpz::ConditionValues.
+         * @brief Get a iterator the begin of the vpz::ConditionValues. The
+         * shared value::Set are cloned.
          * @return Get a iterator the begin of the vpz::ConditionValues.
          */
         iterator begin()
-        { return m_list.begin(); }
+        { detach(); return m_list.begin(); }
 
         /**
-         * @brief Get a iterator the end of the vpz::ConditionValues.
+         * @brief Get a iterator the end of the vpz::ConditionValues. The
+         * shared value::Set are cloned.
          * @return Get a iterator the end of the vpz::ConditionValues.
          */
         iterator end()
-        { return m_list.end(); }
+        { detach(); return m_list.end(); }
 
         /**
          * @brief Get a constant iterator the begin of the vpz::ConditionValues.
@@ -344,6 +378,19 @@ namespace vle { namespace vpz {
     private:
         Condition();
 
+        /**
+         * @brief Clone the value::Set of the port if it is shared with
+         * another Condition.
+         * @param it The port to detach.
+         * @return A reference to the value::Set owned by this Condition.
+         */
+        value::Set& detach(iterator it);
+
+        /**
+         * @brief Clone all the shared value::Set.
+         */
+        void detach();
+
         ConditionValues         m_list;         /* list of port, values. */
         std::string             m_name;         /* name of the condition. */
         std::string             m_last_port;    /* latest added port. */
@@ -31,12 +31,13 @@
 namespace vle { namespace vpz {
 
 Output::Output()
-    : m_format(LOCAL), m_data(0)
+    : m_format(LOCAL), m_asynchronous(false), m_data(0)
 {
 }
 
 Output::Output(const Output& output)
-    : Base(output), m_format(output.m_format), m_name(output.m_name),
+    : Base(output), m_format(output.m_format),
+    m_asynchronous(output.m_asynchronous), m_name(output.m_name),
     m_plugin(output.m_plugin), m_location(output.m_location),
     m_package(output.m_package)
 {
@@ -62,6 +63,7 @@ Output::~Output()
 void Output::swap(Output& output)
 {
     std::swap(m_format, output.m_format);
+    std::swap(m_asynchronous, output.m_asynchronous);
     std::swap(m_name, output.m_name);
     std::swap(m_plugin, output.m_plugin);
     std::swap(m_location, output.m_location);
@@ -85,10 +87,13 @@ void Output::write(std::ostream& out) const
     }
 
     if (not m_package.empty()) {
-        out << " package=\"" << m_package.c_str() << "\" ";
+        out << " package=\"" << m_package.c_str() << "\"";
     }
 
     out << " plugin=\"" << m_plugin.c_str() << "\" ";
+    if (m_asynchronous) {
+        out << "asynchronous=\"true\" ";
+    }
 
     if (m_data) {
         out << ">\n";
@@ -185,7 +190,9 @@ void Output::clearData()
 
 bool Output::operator==(const Output& output) const
 {
-    return m_format == output.format() and m_name == output.name()
+    return m_format == output.format()
+        and m_asynchronous == output.asynchronous()
+        and m_name == output.name()
         and m_plugin == output.plugin() and m_location == output.location()
         and m_package == output.package() and m_data == output.data();
 
@@ -97,6 +97,8 @@ namespace vle {
          * <output name="name" location="/tmp" plugin="text" />
          *  <![CDATA[ bla bla bla ]]>
          * </output>
+         * <output name="name" location="/tmp" format="local" plugin="text"
+         *         asynchronous="true" />
          * @endcode
          * @param out The output stream.
          */
@@ -204,6 +206,23 @@ namespace vle {
         std::string streamformat() const
         { return (m_format == LOCAL ? "local" : "distant"); }
 
+        /**
+         * @brief Get the asynchronous mode of this Output.
+         * @return true if the observations are sent to the plug-in by a
+         * dedicated writer thread, false if the plug-in is called by the
+         * simulation kernel.
+         */
+        bool asynchronous() const
+        { return m_asynchronous; }
+
+        /**
+         * @brief Set the asynchronous mode of this Output.
+         * @param asynchronous true to send the observations to the plug-in
+         * with a dedicated writer thread.
+         */
+        void setAsynchronous(bool asynchronous)
+        { m_asynchronous = asynchronous; }
+
         /**
          * @brief Get the plugin of this Output.
          * @return a string representation of plugin.
@@ -255,6 +274,7 @@ namespace vle {
 
     private:
         Format          m_format;
+        bool            m_asynchronous;
         std::string     m_name;
         std::string     m_plugin;
         std::string     m_location;
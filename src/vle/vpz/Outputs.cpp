@@ -151,6 +151,8 @@ void Outputs::rename(const std::string& oldoutputname,
                          copy.package());
         break;
     }
+
+    get(newoutputname).setAsynchronous(copy.asynchronous());
 }
 
 std::set < std::string > Outputs::depends() const
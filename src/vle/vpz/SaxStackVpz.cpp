@@ -644,10 +644,13 @@ void SaxStackVpz::pushOutput(const xmlChar** att)
     const xmlChar* plugin = 0;
     const xmlChar* location = 0;
     const xmlChar* package = 0;
+    const xmlChar* asynchronous = 0;
 
     for (int i = 0; att[i] != 0; i += 2) {
         if (xmlStrcmp(att[i], (const xmlChar*)"name") == 0) {
             name = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"asynchronous") == 0) {
+            asynchronous = att[i + 1];
         } else if (xmlStrcmp(att[i], (const xmlChar*)"format") == 0) {
             format = att[i + 1];
         } else if (xmlStrcmp(att[i], (const xmlChar*)"plugin") == 0) {
@@ -660,25 +663,30 @@ void SaxStackVpz::pushOutput(const xmlChar** att)
     }
 
     Outputs& outs(m_vpz.project().experiment().views().outputs());
+    Output* result = 0;
 
     if (xmlStrcmp(format, (const xmlChar*)"local") == 0) {
-        Output& result = outs.addLocalStream(
+        result = &outs.addLocalStream(
             xmlCharToString(name),
             location ? xmlCharToString(location) : std::string(),
             xmlCharToString(plugin),
             package ? xmlCharToString(package) : std::string());
-        push(&result);
     } else if (xmlStrcmp(format, (const xmlChar*)"distant") == 0) {
-        Output& result = outs.addDistantStream(
+        result = &outs.addDistantStream(
             xmlCharToString(name),
             location ? xmlCharToString(location) : std::string(),
             xmlCharToString(plugin),
             package ? xmlCharToString(package) : std::string());
-        push(&result);
     } else {
         throw utils::SaxParserError(fmt(
                 _("Output tag does not define a '%1%' format")) % name);
     }
+
+    if (asynchronous) {
+        result->setAsynchronous(xmlCharToBoolean(asynchronous));
+    }
+
+    push(result);
 }
 
 void SaxStackVpz::pushView(const xmlChar** att)
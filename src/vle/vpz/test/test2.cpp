@@ -329,7 +329,8 @@ BOOST_AUTO_TEST_CASE(experiment_measures_vpz)
         "     <string>test</string>"
         "    </output>\n"
         "    <output name=\"z\" format=\"distant\" "
-        "            plugin=\"xxx\" location=\"127.0.0.1:8888\" />\n"
+        "            plugin=\"xxx\" location=\"127.0.0.1:8888\" "
+        "            asynchronous=\"true\" />\n"
         "   </outputs>\n"
         "   <observables>\n"
         "    <observable name=\"oo\" >\n"
@@ -369,6 +370,7 @@ BOOST_AUTO_TEST_CASE(experiment_measures_vpz)
         BOOST_REQUIRE(out.data() != (value::Value*)0);
         BOOST_REQUIRE_EQUAL(out.data()->isString(), true);
         BOOST_REQUIRE_EQUAL(value::toString(out.data()), "test");
+        BOOST_REQUIRE_EQUAL(out.asynchronous(), false);
     }
     BOOST_REQUIRE(outputs.outputlist().find("z") != outputs.outputlist().end());
     {
@@ -377,6 +379,7 @@ BOOST_AUTO_TEST_CASE(experiment_measures_vpz)
         BOOST_REQUIRE_EQUAL(out.format(), vpz::Output::DISTANT);
         BOOST_REQUIRE_EQUAL(out.plugin(), "xxx");
         BOOST_REQUIRE_EQUAL(out.location(), "127.0.0.1:8888");
+        BOOST_REQUIRE_EQUAL(out.asynchronous(), true);
     }
 
 
@@ -871,3 +871,60 @@ BOOST_AUTO_TEST_CASE(test_equal_views)
     delete vpz.project().model().model();
 }
 
+
+BOOST_AUTO_TEST_CASE(test_condition_copy_on_write)
+{
+    vpz::Condition cnd("cnd");
+    cnd.addValueToPort("x", value::Integer::create(1));
+    cnd.addValueToPort("y", value::Double::create(2.0));
+
+    vpz::Condition cpy(cnd);
+    const vpz::Condition& ccnd(cnd);
+    const vpz::Condition& ccpy(cpy);
+
+    BOOST_REQUIRE_EQUAL(&ccnd.getSetValues("x"), &ccpy.getSetValues("x"));
+    BOOST_REQUIRE_EQUAL(&ccnd.getSetValues("y"), &ccpy.getSetValues("y"));
+
+    cpy.setValueToPort("x", value::Integer(3));
+
+    BOOST_REQUIRE(&ccnd.getSetValues("x") != &ccpy.getSetValues("x"));
+    BOOST_REQUIRE_EQUAL(&ccnd.getSetValues("y"), &ccpy.getSetValues("y"));
+    BOOST_REQUIRE_EQUAL(value::toInteger(ccnd.firstValue("x")), 1);
+    BOOST_REQUIRE_EQUAL(value::toInteger(ccpy.firstValue("x")), 3);
+
+    cnd.deleteValueSet();
+
+    BOOST_REQUIRE_EQUAL(ccnd.getSetValues("y").size(), 0);
+    BOOST_REQUIRE_EQUAL(ccpy.getSetValues("y").size(), 1);
+    BOOST_REQUIRE_CLOSE(value::toDouble(ccpy.firstValue("y")), 2.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(test_condition_copy_reference)
+{
+    vpz::Condition cnd("cnd");
+    cnd.addValueToPort("x", value::Integer::create(1));
+
+    /*
+     * A reference obtained before a copy is shared with the copy: the
+     * copy is changed through this reference.
+     */
+    value::Set& before(cnd.getSetValues("x"));
+    vpz::Condition cpy(cnd);
+    const vpz::Condition& ccpy(cpy);
+
+    before.add(value::Integer::create(2));
+    BOOST_REQUIRE_EQUAL(ccpy.getSetValues("x").size(), 2);
+
+    /*
+     * The reference obtained again after the copy belongs to the
+     * Condition only, the previous one now refers to the copy.
+     */
+    value::Set& after(cnd.getSetValues("x"));
+    after.add(value::Integer::create(3));
+
+    BOOST_REQUIRE(&after != &before);
+    BOOST_REQUIRE_EQUAL(&before, &ccpy.getSetValues("x"));
+    BOOST_REQUIRE_EQUAL(after.size(), 3);
+    BOOST_REQUIRE_EQUAL(ccpy.getSetValues("x").size(), 2);
+    BOOST_REQUIRE_EQUAL(value::toInteger(ccpy.nValue("x", 1)), 2);
+}